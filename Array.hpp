@@ -1,5 +1,6 @@
 #pragma once
 #include <stddef.h>
+#include <memory.h>
 #include <type_traits>
 #include "Config.hpp"
 #include "SecureWiper.hpp"
@@ -202,8 +203,26 @@ namespace accel {
         // Re-interpret array with "const" qualifier as another C-style array with "const" qualifier
         //
         template<typename __NewCArrayType>
-        __NewCArrayType& AsCArrayOf() const ACCEL_NOEXCEPT {
-            return reinterpret_cast<__NewCArrayType&>(_Elements);
+        const __NewCArrayType& AsCArrayOf() const ACCEL_NOEXCEPT {
+            return reinterpret_cast<const __NewCArrayType&>(_Elements);
+        }
+
+        //
+        // Re-interpret array as another Array which is not larger
+        //
+        template<typename __NewType, size_t... __NewDimensions>
+        Array<__NewType, __NewDimensions...>& AsArrayOf() ACCEL_NOEXCEPT {
+            static_assert(Array<__NewType, __NewDimensions...>::SizeValue <= SizeValue, "AsArrayOf failure! The new Array is larger.");
+            return reinterpret_cast<Array<__NewType, __NewDimensions...>&>(_Elements);
+        }
+
+        //
+        // Re-interpret array with "const" qualifier as another Array with "const" qualifier which is not larger
+        //
+        template<typename __NewType, size_t... __NewDimensions>
+        const Array<__NewType, __NewDimensions...>& AsArrayOf() const ACCEL_NOEXCEPT {
+            static_assert(Array<__NewType, __NewDimensions...>::SizeValue <= SizeValue, "AsArrayOf failure! The new Array is larger.");
+            return reinterpret_cast<const Array<__NewType, __NewDimensions...>&>(_Elements);
         }
 
 //         //
@@ -2,6 +2,8 @@
 #include "Config.hpp"
 #include <stddef.h>
 #include <memory.h>
+#include <type_traits>
+#include <utility>
 #include "SecureWiper.hpp"
 #include "MemoryAccess.hpp"
 
@@ -25,17 +27,17 @@ namespace accel {
             return LengthValue;
         }
 
-        template<typename __Dummy = typename std::enable_if<__Length == 1>::type>
+        template<size_t __L = __Length, typename = typename std::enable_if<__L == 1>::type>
         operator __Type&() ACCEL_NOEXCEPT {
             return Unit[0];
         }
 
-        template<typename __Dummy = typename std::enable_if<__Length == 1>::type>
+        template<size_t __L = __Length, typename = typename std::enable_if<__L == 1>::type>
         operator const __Type&() const ACCEL_NOEXCEPT {
             return Unit[0];
         }
 
-        template<typename __Dummy = typename std::enable_if<__Length == 1>::type>
+        template<size_t __L = __Length, typename = typename std::enable_if<__L == 1>::type>
         Block<__Type, __Length, __AlignSize>& operator=(const __Type& Other) ACCEL_NOEXCEPT {
             Unit[0] = Other;
             return *this;
@@ -0,0 +1,222 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../../Intrinsic.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace accel::CipherTraits::Internal {
+
+    //
+    //  Byte-sliced vectors for bitsliced block ciphers. Eight 16-byte blocks are transposed into eight vectors,
+    //  so that bit k of byte p of vector i is bit i of byte p of block k. A byte permutation of the state is then
+    //  one PSHUFB per vector, and any S-box can be evaluated as a Boolean circuit on whole vectors, without a table.
+    //  The AVX2 policy keeps a second group of eight blocks in the upper 128-bit lane, i.e. 16 blocks at a time.
+    //
+    //  As in Hash/Internal/lanes.hpp, a kernel is written once against this interface and run through `Invoke`,
+    //  which is compiled with the policy's ACCEL_TARGET and flattens the kernel into itself.
+    //  So no `-mssse3` or `-mavx2` is needed; check RuntimeCpuFeatures() before picking a policy.
+    //
+
+    struct BitsliceVectorSSSE3 {
+        using VectorType = __m128i;
+        static constexpr size_t BlocksValue = 8;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("ssse3")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Run<BitsliceVectorSSSE3>(Args...);
+        }
+
+        //
+        //  x[k] = block k
+        //
+        ACCEL_TARGET("ssse3")
+        static void LoadBlocks(__m128i (&x)[8], const uint8_t* pbBlocks) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 8; ++k)
+                x[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * k));
+        }
+
+        ACCEL_TARGET("ssse3")
+        static void StoreBlocks(uint8_t* pbBlocks, const __m128i (&x)[8]) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 8; ++k)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * k), x[k]);
+        }
+
+        //
+        //  The same 16 bytes for every group of blocks, e.g. a bitsliced round key or a PSHUFB mask.
+        //
+        ACCEL_TARGET("ssse3")
+        static __m128i Broadcast(const uint8_t* pb16) ACCEL_NOEXCEPT {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb16));
+        }
+
+        ACCEL_TARGET("ssse3")
+        static __m128i Set1(uint8_t x) ACCEL_NOEXCEPT {
+            return _mm_set1_epi8(static_cast<char>(x));
+        }
+
+        ACCEL_TARGET("ssse3")
+        static __m128i Xor(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(a, b);
+        }
+
+        ACCEL_TARGET("ssse3")
+        static __m128i And(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_and_si128(a, b);
+        }
+
+        ACCEL_TARGET("ssse3")
+        static __m128i Or(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_or_si128(a, b);
+        }
+
+        ACCEL_TARGET("ssse3")
+        static __m128i Not(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(a, _mm_set1_epi32(-1));
+        }
+
+        //
+        //  Byte p of the result is byte Mask[p] of `a`, within every 16-byte group.
+        //
+        ACCEL_TARGET("ssse3")
+        static __m128i Shuffle(__m128i a, __m128i Mask) ACCEL_NOEXCEPT {
+            return _mm_shuffle_epi8(a, Mask);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("ssse3")
+        static __m128i ShiftLeft64(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_slli_epi64(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("ssse3")
+        static __m128i ShiftRight64(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_srli_epi64(a, __Shift);
+        }
+    };
+
+    struct BitsliceVectorAVX2 {
+        using VectorType = __m256i;
+        static constexpr size_t BlocksValue = 16;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("avx2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Run<BitsliceVectorAVX2>(Args...);
+        }
+
+        //
+        //  x[k] = block k in the lower lane, block k + 8 in the upper lane
+        //
+        ACCEL_TARGET("avx2")
+        static void LoadBlocks(__m256i (&x)[8], const uint8_t* pbBlocks) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 8; ++k) {
+                x[k] = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * k))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * (k + 8))),
+                    1
+                );
+            }
+        }
+
+        ACCEL_TARGET("avx2")
+        static void StoreBlocks(uint8_t* pbBlocks, const __m256i (&x)[8]) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 8; ++k) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * k), _mm256_castsi256_si128(x[k]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * (k + 8)), _mm256_extracti128_si256(x[k], 1));
+            }
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Broadcast(const uint8_t* pb16) ACCEL_NOEXCEPT {
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb16)));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Set1(uint8_t x) ACCEL_NOEXCEPT {
+            return _mm256_set1_epi8(static_cast<char>(x));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Xor(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i And(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_and_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Or(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Not(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, _mm256_set1_epi32(-1));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Shuffle(__m256i a, __m256i Mask) ACCEL_NOEXCEPT {
+            return _mm256_shuffle_epi8(a, Mask);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i ShiftLeft64(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_slli_epi64(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i ShiftRight64(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_srli_epi64(a, __Shift);
+        }
+    };
+
+    //
+    //  Exchange the bits of `a` selected by `Mask` << __Shift with the bits of `b` selected by `Mask`.
+    //
+    template<typename __VectorPolicy, int __Shift>
+    ACCEL_FORCEINLINE
+    void BitsliceSwapMove(typename __VectorPolicy::VectorType& a, typename __VectorPolicy::VectorType& b,
+                          typename __VectorPolicy::VectorType Mask) ACCEL_NOEXCEPT {
+        using V = __VectorPolicy;
+        auto t = V::And(V::Xor(V::template ShiftRight64<__Shift>(a), b), Mask);
+        b = V::Xor(b, t);
+        a = V::Xor(a, V::template ShiftLeft64<__Shift>(t));
+    }
+
+    //
+    //  8x8 bit transpose inside every byte position: on return, bit k of byte p of x[i] is what bit i of byte p of x[k] was.
+    //  The transpose is its own inverse.
+    //
+    template<typename __VectorPolicy>
+    ACCEL_FORCEINLINE
+    void BitsliceTranspose(typename __VectorPolicy::VectorType (&x)[8]) ACCEL_NOEXCEPT {
+        using V = __VectorPolicy;
+        auto m1 = V::Set1(0x55);
+        auto m2 = V::Set1(0x33);
+        auto m4 = V::Set1(0x0f);
+
+        BitsliceSwapMove<V, 1>(x[0], x[1], m1);
+        BitsliceSwapMove<V, 1>(x[2], x[3], m1);
+        BitsliceSwapMove<V, 1>(x[4], x[5], m1);
+        BitsliceSwapMove<V, 1>(x[6], x[7], m1);
+
+        BitsliceSwapMove<V, 2>(x[0], x[2], m2);
+        BitsliceSwapMove<V, 2>(x[1], x[3], m2);
+        BitsliceSwapMove<V, 2>(x[4], x[6], m2);
+        BitsliceSwapMove<V, 2>(x[5], x[7], m2);
+
+        BitsliceSwapMove<V, 4>(x[0], x[4], m4);
+        BitsliceSwapMove<V, 4>(x[1], x[5], m4);
+        BitsliceSwapMove<V, 4>(x[2], x[6], m4);
+        BitsliceSwapMove<V, 4>(x[3], x[7], m4);
+    }
+
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../../Intrinsic.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace accel::CipherTraits::Internal {
+
+    //
+    //  Byte-sliced vectors for byte-oriented ciphers, e.g. Camellia. 16 blocks of 16 bytes are transposed into
+    //  16 vectors, so that byte k of vector j is byte j of block k. A byte-wise formula for one block then runs on
+    //  all blocks at once, and an S-box that is affine-equivalent to the AES S-box costs one AESENCLAST per vector.
+    //  The AVX2 policy keeps blocks 0-15 in the lower 128-bit lane and blocks 16-31 in the upper one.
+    //
+    //  As in bitslice.hpp, kernels are run through `Invoke`, which carries the policy's ACCEL_TARGET.
+    //  Check RuntimeCpuFeatures() for AES-NI and SSSE3 (or AVX2) before picking a policy.
+    //
+
+    struct BytesliceVectorAESNI {
+        using VectorType = __m128i;
+        static constexpr size_t BlocksValue = 16;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("aes,ssse3")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Run<BytesliceVectorAESNI>(Args...);
+        }
+
+        //
+        //  Four rounds of pairing x[i] with x[i + 8] rotate the 8-bit (row, column) index by 4 bits,
+        //  i.e. transpose the 16x16 byte matrix. So Transpose is its own inverse.
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static void Transpose(__m128i (&x)[16]) ACCEL_NOEXCEPT {
+            for (int Round = 0; Round < 4; ++Round) {
+                __m128i t[16];
+                for (size_t i = 0; i < 8; ++i) {
+                    t[2 * i] = _mm_unpacklo_epi8(x[i], x[i + 8]);
+                    t[2 * i + 1] = _mm_unpackhi_epi8(x[i], x[i + 8]);
+                }
+                for (size_t i = 0; i < 16; ++i)
+                    x[i] = t[i];
+            }
+        }
+
+        //
+        //  x[j] = byte j of blocks 0-15
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static void LoadBlocks(__m128i (&x)[16], const uint8_t* pbBlocks) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 16; ++k)
+                x[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * k));
+            Transpose(x);
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        static void StoreBlocks(uint8_t* pbBlocks, __m128i (&x)[16]) ACCEL_NOEXCEPT {
+            Transpose(x);
+            for (size_t k = 0; k < 16; ++k)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * k), x[k]);
+        }
+
+        //
+        //  The same 16 bytes for every group of blocks, e.g. a PSHUFB table.
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i Broadcast(const uint8_t* pb16) ACCEL_NOEXCEPT {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb16));
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i Set1(uint8_t x) ACCEL_NOEXCEPT {
+            return _mm_set1_epi8(static_cast<char>(x));
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i Xor(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(a, b);
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i And(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_and_si128(a, b);
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i Or(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_or_si128(a, b);
+        }
+
+        //
+        //  Every byte shifted left by one bit
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i ShiftLeft1(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_add_epi8(a, a);
+        }
+
+        //
+        //  Every byte shifted right by seven bits, i.e. the top bit of each byte
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i ShiftRight7(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_and_si128(_mm_srli_epi16(a, 7), _mm_set1_epi8(0x01));
+        }
+
+        //
+        //  y = Table[x] for an affine map over GF(2), given as the images of the low nibble and the high nibble
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i AffineMap(__m128i a, const uint8_t (&Table)[2][16]) ACCEL_NOEXCEPT {
+            __m128i Mask = _mm_set1_epi8(0x0f);
+            __m128i Low = _mm_shuffle_epi8(Broadcast(Table[0]), _mm_and_si128(a, Mask));
+            __m128i High = _mm_shuffle_epi8(Broadcast(Table[1]), _mm_and_si128(_mm_srli_epi16(a, 4), Mask));
+            return _mm_xor_si128(Low, High);
+        }
+
+        //
+        //  The AES S-box on every byte. InverseShiftRows undoes the ShiftRows of AESENCLAST.
+        //
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i SubBytes(__m128i a, const uint8_t (&InverseShiftRows)[16]) ACCEL_NOEXCEPT {
+            return _mm_aesenclast_si128(_mm_shuffle_epi8(a, Broadcast(InverseShiftRows)), _mm_setzero_si128());
+        }
+    };
+
+    struct BytesliceVectorAVX2 {
+        using VectorType = __m256i;
+        static constexpr size_t BlocksValue = 32;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("aes,avx2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Run<BytesliceVectorAVX2>(Args...);
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static void Transpose(__m256i (&x)[16]) ACCEL_NOEXCEPT {
+            for (int Round = 0; Round < 4; ++Round) {
+                __m256i t[16];
+                for (size_t i = 0; i < 8; ++i) {
+                    t[2 * i] = _mm256_unpacklo_epi8(x[i], x[i + 8]);
+                    t[2 * i + 1] = _mm256_unpackhi_epi8(x[i], x[i + 8]);
+                }
+                for (size_t i = 0; i < 16; ++i)
+                    x[i] = t[i];
+            }
+        }
+
+        //
+        //  x[j] = byte j of blocks 0-15 in the lower lane, byte j of blocks 16-31 in the upper lane
+        //
+        ACCEL_TARGET("aes,avx2")
+        static void LoadBlocks(__m256i (&x)[16], const uint8_t* pbBlocks) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 16; ++k) {
+                x[k] = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * k))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * (k + 16))),
+                    1
+                );
+            }
+            Transpose(x);
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static void StoreBlocks(uint8_t* pbBlocks, __m256i (&x)[16]) ACCEL_NOEXCEPT {
+            Transpose(x);
+            for (size_t k = 0; k < 16; ++k) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * k), _mm256_castsi256_si128(x[k]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * (k + 16)), _mm256_extracti128_si256(x[k], 1));
+            }
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i Broadcast(const uint8_t* pb16) ACCEL_NOEXCEPT {
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb16)));
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i Set1(uint8_t x) ACCEL_NOEXCEPT {
+            return _mm256_set1_epi8(static_cast<char>(x));
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i Xor(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, b);
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i And(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_and_si256(a, b);
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i Or(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(a, b);
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i ShiftLeft1(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_add_epi8(a, a);
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i ShiftRight7(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_and_si256(_mm256_srli_epi16(a, 7), _mm256_set1_epi8(0x01));
+        }
+
+        ACCEL_TARGET("aes,avx2")
+        static __m256i AffineMap(__m256i a, const uint8_t (&Table)[2][16]) ACCEL_NOEXCEPT {
+            __m256i Mask = _mm256_set1_epi8(0x0f);
+            __m256i Low = _mm256_shuffle_epi8(Broadcast(Table[0]), _mm256_and_si256(a, Mask));
+            __m256i High = _mm256_shuffle_epi8(Broadcast(Table[1]), _mm256_and_si256(_mm256_srli_epi16(a, 4), Mask));
+            return _mm256_xor_si256(Low, High);
+        }
+
+        //
+        //  Without VAES, AESENCLAST runs on each 128-bit lane separately.
+        //
+        ACCEL_TARGET("aes,avx2")
+        static __m256i SubBytes(__m256i a, const uint8_t (&InverseShiftRows)[16]) ACCEL_NOEXCEPT {
+            a = _mm256_shuffle_epi8(a, Broadcast(InverseShiftRows));
+            __m128i Low = _mm_aesenclast_si128(_mm256_castsi256_si128(a), _mm_setzero_si128());
+            __m128i High = _mm_aesenclast_si128(_mm256_extracti128_si256(a, 1), _mm_setzero_si128());
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(Low), High, 1);
+        }
+    };
+
+}
@@ -236,6 +236,51 @@ PrintU32Array(SBox4404, 'SBox4404')
             0x28280028, 0x7b7b007b, 0xc9c900c9, 0xc1c100c1, 0xe3e300e3, 0xf4f400f4, 0xc7c700c7, 0x9e9e009e
         };
 
+        /* s1 is affine-equivalent to the AES S-box S:
+
+               s1(x) = Post(S(Pre(x)))
+               Pre(x) = L(transform_f(0xc5 ^ x))
+               Post(y) = transform_h(L^-1(A^-1(y ^ 0x63))) ^ 0x6e
+
+           where L maps the representation of transform_g onto the AES field GF(2^8) / (x^8 + x^4 + x^3 + x + 1)
+           (via a root of x^8 + x^6 + x^5 + x^3 + 1 there), and A is the linear part of the AES affine transform.
+           Then s2 = rotl1 . Post . S . Pre, s3 = rotr1 . Post . S . Pre and s4 = Post . S . Pre . rotl1.
+
+           Each affine map T is stored as { T(0x0), ..., T(0xf) } and { T(0x00) ^ T(0x00), T(0x10) ^ T(0x00), ..., T(0xf0) ^ T(0x00) },
+           so that T(x) is two PSHUFB lookups, on the low and the high nibble of x.
+         */
+        alignas(16) static constexpr uint8_t AffinePreS1[2][16] = {
+            { 0x0b, 0xb3, 0x08, 0xb0, 0xd2, 0x6a, 0xd1, 0x69, 0x1c, 0xa4, 0x1f, 0xa7, 0xc5, 0x7d, 0xc6, 0x7e },
+            { 0x00, 0x0d, 0x59, 0x54, 0x84, 0x89, 0xdd, 0xd0, 0xee, 0xe3, 0xb7, 0xba, 0x6a, 0x67, 0x33, 0x3e }
+        };
+
+        alignas(16) static constexpr uint8_t AffinePreS4[2][16] = {
+            { 0x0b, 0x08, 0xd2, 0xd1, 0x1c, 0x1f, 0xc5, 0xc6, 0x06, 0x05, 0xdf, 0xdc, 0x11, 0x12, 0xc8, 0xcb },
+            { 0x00, 0x59, 0x84, 0xdd, 0xee, 0xb7, 0x6a, 0x33, 0xb8, 0xe1, 0x3c, 0x65, 0x56, 0x0f, 0xd2, 0x8b }
+        };
+
+        alignas(16) static constexpr uint8_t AffinePostS1[2][16] = {
+            { 0x86, 0x9b, 0x27, 0x3a, 0xce, 0xd3, 0x6f, 0x72, 0x83, 0x9e, 0x22, 0x3f, 0xcb, 0xd6, 0x6a, 0x77 },
+            { 0x00, 0xe5, 0x4f, 0xaa, 0x1b, 0xfe, 0x54, 0xb1, 0xca, 0x2f, 0x85, 0x60, 0xd1, 0x34, 0x9e, 0x7b }
+        };
+
+        alignas(16) static constexpr uint8_t AffinePostS2[2][16] = {
+            { 0x0d, 0x37, 0x4e, 0x74, 0x9d, 0xa7, 0xde, 0xe4, 0x07, 0x3d, 0x44, 0x7e, 0x97, 0xad, 0xd4, 0xee },
+            { 0x00, 0xcb, 0x9e, 0x55, 0x36, 0xfd, 0xa8, 0x63, 0x95, 0x5e, 0x0b, 0xc0, 0xa3, 0x68, 0x3d, 0xf6 }
+        };
+
+        alignas(16) static constexpr uint8_t AffinePostS3[2][16] = {
+            { 0x43, 0xcd, 0x93, 0x1d, 0x67, 0xe9, 0xb7, 0x39, 0xc1, 0x4f, 0x11, 0x9f, 0xe5, 0x6b, 0x35, 0xbb },
+            { 0x00, 0xf2, 0xa7, 0x55, 0x8d, 0x7f, 0x2a, 0xd8, 0x65, 0x97, 0xc2, 0x30, 0xe8, 0x1a, 0x4f, 0xbd }
+        };
+
+        //
+        //  Undoes the ShiftRows of AESENCLAST
+        //
+        alignas(16) static constexpr uint8_t InverseShiftRows[16] = {
+            0x00, 0x0d, 0x0a, 0x07, 0x04, 0x01, 0x0e, 0x0b, 0x08, 0x05, 0x02, 0x0f, 0x0c, 0x09, 0x06, 0x03
+        };
+
         static constexpr uint64_t Sigma[] = {
             0xA09E667F3BCC908B,
             0xB67AE8584CAA73B2,
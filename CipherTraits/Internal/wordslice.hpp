@@ -0,0 +1,217 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../../Intrinsic.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace accel::CipherTraits::Internal {
+
+    //
+    //  Word-sliced vectors for ciphers whose round function works on four 32-bit words, e.g. Serpent.
+    //  BlocksValue 16-byte blocks are loaded and transposed into four vectors, so that 32-bit lane k of vector j
+    //  is word j of block k. A formula written for one block's four words then runs on all blocks at once.
+    //  The AVX2 policy keeps blocks 0-3 in the lower 128-bit lane and blocks 4-7 in the upper one.
+    //
+    //  As in bitslice.hpp, kernels are run through `Invoke`, which carries the policy's ACCEL_TARGET.
+    //  WordsliceWord wraps one vector with the usual operators, so that scalar formulas can be reused as they are.
+    //
+
+    struct WordsliceVectorSSE2 {
+        using VectorType = __m128i;
+        static constexpr size_t BlocksValue = 4;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("sse2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Run<WordsliceVectorSSE2>(Args...);
+        }
+
+        ACCEL_TARGET("sse2")
+        static void Transpose(__m128i (&x)[4]) ACCEL_NOEXCEPT {
+            __m128i t0 = _mm_unpacklo_epi32(x[0], x[1]);
+            __m128i t1 = _mm_unpacklo_epi32(x[2], x[3]);
+            __m128i t2 = _mm_unpackhi_epi32(x[0], x[1]);
+            __m128i t3 = _mm_unpackhi_epi32(x[2], x[3]);
+            x[0] = _mm_unpacklo_epi64(t0, t1);
+            x[1] = _mm_unpackhi_epi64(t0, t1);
+            x[2] = _mm_unpacklo_epi64(t2, t3);
+            x[3] = _mm_unpackhi_epi64(t2, t3);
+        }
+
+        //
+        //  x[j] = word j of blocks 0-3
+        //
+        ACCEL_TARGET("sse2")
+        static void LoadBlocks(__m128i (&x)[4], const uint8_t* pbBlocks) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 4; ++k)
+                x[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * k));
+            Transpose(x);
+        }
+
+        ACCEL_TARGET("sse2")
+        static void StoreBlocks(uint8_t* pbBlocks, __m128i (&x)[4]) ACCEL_NOEXCEPT {
+            Transpose(x);
+            for (size_t k = 0; k < 4; ++k)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * k), x[k]);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Set1(uint32_t x) ACCEL_NOEXCEPT {
+            return _mm_set1_epi32(static_cast<int>(x));
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Xor(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i And(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_and_si128(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Or(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_or_si128(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Not(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(a, _mm_set1_epi32(-1));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("sse2")
+        static __m128i ShiftLeft32(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_slli_epi32(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("sse2")
+        static __m128i RotateLeft32(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_or_si128(_mm_slli_epi32(a, __Shift), _mm_srli_epi32(a, 32 - __Shift));
+        }
+    };
+
+    struct WordsliceVectorAVX2 {
+        using VectorType = __m256i;
+        static constexpr size_t BlocksValue = 8;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("avx2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Run<WordsliceVectorAVX2>(Args...);
+        }
+
+        ACCEL_TARGET("avx2")
+        static void Transpose(__m256i (&x)[4]) ACCEL_NOEXCEPT {
+            __m256i t0 = _mm256_unpacklo_epi32(x[0], x[1]);
+            __m256i t1 = _mm256_unpacklo_epi32(x[2], x[3]);
+            __m256i t2 = _mm256_unpackhi_epi32(x[0], x[1]);
+            __m256i t3 = _mm256_unpackhi_epi32(x[2], x[3]);
+            x[0] = _mm256_unpacklo_epi64(t0, t1);
+            x[1] = _mm256_unpackhi_epi64(t0, t1);
+            x[2] = _mm256_unpacklo_epi64(t2, t3);
+            x[3] = _mm256_unpackhi_epi64(t2, t3);
+        }
+
+        //
+        //  x[j] = word j of blocks 0-3 in the lower lane, word j of blocks 4-7 in the upper lane
+        //
+        ACCEL_TARGET("avx2")
+        static void LoadBlocks(__m256i (&x)[4], const uint8_t* pbBlocks) ACCEL_NOEXCEPT {
+            for (size_t k = 0; k < 4; ++k) {
+                x[k] = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * k))),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(pbBlocks + 16 * (k + 4))),
+                    1
+                );
+            }
+            Transpose(x);
+        }
+
+        ACCEL_TARGET("avx2")
+        static void StoreBlocks(uint8_t* pbBlocks, __m256i (&x)[4]) ACCEL_NOEXCEPT {
+            Transpose(x);
+            for (size_t k = 0; k < 4; ++k) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * k), _mm256_castsi256_si128(x[k]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pbBlocks + 16 * (k + 4)), _mm256_extracti128_si256(x[k], 1));
+            }
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Set1(uint32_t x) ACCEL_NOEXCEPT {
+            return _mm256_set1_epi32(static_cast<int>(x));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Xor(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i And(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_and_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Or(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Not(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, _mm256_set1_epi32(-1));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i ShiftLeft32(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_slli_epi32(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i RotateLeft32(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(_mm256_slli_epi32(a, __Shift), _mm256_srli_epi32(a, 32 - __Shift));
+        }
+    };
+
+    template<typename __VectorPolicy>
+    struct WordsliceWord {
+        using V = __VectorPolicy;
+
+        typename V::VectorType Value;
+
+        ACCEL_FORCEINLINE
+        WordsliceWord& operator^=(const WordsliceWord& Other) ACCEL_NOEXCEPT {
+            Value = V::Xor(Value, Other.Value);
+            return *this;
+        }
+
+        ACCEL_FORCEINLINE
+        WordsliceWord& operator&=(const WordsliceWord& Other) ACCEL_NOEXCEPT {
+            Value = V::And(Value, Other.Value);
+            return *this;
+        }
+
+        ACCEL_FORCEINLINE
+        WordsliceWord& operator|=(const WordsliceWord& Other) ACCEL_NOEXCEPT {
+            Value = V::Or(Value, Other.Value);
+            return *this;
+        }
+
+        ACCEL_FORCEINLINE
+        WordsliceWord operator^(const WordsliceWord& Other) const ACCEL_NOEXCEPT {
+            return WordsliceWord{ V::Xor(Value, Other.Value) };
+        }
+
+        ACCEL_FORCEINLINE
+        WordsliceWord operator~() const ACCEL_NOEXCEPT {
+            return WordsliceWord{ V::Not(Value) };
+        }
+    };
+
+}
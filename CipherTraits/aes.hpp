@@ -1,10 +1,147 @@
 #pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
 #include "rijndael.hpp"
+#include "aes_aesni.hpp"
+#include "aes_vaes.hpp"
+#include "aes_bitsliced.hpp"
+#include <type_traits>
+#include <variant>
 
 namespace accel::CipherTraits {
 
+    //
+    //  AES with the backend chosen at runtime, from what the host actually supports:
+    //      VAES on zmm  >  VAES on ymm  >  AES-NI  >  bitsliced on SSSE3  >  RIJNDAEL_ALG<__KeyBits, 128>
+    //  The choice is made once, when the object is constructed, and bound to a table of function pointers,
+    //  so a block operation costs one indirect call rather than a visit of the backend variant.
+    //  Every backend except the last is constant-time; RIJNDAEL_ALG looks up tables indexed by key and data.
+    //
     template<size_t __KeyBits>
-    using AES_ALG = RIJNDAEL_ALG<__KeyBits, 128>;
+    class AES_ALG {
+        static_assert(__KeyBits == 128 || __KeyBits == 192 || __KeyBits == 256,
+                      "AES_ALG failure! Unsupported __KeyBits.");
+    public:
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t KeySizeValue = __KeyBits / 8;
+    private:
+        using PortableAlgType = RIJNDAEL_ALG<__KeyBits, 128>;
+        using _BlockRoutine = size_t(*)(AES_ALG& Self, void* pbBlock);
+        using _BlocksRoutine = size_t(*)(AES_ALG& Self, void* pbBlocks, size_t BlockCount);
+
+        std::variant<PortableAlgType,
+                     AES_AESNI_ALG<__KeyBits>,
+                     AES_BITSLICED_ALG<__KeyBits>,
+                     AES_VAES_ALG<__KeyBits, 256>,
+                     AES_VAES_ALG<__KeyBits, 512>> _Backend;
+
+        _BlockRoutine _EncryptBlockRoutine;
+        _BlockRoutine _DecryptBlockRoutine;
+        _BlocksRoutine _EncryptBlocksRoutine;
+        _BlocksRoutine _DecryptBlocksRoutine;
+
+        //
+        //  The routines take the object rather than the backend's address, so copies stay bound to their own backend.
+        //
+        template<typename __BackendType>
+        static __BackendType& _BackendOf(AES_ALG& Self) ACCEL_NOEXCEPT {
+            return *std::get_if<__BackendType>(&Self._Backend);
+        }
+
+        template<typename __BackendType>
+        static size_t _EncryptBlockOf(AES_ALG& Self, void* pbPlaintext) ACCEL_NOEXCEPT {
+            return _BackendOf<__BackendType>(Self).EncryptBlock(pbPlaintext);
+        }
+
+        template<typename __BackendType>
+        static size_t _DecryptBlockOf(AES_ALG& Self, void* pbCiphertext) ACCEL_NOEXCEPT {
+            return _BackendOf<__BackendType>(Self).DecryptBlock(pbCiphertext);
+        }
+
+        template<typename __BackendType>
+        static size_t _EncryptBlocksOf(AES_ALG& Self, void* pbPlaintext, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (std::is_same<__BackendType, PortableAlgType>::value) {
+                auto pbBlocks = reinterpret_cast<uint8_t*>(pbPlaintext);
+                for (size_t i = 0; i < BlockCount; ++i)
+                    _BackendOf<__BackendType>(Self).EncryptBlock(pbBlocks + i * BlockSizeValue);
+                return BlockCount * BlockSizeValue;
+            } else {
+                return _BackendOf<__BackendType>(Self).EncryptBlocks(pbPlaintext, BlockCount);
+            }
+        }
+
+        template<typename __BackendType>
+        static size_t _DecryptBlocksOf(AES_ALG& Self, void* pbCiphertext, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (std::is_same<__BackendType, PortableAlgType>::value) {
+                auto pbBlocks = reinterpret_cast<uint8_t*>(pbCiphertext);
+                for (size_t i = 0; i < BlockCount; ++i)
+                    _BackendOf<__BackendType>(Self).DecryptBlock(pbBlocks + i * BlockSizeValue);
+                return BlockCount * BlockSizeValue;
+            } else {
+                return _BackendOf<__BackendType>(Self).DecryptBlocks(pbCiphertext, BlockCount);
+            }
+        }
+
+        template<typename __BackendType>
+        void _Bind() ACCEL_NOEXCEPT {
+            _Backend.template emplace<__BackendType>();
+            _EncryptBlockRoutine = &_EncryptBlockOf<__BackendType>;
+            _DecryptBlockRoutine = &_DecryptBlockOf<__BackendType>;
+            _EncryptBlocksRoutine = &_EncryptBlocksOf<__BackendType>;
+            _DecryptBlocksRoutine = &_DecryptBlocksOf<__BackendType>;
+        }
+
+    public:
+
+        AES_ALG() ACCEL_NOEXCEPT {
+            const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+            if (Features.AESNI && Features.VAES && Features.AVX512F) {
+                _Bind<AES_VAES_ALG<__KeyBits, 512>>();
+            } else if (Features.AESNI && Features.VAES && Features.AVX2) {
+                _Bind<AES_VAES_ALG<__KeyBits, 256>>();
+            } else if (Features.AESNI) {
+                _Bind<AES_AESNI_ALG<__KeyBits>>();
+            } else if (Features.SSSE3) {
+                _Bind<AES_BITSLICED_ALG<__KeyBits>>();
+            } else {
+                _Bind<PortableAlgType>();
+            }
+        }
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t KeySize() const ACCEL_NOEXCEPT {
+            return KeySizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            return std::visit([pbUserKey, cbUserKey](auto& Alg) { return Alg.SetKey(pbUserKey, cbUserKey); }, _Backend);
+        }
+
+        size_t EncryptBlock(void* pbPlaintext) ACCEL_NOEXCEPT {
+            return _EncryptBlockRoutine(*this, pbPlaintext);
+        }
+
+        size_t DecryptBlock(void* pbCiphertext) ACCEL_NOEXCEPT {
+            return _DecryptBlockRoutine(*this, pbCiphertext);
+        }
+
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) ACCEL_NOEXCEPT {
+            return _EncryptBlocksRoutine(*this, pbPlaintext, BlockCount);
+        }
+
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) ACCEL_NOEXCEPT {
+            return _DecryptBlocksRoutine(*this, pbCiphertext, BlockCount);
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            std::visit([](auto& Alg) { Alg.ClearKey(); }, _Backend);
+        }
+    };
 
 }
 
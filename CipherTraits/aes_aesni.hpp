@@ -3,11 +3,15 @@
 #include "../Array.hpp"
 #include "../Block.hpp"
 #include "../Intrinsic.hpp"
-
-#if ACCEL_AESNI_AVAILABLE
+#include <utility>
 
 namespace accel::CipherTraits {
 
+    //
+    //  Every member that touches AES-NI is compiled with ACCEL_TARGET("aes"), so this header no longer
+    //  requires `-maes`. It is the caller's duty to make sure the host supports AES-NI,
+    //  e.g. by checking RuntimeCpuFeatures().AESNI or by going through AES_ALG.
+    //
     template<size_t __KeyBits>
     class AES_AESNI_ALG {
         static_assert(__KeyBits == 128 || __KeyBits == 192 || __KeyBits == 256, 
@@ -30,11 +34,18 @@ namespace accel::CipherTraits {
         Array<BlockType, _Nr + 1> _Key;
         Array<BlockType, _Nr + 1> _InvKey;
 
+        //
+        //  Wide backends reuse the key schedule computed here.
+        //
+        template<size_t, size_t>
+        friend class AES_VAES_ALG;
+
         //
         //  Calculate `_InvKey`, which will be used in decryption, based on `_Key`.
         //  This function is for internal use only.
         //
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _InverseKeyExpansion() ACCEL_NOEXCEPT {
             _InvKey[0] = _Key[_Nr];
             for (size_t i = 1; i < _Nr; ++i)
@@ -48,6 +59,7 @@ namespace accel::CipherTraits {
         //
         template<size_t __Index, int __Rcon>
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion128Loop(__m128i& assist_key, __m128i& buffer) ACCEL_NOEXCEPT {
             if constexpr (__Index == 0) {
                 _Key[0] = buffer;
@@ -66,6 +78,7 @@ namespace accel::CipherTraits {
 
         template<size_t... __Indexes>
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion128Loops(__m128i& assist_key, __m128i& buffer, std::index_sequence<__Indexes...>) ACCEL_NOEXCEPT {
             (_KeyExpansion128Loop<__Indexes, _Rcon[__Indexes]>(assist_key, buffer), ...);
         }
@@ -76,11 +89,12 @@ namespace accel::CipherTraits {
         //
         template<size_t __Index, int __Rcon>
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion192Loop(__m128i& assist_key, __m128i& buffer_l, __m128i& buffer_h) ACCEL_NOEXCEPT {
             if constexpr (__Index == 0) {
                 _Key[0] = buffer_l;
             } else if constexpr (__Index == 1) {
-                _mm_storel_epi64(&_Key[1], buffer_h);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&_Key[1]), buffer_h);
             } else if constexpr (__Index % 2 == 0 && 2 <= __Index && __Index < (_Nr / 3) * 4 + 1) {
                 assist_key = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(buffer_h, __Rcon), _MM_SHUFFLE(1, 1, 1, 1));
                 buffer_l = _mm_xor_si128(buffer_l, _mm_slli_si128(buffer_l, 4));
@@ -93,7 +107,7 @@ namespace accel::CipherTraits {
                 buffer_h = _mm_xor_si128(buffer_h, _mm_shuffle_epi32(buffer_l, _MM_SHUFFLE(3, 3, 3, 3)));
                 buffer_l = _mm_xor_si128(buffer_l, assist_key);
                 buffer_h = _mm_xor_si128(buffer_h, assist_key);
-                _mm_storel_epi64(reinterpret_cast<__m128i*>(_Key.template AsArrayOf<uint64_t[2 * (_Nr + 1)]>() + (__Index / 2) * 3 + 2),
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(_Key.template AsCArrayOf<uint64_t[2 * (_Nr + 1)]>() + (__Index / 2) * 3 + 2),
                                  buffer_h);
             } else {
                 static_assert(__Index < (_Nr / 3) * 4 + 1,
@@ -104,6 +118,7 @@ namespace accel::CipherTraits {
 
         template<size_t... __Indexes>
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion192Loops(__m128i& assist_key, __m128i& buffer_l, __m128i& buffer_h, std::index_sequence<__Indexes...>) ACCEL_NOEXCEPT {
             (_KeyExpansion192Loop<__Indexes, _Rcon[__Indexes / 2]>(assist_key, buffer_l, buffer_h), ...);
         }
@@ -114,6 +129,7 @@ namespace accel::CipherTraits {
         //
         template<size_t __Index, int __Rcon>
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion256Loop(__m128i& assist_key, __m128i& buffer_l, __m128i& buffer_h) ACCEL_NOEXCEPT {
             if constexpr (__Index == 0) {
                 _Key[0] = buffer_l;
@@ -140,11 +156,13 @@ namespace accel::CipherTraits {
 
         template<size_t... __Indexes>
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion256Loops(__m128i& assist_key, __m128i& buffer_l, __m128i& buffer_h, std::index_sequence<__Indexes...>) ACCEL_NOEXCEPT {
             (_KeyExpansion256Loop<__Indexes, _Rcon[__Indexes / 2]>(assist_key, buffer_l, buffer_h), ...);
         }
 
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _KeyExpansion(const void* pbUserKey) ACCEL_NOEXCEPT {
             if constexpr (__KeyBits == 128) {
                 __m128i assist_key;
@@ -176,6 +194,7 @@ namespace accel::CipherTraits {
         }
 
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _EncryptProcess(BlockType& RefBlock) ACCEL_NOEXCEPT {
             RefBlock = _mm_xor_si128(RefBlock, _Key[0]);
             for (size_t i = 1; i < _Nr; ++i)
@@ -184,6 +203,7 @@ namespace accel::CipherTraits {
         }
 
         ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
         void _DecryptProcess(BlockType& RefBlock) ACCEL_NOEXCEPT {
             RefBlock = _mm_xor_si128(RefBlock, _InvKey[0]);
             for (size_t i = 1; i < _Nr; ++i)
@@ -191,6 +211,41 @@ namespace accel::CipherTraits {
             RefBlock = _mm_aesdeclast_si128(RefBlock, _InvKey[_Nr]);
         }
 
+        //
+        //  AESENC/AESDEC have a latency of several cycles but a throughput of one per cycle.
+        //  So we push every round key through all lanes before moving on to the next round key.
+        //  This function is for internal use only.
+        //
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
+        void _EncryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            __m128i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbBlocks, BlockSizeValue, __LaneIndexes), _Key[0])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m128i RoundKey = _Key[i];
+                ((Lanes[__LaneIndexes] = _mm_aesenc_si128(Lanes[__LaneIndexes], RoundKey)), ...);
+            }
+            ((Lanes[__LaneIndexes] = _mm_aesenclast_si128(Lanes[__LaneIndexes], _Key[_Nr])), ...);
+            (MemoryWriteAs<__m128i>(pbBlocks, BlockSizeValue, __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
+        void _DecryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            __m128i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbBlocks, BlockSizeValue, __LaneIndexes), _InvKey[0])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m128i RoundKey = _InvKey[i];
+                ((Lanes[__LaneIndexes] = _mm_aesdec_si128(Lanes[__LaneIndexes], RoundKey)), ...);
+            }
+            ((Lanes[__LaneIndexes] = _mm_aesdeclast_si128(Lanes[__LaneIndexes], _InvKey[_Nr])), ...);
+            (MemoryWriteAs<__m128i>(pbBlocks, BlockSizeValue, __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
     public:
 
         constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
@@ -202,6 +257,7 @@ namespace accel::CipherTraits {
         }
 
         ACCEL_NODISCARD
+        ACCEL_TARGET("aes")
         bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
             if (cbUserKey != KeySizeValue) {
                 return false;
@@ -212,6 +268,7 @@ namespace accel::CipherTraits {
             }
         }
 
+        ACCEL_TARGET("aes")
         size_t EncryptBlock(void* pbPlaintext) ACCEL_NOEXCEPT {
             BlockType Text;
 
@@ -222,6 +279,7 @@ namespace accel::CipherTraits {
             return BlockSizeValue;
         }
 
+        ACCEL_TARGET("aes")
         size_t DecryptBlock(void* pbCiphertext) ACCEL_NOEXCEPT {
             BlockType Text;
 
@@ -232,11 +290,70 @@ namespace accel::CipherTraits {
             return BlockSizeValue;
         }
 
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion.
+        //  8 blocks are kept in flight at a time; the tail is finished by a 4-block pass and then block by block.
+        //
+        ACCEL_TARGET("aes")
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbPlaintext);
+            size_t i = 0;
+
+            for (; i + 8 <= BlockCount; i += 8)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<8>{});
+
+            if (i + 4 <= BlockCount) {
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<4>{});
+                i += 4;
+            }
+
+            for (; i < BlockCount; ++i)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion.
+        //
+        ACCEL_TARGET("aes")
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbCiphertext);
+            size_t i = 0;
+
+            for (; i + 8 <= BlockCount; i += 8)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<8>{});
+
+            if (i + 4 <= BlockCount) {
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<4>{});
+                i += 4;
+            }
+
+            for (; i < BlockCount; ++i)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            return BlockCount * BlockSizeValue;
+        }
+
         void ClearKey() ACCEL_NOEXCEPT {
             _Key.SecureZero();
             _InvKey.SecureZero();
         }
 
+        //
+        //  The RoundsValue + 1 round keys, for a mode that interleaves its own work with the AES rounds.
+        //  DecryptionRoundKey(i) is the key of round i of the equivalent inverse cipher, for AESDEC.
+        //
+        static constexpr size_t RoundsValue = _Nr;
+
+        __m128i EncryptionRoundKey(size_t i) const ACCEL_NOEXCEPT {
+            return _Key[i];
+        }
+
+        __m128i DecryptionRoundKey(size_t i) const ACCEL_NOEXCEPT {
+            return _InvKey[i];
+        }
+
         ~AES_AESNI_ALG() ACCEL_NOEXCEPT {
             _Key.SecureZero();
             _InvKey.SecureZero();
@@ -245,7 +362,3 @@ namespace accel::CipherTraits {
 
 }
 
-#else
-#error "aes_aesni.hpp failure! AES feature is not enabled."
-#endif
-
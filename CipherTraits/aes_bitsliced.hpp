@@ -0,0 +1,533 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../CpuFeatures.hpp"
+#include "../Intrinsic.hpp"
+#include "../SecureWiper.hpp"
+#include "Internal/bitslice.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+
+namespace accel::CipherTraits {
+
+    //
+    //  Constant-time AES for hosts without AES-NI, bitsliced after Käsper and Schwabe (CHES 2009).
+    //  Blocks are processed 8 at a time in SSSE3 registers, or 16 at a time with AVX2 (see Internal/bitslice.hpp).
+    //  SubBytes is the Boyar-Peralta circuit of 32 ANDs and 83 XORs, so neither the data nor the key
+    //  ever index a table, and the timing and memory trace do not depend on them. The key schedule
+    //  runs the same circuit on 32-bit words.
+    //
+    //  EncryptBlocks/DecryptBlocks are the fast path (ECB, CTR, XTS). A lone block, or a tail shorter
+    //  than a full group, costs as much as a whole group.
+    //
+    //  The members are compiled with ACCEL_TARGET(...), so no `-mssse3` is needed;
+    //  check RuntimeCpuFeatures().SSSE3 before use, or go through AES_ALG.
+    //
+    template<size_t __KeyBits>
+    class AES_BITSLICED_ALG {
+        static_assert(__KeyBits == 128 || __KeyBits == 192 || __KeyBits == 256,
+                      "AES_BITSLICED_ALG failure! Unsupported __KeyBits.");
+    public:
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t KeySizeValue = __KeyBits / 8;
+    private:
+        static constexpr size_t _Nb = 4;
+        static constexpr size_t _Nk = __KeyBits / 32;
+        static constexpr size_t _Nr = (_Nb > _Nk ? _Nb : _Nk) + 6;
+
+        //
+        //  PSHUFB masks on the column-major state, byte 4 * c + r holding row r of column c.
+        //
+        static constexpr uint8_t _ShiftRowsMask[16] = {
+            0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11
+        };
+
+        static constexpr uint8_t _InverseShiftRowsMask[16] = {
+            0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3
+        };
+
+        //
+        //  Row r of a column takes row r + 1 (resp. r + 2) of the same column.
+        //
+        static constexpr uint8_t _RotateRows1Mask[16] = {
+            1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12
+        };
+
+        static constexpr uint8_t _RotateRows2Mask[16] = {
+            2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13
+        };
+
+        //
+        //  _KeySlices[r][i] is round key r with bit i of each byte spread over the whole byte (0x00 or 0xff).
+        //
+        Array<uint8_t, _Nr + 1, 8, 16> _KeySlices;
+
+        //
+        //  The AES S-box on eight bit slices, x[i] holding bit i: the circuit of Boyar and Peralta,
+        //  "A depth-16 circuit for the AES S-box" (2011). __VectorPolicy needs Xor, And and Not.
+        //
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _SubBytes(__VectorType (&x)[8]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+
+            __VectorType x0 = x[7], x1 = x[6], x2 = x[5], x3 = x[4];
+            __VectorType x4 = x[3], x5 = x[2], x6 = x[1], x7 = x[0];
+
+            // Top linear transformation
+            __VectorType y14 = V::Xor(x3, x5);
+            __VectorType y13 = V::Xor(x0, x6);
+            __VectorType y9 = V::Xor(x0, x3);
+            __VectorType y8 = V::Xor(x0, x5);
+            __VectorType t0 = V::Xor(x1, x2);
+            __VectorType y1 = V::Xor(t0, x7);
+            __VectorType y4 = V::Xor(y1, x3);
+            __VectorType y12 = V::Xor(y13, y14);
+            __VectorType y2 = V::Xor(y1, x0);
+            __VectorType y5 = V::Xor(y1, x6);
+            __VectorType y3 = V::Xor(y5, y8);
+            __VectorType t1 = V::Xor(x4, y12);
+            __VectorType y15 = V::Xor(t1, x5);
+            __VectorType y20 = V::Xor(t1, x1);
+            __VectorType y6 = V::Xor(y15, x7);
+            __VectorType y10 = V::Xor(y15, t0);
+            __VectorType y11 = V::Xor(y20, y9);
+            __VectorType y7 = V::Xor(x7, y11);
+            __VectorType y17 = V::Xor(y10, y11);
+            __VectorType y19 = V::Xor(y10, y8);
+            __VectorType y16 = V::Xor(t0, y11);
+            __VectorType y21 = V::Xor(y13, y16);
+            __VectorType y18 = V::Xor(x0, y16);
+
+            // Inversion in GF(2^8) over GF(2^4)
+            __VectorType t2 = V::And(y12, y15);
+            __VectorType t3 = V::And(y3, y6);
+            __VectorType t4 = V::Xor(t3, t2);
+            __VectorType t5 = V::And(y4, x7);
+            __VectorType t6 = V::Xor(t5, t2);
+            __VectorType t7 = V::And(y13, y16);
+            __VectorType t8 = V::And(y5, y1);
+            __VectorType t9 = V::Xor(t8, t7);
+            __VectorType t10 = V::And(y2, y7);
+            __VectorType t11 = V::Xor(t10, t7);
+            __VectorType t12 = V::And(y9, y11);
+            __VectorType t13 = V::And(y14, y17);
+            __VectorType t14 = V::Xor(t13, t12);
+            __VectorType t15 = V::And(y8, y10);
+            __VectorType t16 = V::Xor(t15, t12);
+            __VectorType t17 = V::Xor(t4, t14);
+            __VectorType t18 = V::Xor(t6, t16);
+            __VectorType t19 = V::Xor(t9, t14);
+            __VectorType t20 = V::Xor(t11, t16);
+            __VectorType t21 = V::Xor(t17, y20);
+            __VectorType t22 = V::Xor(t18, y19);
+            __VectorType t23 = V::Xor(t19, y21);
+            __VectorType t24 = V::Xor(t20, y18);
+
+            __VectorType t25 = V::Xor(t21, t22);
+            __VectorType t26 = V::And(t21, t23);
+            __VectorType t27 = V::Xor(t24, t26);
+            __VectorType t28 = V::And(t25, t27);
+            __VectorType t29 = V::Xor(t28, t22);
+            __VectorType t30 = V::Xor(t23, t24);
+            __VectorType t31 = V::Xor(t22, t26);
+            __VectorType t32 = V::And(t31, t30);
+            __VectorType t33 = V::Xor(t32, t24);
+            __VectorType t34 = V::Xor(t23, t33);
+            __VectorType t35 = V::Xor(t27, t33);
+            __VectorType t36 = V::And(t24, t35);
+            __VectorType t37 = V::Xor(t36, t34);
+            __VectorType t38 = V::Xor(t27, t36);
+            __VectorType t39 = V::And(t29, t38);
+            __VectorType t40 = V::Xor(t25, t39);
+
+            __VectorType t41 = V::Xor(t40, t37);
+            __VectorType t42 = V::Xor(t29, t33);
+            __VectorType t43 = V::Xor(t29, t40);
+            __VectorType t44 = V::Xor(t33, t37);
+            __VectorType t45 = V::Xor(t42, t41);
+            __VectorType z0 = V::And(t44, y15);
+            __VectorType z1 = V::And(t37, y6);
+            __VectorType z2 = V::And(t33, x7);
+            __VectorType z3 = V::And(t43, y16);
+            __VectorType z4 = V::And(t40, y1);
+            __VectorType z5 = V::And(t29, y7);
+            __VectorType z6 = V::And(t42, y11);
+            __VectorType z7 = V::And(t45, y17);
+            __VectorType z8 = V::And(t41, y10);
+            __VectorType z9 = V::And(t44, y12);
+            __VectorType z10 = V::And(t37, y3);
+            __VectorType z11 = V::And(t33, y4);
+            __VectorType z12 = V::And(t43, y13);
+            __VectorType z13 = V::And(t40, y5);
+            __VectorType z14 = V::And(t29, y2);
+            __VectorType z15 = V::And(t42, y9);
+            __VectorType z16 = V::And(t45, y14);
+            __VectorType z17 = V::And(t41, y8);
+
+            // Bottom linear transformation
+            __VectorType t46 = V::Xor(z15, z16);
+            __VectorType t47 = V::Xor(z10, z11);
+            __VectorType t48 = V::Xor(z5, z13);
+            __VectorType t49 = V::Xor(z9, z10);
+            __VectorType t50 = V::Xor(z2, z12);
+            __VectorType t51 = V::Xor(z2, z5);
+            __VectorType t52 = V::Xor(z7, z8);
+            __VectorType t53 = V::Xor(z0, z3);
+            __VectorType t54 = V::Xor(z6, z7);
+            __VectorType t55 = V::Xor(z16, z17);
+            __VectorType t56 = V::Xor(z12, t48);
+            __VectorType t57 = V::Xor(t50, t53);
+            __VectorType t58 = V::Xor(z4, t46);
+            __VectorType t59 = V::Xor(z3, t54);
+            __VectorType t60 = V::Xor(t46, t57);
+            __VectorType t61 = V::Xor(z14, t57);
+            __VectorType t62 = V::Xor(t52, t58);
+            __VectorType t63 = V::Xor(t49, t58);
+            __VectorType t64 = V::Xor(z4, t59);
+            __VectorType t65 = V::Xor(t61, t62);
+            __VectorType t66 = V::Xor(z1, t63);
+            __VectorType s0 = V::Xor(t59, t63);
+            __VectorType s6 = V::Not(V::Xor(t56, t62));
+            __VectorType s7 = V::Not(V::Xor(t48, t60));
+            __VectorType t67 = V::Xor(t64, t65);
+            __VectorType s3 = V::Xor(t53, t66);
+            __VectorType s4 = V::Xor(t51, t66);
+            __VectorType s5 = V::Xor(t47, t65);
+            __VectorType s1 = V::Not(V::Xor(t64, s3));
+            __VectorType s2 = V::Not(V::Xor(t55, t67));
+
+            x[7] = s0; x[6] = s1; x[5] = s2; x[4] = s3;
+            x[3] = s4; x[2] = s5; x[1] = s6; x[0] = s7;
+        }
+
+        //
+        //  The linear part of the inverse of the S-box's affine map: bit i = bit (i + 2) ^ bit (i + 5) ^ bit (i + 7).
+        //
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _InverseAffine(__VectorType (&x)[8]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+            __VectorType y[8];
+
+            for (size_t i = 0; i < 8; ++i)
+                y[i] = V::Xor(V::Xor(x[(i + 2) % 8], x[(i + 5) % 8]), x[(i + 7) % 8]);
+            for (size_t i = 0; i < 8; ++i)
+                x[i] = y[i];
+        }
+
+        //
+        //  S^-1(y) = L(S(L(y) ^ 0x05) ^ 0x63), where S(x) = A(x^-1) ^ 0x63 and L is the linear part of A^-1.
+        //
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _InverseSubBytes(__VectorType (&x)[8]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+
+            _InverseAffine<V>(x);
+            x[0] = V::Not(x[0]);
+            x[2] = V::Not(x[2]);
+            _SubBytes<V>(x);
+            x[0] = V::Not(x[0]);
+            x[1] = V::Not(x[1]);
+            x[5] = V::Not(x[5]);
+            x[6] = V::Not(x[6]);
+            _InverseAffine<V>(x);
+        }
+
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _Permute(__VectorType (&x)[8], const uint8_t (&Mask)[16]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+            __VectorType m = V::Broadcast(Mask);
+
+            for (size_t i = 0; i < 8; ++i)
+                x[i] = V::Shuffle(x[i], m);
+        }
+
+        //
+        //  Multiplication by x in GF(2^8), modulo x^8 + x^4 + x^3 + x + 1.
+        //
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _Double(__VectorType (&x)[8]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+            __VectorType Carry = x[7];
+
+            x[7] = x[6];
+            x[6] = x[5];
+            x[5] = x[4];
+            x[4] = V::Xor(x[3], Carry);
+            x[3] = V::Xor(x[2], Carry);
+            x[2] = x[1];
+            x[1] = V::Xor(x[0], Carry);
+            x[0] = Carry;
+        }
+
+        //
+        //  out[r] = 2 a[r] ^ 3 a[r + 1] ^ a[r + 2] ^ a[r + 3]  =  2 t[r] ^ a[r + 1] ^ t[r + 2],  with t[r] = a[r] ^ a[r + 1]
+        //
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _MixColumns(__VectorType (&x)[8]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+            __VectorType Rotate1 = V::Broadcast(_RotateRows1Mask);
+            __VectorType Rotate2 = V::Broadcast(_RotateRows2Mask);
+            __VectorType a1[8];
+            __VectorType t[8];
+
+            for (size_t i = 0; i < 8; ++i) {
+                a1[i] = V::Shuffle(x[i], Rotate1);
+                t[i] = V::Xor(x[i], a1[i]);
+                x[i] = V::Xor(a1[i], V::Shuffle(t[i], Rotate2));
+            }
+
+            _Double<V>(t);
+
+            for (size_t i = 0; i < 8; ++i)
+                x[i] = V::Xor(x[i], t[i]);
+        }
+
+        //
+        //  InvMixColumns = MixColumns * circ(5, 0, 4, 0):  a[r] ^= 4 (a[r] ^ a[r + 2]) first.
+        //
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _InverseMixColumns(__VectorType (&x)[8]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+            __VectorType Rotate2 = V::Broadcast(_RotateRows2Mask);
+            __VectorType u[8];
+
+            for (size_t i = 0; i < 8; ++i)
+                u[i] = V::Xor(x[i], V::Shuffle(x[i], Rotate2));
+
+            _Double<V>(u);
+            _Double<V>(u);
+
+            for (size_t i = 0; i < 8; ++i)
+                x[i] = V::Xor(x[i], u[i]);
+
+            _MixColumns<V>(x);
+        }
+
+        template<typename __VectorPolicy, typename __VectorType>
+        ACCEL_FORCEINLINE
+        static void _AddRoundKey(__VectorType (&x)[8], const uint8_t (&RoundKey)[8][16]) ACCEL_NOEXCEPT {
+            using V = __VectorPolicy;
+
+            for (size_t i = 0; i < 8; ++i)
+                x[i] = V::Xor(x[i], V::Broadcast(RoundKey[i]));
+        }
+
+        struct _EncryptKernel {
+            template<typename __VectorPolicy>
+            ACCEL_FORCEINLINE
+            static void Run(const AES_BITSLICED_ALG& Alg, uint8_t*& pbBlocks, size_t& GroupCount) ACCEL_NOEXCEPT {
+                using V = __VectorPolicy;
+                typename V::VectorType x[8];
+
+                for (size_t g = 0; g < GroupCount; ++g, pbBlocks += V::BlocksValue * BlockSizeValue) {
+                    V::LoadBlocks(x, pbBlocks);
+                    Internal::BitsliceTranspose<V>(x);
+
+                    _AddRoundKey<V>(x, Alg._KeySlices[0]);
+                    for (size_t r = 1; r < _Nr; ++r) {
+                        _SubBytes<V>(x);
+                        _Permute<V>(x, _ShiftRowsMask);
+                        _MixColumns<V>(x);
+                        _AddRoundKey<V>(x, Alg._KeySlices[r]);
+                    }
+                    _SubBytes<V>(x);
+                    _Permute<V>(x, _ShiftRowsMask);
+                    _AddRoundKey<V>(x, Alg._KeySlices[_Nr]);
+
+                    Internal::BitsliceTranspose<V>(x);
+                    V::StoreBlocks(pbBlocks, x);
+                }
+            }
+        };
+
+        struct _DecryptKernel {
+            template<typename __VectorPolicy>
+            ACCEL_FORCEINLINE
+            static void Run(const AES_BITSLICED_ALG& Alg, uint8_t*& pbBlocks, size_t& GroupCount) ACCEL_NOEXCEPT {
+                using V = __VectorPolicy;
+                typename V::VectorType x[8];
+
+                for (size_t g = 0; g < GroupCount; ++g, pbBlocks += V::BlocksValue * BlockSizeValue) {
+                    V::LoadBlocks(x, pbBlocks);
+                    Internal::BitsliceTranspose<V>(x);
+
+                    _AddRoundKey<V>(x, Alg._KeySlices[_Nr]);
+                    for (size_t r = _Nr - 1; r > 0; --r) {
+                        _Permute<V>(x, _InverseShiftRowsMask);
+                        _InverseSubBytes<V>(x);
+                        _AddRoundKey<V>(x, Alg._KeySlices[r]);
+                        _InverseMixColumns<V>(x);
+                    }
+                    _Permute<V>(x, _InverseShiftRowsMask);
+                    _InverseSubBytes<V>(x);
+                    _AddRoundKey<V>(x, Alg._KeySlices[0]);
+
+                    Internal::BitsliceTranspose<V>(x);
+                    V::StoreBlocks(pbBlocks, x);
+                }
+            }
+        };
+
+        //
+        //  Plain operators on 32-bit words, for running _SubBytes on the key schedule's words.
+        //
+        struct _WordPolicy {
+            static uint32_t Xor(uint32_t a, uint32_t b) ACCEL_NOEXCEPT { return a ^ b; }
+            static uint32_t And(uint32_t a, uint32_t b) ACCEL_NOEXCEPT { return a & b; }
+            static uint32_t Not(uint32_t a) ACCEL_NOEXCEPT { return ~a; }
+        };
+
+        //
+        //  SubWord of the key schedule, on the 4 bytes at `pbWord`, in constant time.
+        //
+        static void _SubWord(uint8_t* pbWord) ACCEL_NOEXCEPT {
+            uint32_t x[8] = {};
+
+            for (size_t i = 0; i < 8; ++i) {
+                for (size_t j = 0; j < 4; ++j)
+                    x[i] |= static_cast<uint32_t>((pbWord[j] >> i) & 1u) << j;
+            }
+
+            _SubBytes<_WordPolicy>(x);
+
+            for (size_t j = 0; j < 4; ++j) {
+                uint8_t Byte = 0;
+                for (size_t i = 0; i < 8; ++i)
+                    Byte |= static_cast<uint8_t>(((x[i] >> j) & 1u) << i);
+                pbWord[j] = Byte;
+            }
+
+            SecureWipe(x, sizeof(x));
+        }
+
+        void _KeyExpansion(const uint8_t* pbUserKey) ACCEL_NOEXCEPT {
+            uint8_t w[4 * _Nb * (_Nr + 1)];
+            uint8_t Rcon = 0x01;
+
+            memcpy(w, pbUserKey, KeySizeValue);
+
+            for (size_t i = _Nk; i < _Nb * (_Nr + 1); ++i) {
+                uint8_t Temp[4];
+
+                memcpy(Temp, w + 4 * (i - 1), 4);
+                if (i % _Nk == 0) {
+                    uint8_t First = Temp[0];
+                    Temp[0] = Temp[1];
+                    Temp[1] = Temp[2];
+                    Temp[2] = Temp[3];
+                    Temp[3] = First;
+                    _SubWord(Temp);
+                    Temp[0] ^= Rcon;
+                    Rcon = static_cast<uint8_t>(Rcon << 1 ^ (Rcon >> 7) * 0x1b);
+                } else if (_Nk > 6 && i % _Nk == 4) {
+                    _SubWord(Temp);
+                }
+
+                for (size_t j = 0; j < 4; ++j)
+                    w[4 * i + j] = w[4 * (i - _Nk) + j] ^ Temp[j];
+            }
+
+            for (size_t r = 0; r <= _Nr; ++r) {
+                for (size_t i = 0; i < 8; ++i) {
+                    for (size_t p = 0; p < 16; ++p)
+                        _KeySlices[r][i][p] = static_cast<uint8_t>(0u - ((w[16 * r + p] >> i) & 1u));
+                }
+            }
+
+            SecureWipe(w, sizeof(w));
+        }
+
+        template<typename __KernelType>
+        void _Process(void* pbData, size_t BlockCount) const ACCEL_NOEXCEPT {
+            constexpr size_t Narrow = Internal::BitsliceVectorSSSE3::BlocksValue;
+            constexpr size_t Wide = Internal::BitsliceVectorAVX2::BlocksValue;
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbData);
+
+            if (BlockCount >= Wide && RuntimeCpuFeatures().AVX2) {
+                size_t GroupCount = BlockCount / Wide;
+                Internal::BitsliceVectorAVX2::template Invoke<__KernelType>(*this, pbBlocks, GroupCount);
+                BlockCount %= Wide;
+            }
+
+            if (BlockCount >= Narrow) {
+                size_t GroupCount = BlockCount / Narrow;
+                Internal::BitsliceVectorSSSE3::template Invoke<__KernelType>(*this, pbBlocks, GroupCount);
+                BlockCount %= Narrow;
+            }
+
+            if (BlockCount) {
+                uint8_t Staging[Narrow * BlockSizeValue] = {};
+                uint8_t* pbStaging = Staging;
+                size_t GroupCount = 1;
+
+                memcpy(Staging, pbBlocks, BlockCount * BlockSizeValue);
+                Internal::BitsliceVectorSSSE3::template Invoke<__KernelType>(*this, pbStaging, GroupCount);
+                memcpy(pbBlocks, Staging, BlockCount * BlockSizeValue);
+                SecureWipe(Staging, sizeof(Staging));
+            }
+        }
+
+    public:
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t KeySize() const ACCEL_NOEXCEPT {
+            return KeySizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            if (cbUserKey != KeySizeValue) {
+                return false;
+            } else {
+                _KeyExpansion(reinterpret_cast<const uint8_t*>(pbUserKey));
+                return true;
+            }
+        }
+
+        size_t EncryptBlock(void* pbPlaintext) const ACCEL_NOEXCEPT {
+            _Process<_EncryptKernel>(pbPlaintext, 1);
+            return BlockSizeValue;
+        }
+
+        size_t DecryptBlock(void* pbCiphertext) const ACCEL_NOEXCEPT {
+            _Process<_DecryptKernel>(pbCiphertext, 1);
+            return BlockSizeValue;
+        }
+
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion, 16 at a time with AVX2, else 8 at a time.
+        //
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            _Process<_EncryptKernel>(pbPlaintext, BlockCount);
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion.
+        //
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            _Process<_DecryptKernel>(pbCiphertext, BlockCount);
+            return BlockCount * BlockSizeValue;
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _KeySlices.SecureZero();
+        }
+
+        ~AES_BITSLICED_ALG() ACCEL_NOEXCEPT {
+            _KeySlices.SecureZero();
+        }
+    };
+
+}
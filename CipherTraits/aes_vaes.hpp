@@ -0,0 +1,314 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../Intrinsic.hpp"
+#include "aes_aesni.hpp"
+#include <utility>
+
+namespace accel::CipherTraits {
+
+    //
+    //  AES on VAES, which runs AESENC/AESDEC on every 128-bit slot of a ymm/zmm register.
+    //  Single blocks and tails shorter than one register are served by AES_AESNI_ALG.
+    //
+    //  Like AES_AESNI_ALG, the members are compiled with ACCEL_TARGET(...), so no `-mvaes` is needed;
+    //  check RuntimeCpuFeatures().VAES (and .AVX512F for 512-bit lanes) before use, or go through AES_ALG.
+    //
+    template<size_t __KeyBits, size_t __LaneBits = 512>
+    class AES_VAES_ALG {
+        static_assert(__LaneBits == 256 || __LaneBits == 512,
+                      "AES_VAES_ALG failure! Unsupported __LaneBits.");
+    };
+
+    //
+    //  512-bit lanes (AVX-512): every VAES instruction processes 4 blocks.
+    //
+    template<size_t __KeyBits>
+    class AES_VAES_ALG<__KeyBits, 512> {
+        static_assert(__KeyBits == 128 || __KeyBits == 192 || __KeyBits == 256,
+                      "AES_VAES_ALG failure! Unsupported __KeyBits.");
+    public:
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t KeySizeValue = __KeyBits / 8;
+    private:
+        static constexpr size_t _Nb = 4;
+        static constexpr size_t _Nk = __KeyBits / 32;
+        static constexpr size_t _Nr = (_Nb > _Nk ? _Nb : _Nk) + 6;
+
+        static constexpr size_t _BlocksPerLane = sizeof(__m512i) / BlockSizeValue;
+        static constexpr size_t _LanesInFlight = 4;
+
+        AES_AESNI_ALG<__KeyBits> _NarrowAlg;
+        Array<__m512i, _Nr + 1> _WideKey;
+        Array<__m512i, _Nr + 1> _WideInvKey;
+
+        //
+        //  Broadcast the 128-bit round keys of `_NarrowAlg` to every 128-bit slot of a lane.
+        //  This function is for internal use only.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,avx512f,vaes")
+        void _WideKeyExpansion() ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < _Nr + 1; ++i) {
+                _WideKey[i] = _mm512_broadcast_i32x4(_NarrowAlg._Key[i]);
+                _WideInvKey[i] = _mm512_broadcast_i32x4(_NarrowAlg._InvKey[i]);
+            }
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,avx512f,vaes")
+        void _EncryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            auto pbLanes = reinterpret_cast<__m512i*>(pbBlocks);
+            __m512i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm512_xor_si512(_mm512_loadu_si512(pbLanes + __LaneIndexes), _WideKey[0])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m512i RoundKey = _WideKey[i];
+                ((Lanes[__LaneIndexes] = _mm512_aesenc_epi128(Lanes[__LaneIndexes], RoundKey)), ...);
+            }
+            ((Lanes[__LaneIndexes] = _mm512_aesenclast_epi128(Lanes[__LaneIndexes], _WideKey[_Nr])), ...);
+            (_mm512_storeu_si512(pbLanes + __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,avx512f,vaes")
+        void _DecryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            auto pbLanes = reinterpret_cast<__m512i*>(pbBlocks);
+            __m512i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm512_xor_si512(_mm512_loadu_si512(pbLanes + __LaneIndexes), _WideInvKey[0])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m512i RoundKey = _WideInvKey[i];
+                ((Lanes[__LaneIndexes] = _mm512_aesdec_epi128(Lanes[__LaneIndexes], RoundKey)), ...);
+            }
+            ((Lanes[__LaneIndexes] = _mm512_aesdeclast_epi128(Lanes[__LaneIndexes], _WideInvKey[_Nr])), ...);
+            (_mm512_storeu_si512(pbLanes + __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
+    public:
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t KeySize() const ACCEL_NOEXCEPT {
+            return KeySizeValue;
+        }
+
+        ACCEL_NODISCARD
+        ACCEL_TARGET("aes,avx512f,vaes")
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            if (_NarrowAlg.SetKey(pbUserKey, cbUserKey)) {
+                _WideKeyExpansion();
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        size_t EncryptBlock(void* pbPlaintext) ACCEL_NOEXCEPT {
+            return _NarrowAlg.EncryptBlock(pbPlaintext);
+        }
+
+        size_t DecryptBlock(void* pbCiphertext) ACCEL_NOEXCEPT {
+            return _NarrowAlg.DecryptBlock(pbCiphertext);
+        }
+
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion.
+        //  16 blocks are kept in flight at a time.
+        //
+        ACCEL_TARGET("aes,avx512f,vaes")
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbPlaintext);
+            size_t i = 0;
+
+            for (; i + _LanesInFlight * _BlocksPerLane <= BlockCount; i += _LanesInFlight * _BlocksPerLane)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<_LanesInFlight>{});
+
+            for (; i + _BlocksPerLane <= BlockCount; i += _BlocksPerLane)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            _NarrowAlg.EncryptBlocks(pbBlocks + i * BlockSizeValue, BlockCount - i);
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion.
+        //
+        ACCEL_TARGET("aes,avx512f,vaes")
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbCiphertext);
+            size_t i = 0;
+
+            for (; i + _LanesInFlight * _BlocksPerLane <= BlockCount; i += _LanesInFlight * _BlocksPerLane)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<_LanesInFlight>{});
+
+            for (; i + _BlocksPerLane <= BlockCount; i += _BlocksPerLane)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            _NarrowAlg.DecryptBlocks(pbBlocks + i * BlockSizeValue, BlockCount - i);
+            return BlockCount * BlockSizeValue;
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _NarrowAlg.ClearKey();
+            _WideKey.SecureZero();
+            _WideInvKey.SecureZero();
+        }
+
+        ~AES_VAES_ALG() ACCEL_NOEXCEPT {
+            _WideKey.SecureZero();
+            _WideInvKey.SecureZero();
+        }
+    };
+
+    //
+    //  256-bit lanes (AVX2): every VAES instruction processes 2 blocks.
+    //
+    template<size_t __KeyBits>
+    class AES_VAES_ALG<__KeyBits, 256> {
+        static_assert(__KeyBits == 128 || __KeyBits == 192 || __KeyBits == 256,
+                      "AES_VAES_ALG failure! Unsupported __KeyBits.");
+    public:
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t KeySizeValue = __KeyBits / 8;
+    private:
+        static constexpr size_t _Nb = 4;
+        static constexpr size_t _Nk = __KeyBits / 32;
+        static constexpr size_t _Nr = (_Nb > _Nk ? _Nb : _Nk) + 6;
+
+        static constexpr size_t _BlocksPerLane = sizeof(__m256i) / BlockSizeValue;
+        static constexpr size_t _LanesInFlight = 4;
+
+        AES_AESNI_ALG<__KeyBits> _NarrowAlg;
+        Array<__m256i, _Nr + 1> _WideKey;
+        Array<__m256i, _Nr + 1> _WideInvKey;
+
+        //
+        //  Broadcast the 128-bit round keys of `_NarrowAlg` to every 128-bit slot of a lane.
+        //  This function is for internal use only.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,avx2,vaes")
+        void _WideKeyExpansion() ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < _Nr + 1; ++i) {
+                _WideKey[i] = _mm256_broadcastsi128_si256(_NarrowAlg._Key[i]);
+                _WideInvKey[i] = _mm256_broadcastsi128_si256(_NarrowAlg._InvKey[i]);
+            }
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,avx2,vaes")
+        void _EncryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            auto pbLanes = reinterpret_cast<__m256i*>(pbBlocks);
+            __m256i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm256_xor_si256(_mm256_loadu_si256(pbLanes + __LaneIndexes), _WideKey[0])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m256i RoundKey = _WideKey[i];
+                ((Lanes[__LaneIndexes] = _mm256_aesenc_epi128(Lanes[__LaneIndexes], RoundKey)), ...);
+            }
+            ((Lanes[__LaneIndexes] = _mm256_aesenclast_epi128(Lanes[__LaneIndexes], _WideKey[_Nr])), ...);
+            (_mm256_storeu_si256(pbLanes + __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,avx2,vaes")
+        void _DecryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            auto pbLanes = reinterpret_cast<__m256i*>(pbBlocks);
+            __m256i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm256_xor_si256(_mm256_loadu_si256(pbLanes + __LaneIndexes), _WideInvKey[0])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m256i RoundKey = _WideInvKey[i];
+                ((Lanes[__LaneIndexes] = _mm256_aesdec_epi128(Lanes[__LaneIndexes], RoundKey)), ...);
+            }
+            ((Lanes[__LaneIndexes] = _mm256_aesdeclast_epi128(Lanes[__LaneIndexes], _WideInvKey[_Nr])), ...);
+            (_mm256_storeu_si256(pbLanes + __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
+    public:
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t KeySize() const ACCEL_NOEXCEPT {
+            return KeySizeValue;
+        }
+
+        ACCEL_NODISCARD
+        ACCEL_TARGET("aes,avx2,vaes")
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            if (_NarrowAlg.SetKey(pbUserKey, cbUserKey)) {
+                _WideKeyExpansion();
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        size_t EncryptBlock(void* pbPlaintext) ACCEL_NOEXCEPT {
+            return _NarrowAlg.EncryptBlock(pbPlaintext);
+        }
+
+        size_t DecryptBlock(void* pbCiphertext) ACCEL_NOEXCEPT {
+            return _NarrowAlg.DecryptBlock(pbCiphertext);
+        }
+
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion.
+        //  8 blocks are kept in flight at a time.
+        //
+        ACCEL_TARGET("aes,avx2,vaes")
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbPlaintext);
+            size_t i = 0;
+
+            for (; i + _LanesInFlight * _BlocksPerLane <= BlockCount; i += _LanesInFlight * _BlocksPerLane)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<_LanesInFlight>{});
+
+            for (; i + _BlocksPerLane <= BlockCount; i += _BlocksPerLane)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            _NarrowAlg.EncryptBlocks(pbBlocks + i * BlockSizeValue, BlockCount - i);
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion.
+        //
+        ACCEL_TARGET("aes,avx2,vaes")
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbCiphertext);
+            size_t i = 0;
+
+            for (; i + _LanesInFlight * _BlocksPerLane <= BlockCount; i += _LanesInFlight * _BlocksPerLane)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<_LanesInFlight>{});
+
+            for (; i + _BlocksPerLane <= BlockCount; i += _BlocksPerLane)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            _NarrowAlg.DecryptBlocks(pbBlocks + i * BlockSizeValue, BlockCount - i);
+            return BlockCount * BlockSizeValue;
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _NarrowAlg.ClearKey();
+            _WideKey.SecureZero();
+            _WideInvKey.SecureZero();
+        }
+
+        ~AES_VAES_ALG() ACCEL_NOEXCEPT {
+            _WideKey.SecureZero();
+            _WideInvKey.SecureZero();
+        }
+    };
+
+}
+
@@ -132,15 +132,21 @@ namespace accel::CipherTraits {
                 _SubKey[i] ^= temp;
             }
 
+            //
+            // Store word by word: writing the uint32_t tables through uint64_t lvalues breaks strict aliasing,
+            // and GCC at -O2 then reorders the stores against the loads in _EncryptProcess.
+            //
             BlockType temp = {};
-            for (int i = 0; i < 9; ++i) {
+            for (int i = 0; i < 18; i += 2) {
                 _EncryptProcess<true>(temp);
-                _SubKey.template AsCArrayOf<uint64_t[9]>()[i] = temp.template AsCArrayOf<uint64_t[1]>()[0];
+                _SubKey[i] = temp[0];
+                _SubKey[i + 1] = temp[1];
             }
 
-            for (int i = 0; i < 512; ++i) {
+            for (int i = 0; i < 1024; i += 2) {
                 _EncryptProcess<true>(temp);
-                _SubBox.template AsCArrayOf<uint64_t[512]>()[i] = temp.template AsCArrayOf<uint64_t[1]>()[0];
+                _SubBox.template AsCArrayOf<uint32_t[1024]>()[i] = temp[0];
+                _SubBox.template AsCArrayOf<uint32_t[1024]>()[i + 1] = temp[1];
             }
         }
 
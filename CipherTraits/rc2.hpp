@@ -223,7 +223,8 @@ namespace accel::CipherTraits {
                 EffectiveBits = 8 * cbUserKey;
 
             if (MinKeySizeValue <= cbUserKey && cbUserKey <= MaxKeySizeValue) {
-                if (EffectiveBits > 8 * cbUserKey)
+                // RFC 2268 allows any effective key length from 1 to 1024 bits, independent of the key's byte length.
+                if (EffectiveBits > 1024)
                     return false;
                 _KeyExpansion(pbUserKey, EffectiveBits, cbUserKey);
                 return true;
@@ -3,10 +3,26 @@
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
 #include "Internal/rijndael_constant.hpp"
+#include <utility>
 
 namespace accel::CipherTraits {
 
-    template<size_t __KeyBits, size_t __BlockBits>
+    //
+    //  How RIJNDAEL_ALG computes a round.
+    //
+    //      TTable      ByteSub, ShiftRow and MixColumn of a whole column folded into four lookups in 1 KiB tables;
+    //                  8 KiB of tables in total, and a second key schedule for decryption.
+    //      ByteWise    the steps one after another, byte by byte, with 256-byte tables only.
+    //
+    //  Both look up tables indexed by key and data, so neither is constant-time.
+    //  ByteWise keeps the smaller cache footprint, which may matter where it is shared with other code.
+    //
+    enum class RijndaelPolicy {
+        TTable,
+        ByteWise
+    };
+
+    template<size_t __KeyBits, size_t __BlockBits, RijndaelPolicy __Policy = RijndaelPolicy::TTable>
     class RIJNDAEL_ALG : public Internal::RIJNDAEL_CONSTANT {
         static_assert(__KeyBits == 128 || __KeyBits == 160 || __KeyBits == 192 ||  __KeyBits == 224 || __KeyBits == 256, 
                       "RIJNDAEL_ALG failure! Unsupported __KeyBits.");
@@ -21,6 +37,11 @@ namespace accel::CipherTraits {
         static constexpr size_t _Nk = __KeyBits / 32;
         static constexpr size_t _Nr = (_Nb > _Nk ? _Nb : _Nk) + 6;
 
+        // the shift offsets of the second, third and fourth row, see _ShiftRow
+        static constexpr size_t _C1 = 1;
+        static constexpr size_t _C2 = _Nb == 8 ? 3 : 2;
+        static constexpr size_t _C3 = _Nb >= 7 ? 4 : 3;
+
         using BlockType = Array<uint8_t, BlockSizeValue>;
         static_assert(sizeof(BlockType) == BlockSizeValue);
 
@@ -375,8 +396,118 @@ namespace accel::CipherTraits {
             }
         }
 
+        template<size_t __Row>
+        ACCEL_FORCEINLINE
+        static size_t _RowByte(uint32_t Column) ACCEL_NOEXCEPT {
+            return (Column >> (8 * __Row)) & 0xff;
+        }
+
+        //
+        //  One full round on words: Out[j] is column j of MixColumn(ShiftRow(ByteSub(In))) ^ RoundKey.
+        //  Row r of column j comes from column j + Cr, so each output column takes one lookup from each of four columns.
+        //
+        template<size_t... __Columns>
+        ACCEL_FORCEINLINE
+        static void _TableRound(uint32_t (&Out)[_Nb], const uint32_t (&In)[_Nb], const uint32_t (&RoundKey)[_Nb],
+                                std::index_sequence<__Columns...>) ACCEL_NOEXCEPT {
+            ((Out[__Columns] =
+                TableE0[_RowByte<0>(In[__Columns])] ^
+                TableE1[_RowByte<1>(In[(__Columns + _C1) % _Nb])] ^
+                TableE2[_RowByte<2>(In[(__Columns + _C2) % _Nb])] ^
+                TableE3[_RowByte<3>(In[(__Columns + _C3) % _Nb])] ^
+                RoundKey[__Columns]), ...);
+        }
+
+        template<size_t... __Columns>
+        ACCEL_FORCEINLINE
+        static void _TableFinalRound(uint32_t (&Out)[_Nb], const uint32_t (&In)[_Nb], const uint32_t (&RoundKey)[_Nb],
+                                     std::index_sequence<__Columns...>) ACCEL_NOEXCEPT {
+            ((Out[__Columns] =
+                (uint32_t{ SBox[_RowByte<0>(In[__Columns])] }) ^
+                (uint32_t{ SBox[_RowByte<1>(In[(__Columns + _C1) % _Nb])] } << 8) ^
+                (uint32_t{ SBox[_RowByte<2>(In[(__Columns + _C2) % _Nb])] } << 16) ^
+                (uint32_t{ SBox[_RowByte<3>(In[(__Columns + _C3) % _Nb])] } << 24) ^
+                RoundKey[__Columns]), ...);
+        }
+
+        //
+        //  The inverse round of the equivalent inverse cipher: InverseMixColumn(InverseShiftRow(InverseByteSub(In))) ^ RoundKey,
+        //  where RoundKey has already been through InverseMixColumn, see _InverseKeyExpansion.
+        //
+        template<size_t... __Columns>
+        ACCEL_FORCEINLINE
+        static void _InverseTableRound(uint32_t (&Out)[_Nb], const uint32_t (&In)[_Nb], const uint32_t (&RoundKey)[_Nb],
+                                       std::index_sequence<__Columns...>) ACCEL_NOEXCEPT {
+            ((Out[__Columns] =
+                TableD0[_RowByte<0>(In[__Columns])] ^
+                TableD1[_RowByte<1>(In[(__Columns + _Nb - _C1) % _Nb])] ^
+                TableD2[_RowByte<2>(In[(__Columns + _Nb - _C2) % _Nb])] ^
+                TableD3[_RowByte<3>(In[(__Columns + _Nb - _C3) % _Nb])] ^
+                RoundKey[__Columns]), ...);
+        }
+
+        template<size_t... __Columns>
+        ACCEL_FORCEINLINE
+        static void _InverseTableFinalRound(uint32_t (&Out)[_Nb], const uint32_t (&In)[_Nb], const uint32_t (&RoundKey)[_Nb],
+                                            std::index_sequence<__Columns...>) ACCEL_NOEXCEPT {
+            ((Out[__Columns] =
+                (uint32_t{ InverseSBox[_RowByte<0>(In[__Columns])] }) ^
+                (uint32_t{ InverseSBox[_RowByte<1>(In[(__Columns + _Nb - _C1) % _Nb])] } << 8) ^
+                (uint32_t{ InverseSBox[_RowByte<2>(In[(__Columns + _Nb - _C2) % _Nb])] } << 16) ^
+                (uint32_t{ InverseSBox[_RowByte<3>(In[(__Columns + _Nb - _C3) % _Nb])] } << 24) ^
+                RoundKey[__Columns]), ...);
+        }
+
+        //
+        //  The rounds are unrolled and alternate between the two halves of State, so that nothing is copied in between.
+        //  Returns the half that holds the result.
+        //
+        template<size_t... __Rounds>
+        ACCEL_FORCEINLINE
+        size_t _TableEncryptRounds(Array<uint32_t, 2, _Nb>& State, std::index_sequence<__Rounds...>) const ACCEL_NOEXCEPT {
+            (_TableRound(State[(__Rounds + 1) % 2], State[__Rounds % 2], _Key[__Rounds + 1], std::make_index_sequence<_Nb>{}), ...);
+            _TableFinalRound(State[_Nr % 2], State[(_Nr - 1) % 2], _Key[_Nr], std::make_index_sequence<_Nb>{});
+            return _Nr % 2;
+        }
+
+        template<size_t... __Rounds>
+        ACCEL_FORCEINLINE
+        size_t _TableDecryptRounds(Array<uint32_t, 2, _Nb>& State, std::index_sequence<__Rounds...>) const ACCEL_NOEXCEPT {
+            (_InverseTableRound(State[(__Rounds + 1) % 2], State[__Rounds % 2], _InverseKey[__Rounds + 1], std::make_index_sequence<_Nb>{}), ...);
+            _InverseTableFinalRound(State[_Nr % 2], State[(_Nr - 1) % 2], _InverseKey[_Nr], std::make_index_sequence<_Nb>{});
+            return _Nr % 2;
+        }
+
+        //
+        //  Round keys of the equivalent inverse cipher, in the order they are used:
+        //  _Key[_Nr], InverseMixColumn(_Key[_Nr - 1]), ..., InverseMixColumn(_Key[1]), _Key[0].
+        //  InverseMixColumn of a word is taken as TableD of SBox of its bytes, since InverseSBox undoes the SBox.
+        //
+        ACCEL_FORCEINLINE
+        void _InverseKeyExpansion() ACCEL_NOEXCEPT {
+            for (size_t j = 0; j < _Nb; ++j) {
+                _InverseKey[0][j] = _Key[_Nr][j];
+                _InverseKey[_Nr][j] = _Key[0][j];
+            }
+
+            for (size_t i = 1; i < _Nr; ++i) {
+                for (size_t j = 0; j < _Nb; ++j) {
+                    uint32_t w = _Key[_Nr - i][j];
+                    _InverseKey[i][j] =
+                        TableD0[SBox[_RowByte<0>(w)]] ^
+                        TableD1[SBox[_RowByte<1>(w)]] ^
+                        TableD2[SBox[_RowByte<2>(w)]] ^
+                        TableD3[SBox[_RowByte<3>(w)]];
+                    const_cast<volatile uint32_t&>(w) = 0;
+                }
+            }
+        }
+
         Array<uint32_t, _Nr + 1, _Nb> _Key;
 
+        // only used by RijndaelPolicy::TTable
+        Array<uint32_t, __Policy == RijndaelPolicy::TTable ? _Nr + 1 : 1, _Nb> _InverseKey;
+
     public:
 
         constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
@@ -393,57 +524,83 @@ namespace accel::CipherTraits {
                 return false;
             } else {
                 _KeyExpansion(pbUserKey);
+                if constexpr (__Policy == RijndaelPolicy::TTable) {
+                    _InverseKeyExpansion();
+                }
                 return true;
             }
         }
 
         size_t EncryptBlock(void* pbPlaintext) const ACCEL_NOEXCEPT {
-            BlockType Text;
-            Text.LoadFrom(pbPlaintext);
+            if constexpr (__Policy == RijndaelPolicy::TTable) {
+                Array<uint32_t, 2, _Nb> State;
+                memcpy(State[0], pbPlaintext, BlockSizeValue);
+                for (size_t j = 0; j < _Nb; ++j)
+                    State[0][j] ^= _Key[0][j];
 
-            _XorWithKey(Text, 0);
-            for (size_t i = 1; i < _Nr; ++i) {
+                size_t Result = _TableEncryptRounds(State, std::make_index_sequence<_Nr - 1>{});
+
+                memcpy(pbPlaintext, State[Result], BlockSizeValue);
+            } else {
+                BlockType Text;
+                Text.LoadFrom(pbPlaintext);
+
+                _XorWithKey(Text, 0);
+                for (size_t i = 1; i < _Nr; ++i) {
+                    _ByteSub(Text);
+                    _ShiftRow(Text);
+                    _MixColumn(Text);
+                    _XorWithKey(Text, i);
+                }
                 _ByteSub(Text);
                 _ShiftRow(Text);
-                _MixColumn(Text);
-                _XorWithKey(Text, i);
-            }
-            _ByteSub(Text);
-            _ShiftRow(Text);
-            _XorWithKey(Text, _Nr);
+                _XorWithKey(Text, _Nr);
 
-            Text.StoreTo(pbPlaintext);
+                Text.StoreTo(pbPlaintext);
+            }
             return BlockSizeValue;
         }
 
         size_t DecryptBlock(void* pbCiphertext) const ACCEL_NOEXCEPT {
-            BlockType Text;
-            Text.LoadFrom(pbCiphertext);
+            if constexpr (__Policy == RijndaelPolicy::TTable) {
+                Array<uint32_t, 2, _Nb> State;
+                memcpy(State[0], pbCiphertext, BlockSizeValue);
+                for (size_t j = 0; j < _Nb; ++j)
+                    State[0][j] ^= _InverseKey[0][j];
 
-            _XorWithKey(Text, _Nr);
-            _InverseShiftRow(Text);
-            _InverseByteSub(Text);
-            for (size_t i = 1; i < _Nr; ++i) {
-                _XorWithKey(Text, _Nr - i);
-                _InverseMixColumn(Text);
+                size_t Result = _TableDecryptRounds(State, std::make_index_sequence<_Nr - 1>{});
+
+                memcpy(pbCiphertext, State[Result], BlockSizeValue);
+            } else {
+                BlockType Text;
+                Text.LoadFrom(pbCiphertext);
+
+                _XorWithKey(Text, _Nr);
                 _InverseShiftRow(Text);
                 _InverseByteSub(Text);
-            }
-            _XorWithKey(Text, 0);
+                for (size_t i = 1; i < _Nr; ++i) {
+                    _XorWithKey(Text, _Nr - i);
+                    _InverseMixColumn(Text);
+                    _InverseShiftRow(Text);
+                    _InverseByteSub(Text);
+                }
+                _XorWithKey(Text, 0);
 
-            Text.StoreTo(pbCiphertext);
+                Text.StoreTo(pbCiphertext);
+            }
             return BlockSizeValue;
         }
 
         void ClearKey() ACCEL_NOEXCEPT {
             _Key.SecureZero();
+            _InverseKey.SecureZero();
         }
 
         ~RIJNDAEL_ALG() ACCEL_NOEXCEPT {
             _Key.SecureZero();
+            _InverseKey.SecureZero();
         }
     };
 
     
 }
-
@@ -0,0 +1,281 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../Intrinsic.hpp"
+#include "../MemoryAccess.hpp"
+#include <utility>
+
+namespace accel::CipherTraits {
+
+    //
+    //  Rijndael with the 256-bit block on AES-NI; the same cipher as RIJNDAEL_ALG<__KeyBits, 256>.
+    //
+    //  The 32-byte state is kept in two halves, columns 0-3 and columns 4-7. AESENC does SubBytes, MixColumns and
+    //  AddRoundKey per column, so only ShiftRow differs: Rijndael-256 shifts its rows by 1, 3 and 4 across the whole
+    //  state while AESENC shifts them by 1, 2 and 3 within each half. Before every AESENC the halves are therefore
+    //  exchanged bytewise under a mask and permuted with PSHUFB, such that AESENC's own ShiftRows completes the wide one.
+    //  Decryption does the same for AESDEC with the inverse shift.
+    //
+    //  Every member that touches AES-NI is compiled with ACCEL_TARGET("aes,ssse3").
+    //  It is the caller's duty to check RuntimeCpuFeatures().AESNI and .SSSE3 first.
+    //
+    template<size_t __KeyBits>
+    class RIJNDAEL256_AESNI_ALG {
+        static_assert(__KeyBits == 128 || __KeyBits == 160 || __KeyBits == 192 ||  __KeyBits == 224 || __KeyBits == 256,
+                      "RIJNDAEL256_AESNI_ALG failure! Unsupported __KeyBits.");
+    public:
+        static constexpr size_t BlockSizeValue = 32;
+        static constexpr size_t KeySizeValue = __KeyBits / 8;
+    private:
+        static constexpr size_t _Nb = 8;
+        static constexpr size_t _Nk = __KeyBits / 32;
+        static constexpr size_t _Nr = (_Nb > _Nk ? _Nb : _Nk) + 6;
+
+        // round key i is _Key[i][0] for columns 0-3 and _Key[i][1] for columns 4-7
+        Array<__m128i, _Nr + 1, 2> _Key;
+        Array<__m128i, _Nr + 1, 2> _InvKey;
+
+        //
+        //  SubWord of `w` in constant time: AESKEYGENASSIST applies the S-box to its second dword and returns it in the first.
+        //  This function is for internal use only.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        static uint32_t _SubWord(uint32_t w) ACCEL_NOEXCEPT {
+            return static_cast<uint32_t>(
+                _mm_cvtsi128_si32(_mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, static_cast<int>(w), 0), 0))
+            );
+        }
+
+        //
+        //  The generic Rijndael key schedule for _Nb == 8, one word at a time.
+        //  This function is for internal use only.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        void _KeyExpansion(const void* pbUserKey) ACCEL_NOEXCEPT {
+            Array<uint32_t, _Nb * (_Nr + 1)> Words;
+            uint32_t Rcon = 0x01;
+
+            Words.LoadFrom(pbUserKey, KeySizeValue);
+
+            for (size_t i = _Nk; i < _Nb * (_Nr + 1); ++i) {
+                uint32_t temp = Words[i - 1];
+
+                if (i % _Nk == 0) {
+                    temp = _SubWord(RotateShiftRight<uint32_t>(temp, 8)) ^ Rcon;
+                    Rcon = (Rcon << 1) ^ (Rcon & 0x80 ? 0x11B : 0);
+                } else if (_Nk > 6 && i % _Nk == 4) {
+                    temp = _SubWord(temp);
+                }
+
+                Words[i] = Words[i - _Nk] ^ temp;
+            }
+
+            for (size_t i = 0; i <= _Nr; ++i) {
+                _Key[i][0] = MemoryReadAs<__m128i>(&Words[_Nb * i]);
+                _Key[i][1] = MemoryReadAs<__m128i>(&Words[_Nb * i + 4]);
+            }
+
+            Words.SecureZero();
+        }
+
+        //
+        //  Calculate `_InvKey`, the round keys of the equivalent inverse cipher, based on `_Key`.
+        //  This function is for internal use only.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        void _InverseKeyExpansion() ACCEL_NOEXCEPT {
+            _InvKey[0][0] = _Key[_Nr][0];
+            _InvKey[0][1] = _Key[_Nr][1];
+            for (size_t i = 1; i < _Nr; ++i) {
+                _InvKey[i][0] = _mm_aesimc_si128(_Key[_Nr - i][0]);
+                _InvKey[i][1] = _mm_aesimc_si128(_Key[_Nr - i][1]);
+            }
+            _InvKey[_Nr][0] = _Key[0][0];
+            _InvKey[_Nr][1] = _Key[0][1];
+        }
+
+        //
+        //  Move the bytes selected by `Blend` to the other half, then permute both halves with `Shuffle`.
+        //  This function is for internal use only.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        static void _Permute(__m128i& Low, __m128i& High, __m128i Blend, __m128i Shuffle) ACCEL_NOEXCEPT {
+            __m128i t = _mm_and_si128(_mm_xor_si128(Low, High), Blend);
+            Low = _mm_shuffle_epi8(_mm_xor_si128(Low, t), Shuffle);
+            High = _mm_shuffle_epi8(_mm_xor_si128(High, t), Shuffle);
+        }
+
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i _EncryptBlend() ACCEL_NOEXCEPT {
+            return _mm_setr_epi8(0, -1, -1, -1, 0, 0, -1, -1, 0, 0, -1, -1, 0, 0, 0, -1);
+        }
+
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i _EncryptShuffle() ACCEL_NOEXCEPT {
+            return _mm_setr_epi8(0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3);
+        }
+
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i _DecryptBlend() ACCEL_NOEXCEPT {
+            return _mm_setr_epi8(0, 0, 0, -1, 0, 0, -1, -1, 0, 0, -1, -1, 0, -1, -1, -1);
+        }
+
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        static __m128i _DecryptShuffle() ACCEL_NOEXCEPT {
+            return _mm_setr_epi8(0, 1, 14, 15, 4, 5, 2, 3, 8, 9, 6, 7, 12, 13, 10, 11);
+        }
+
+        //
+        //  As in AES_AESNI_ALG, every round key is pushed through all lanes before moving on to the next round key.
+        //  A lane is one 32-byte block, i.e. two AESENC per round.
+        //  This function is for internal use only.
+        //
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        void _EncryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            __m128i Low[sizeof...(__LaneIndexes)];
+            __m128i High[sizeof...(__LaneIndexes)];
+            __m128i Blend = _EncryptBlend();
+            __m128i Shuffle = _EncryptShuffle();
+
+            ((Low[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes), _Key[0][0])), ...);
+            ((High[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes + 1), _Key[0][1])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m128i RoundKeyLow = _Key[i][0];
+                __m128i RoundKeyHigh = _Key[i][1];
+                (_Permute(Low[__LaneIndexes], High[__LaneIndexes], Blend, Shuffle), ...);
+                ((Low[__LaneIndexes] = _mm_aesenc_si128(Low[__LaneIndexes], RoundKeyLow)), ...);
+                ((High[__LaneIndexes] = _mm_aesenc_si128(High[__LaneIndexes], RoundKeyHigh)), ...);
+            }
+            (_Permute(Low[__LaneIndexes], High[__LaneIndexes], Blend, Shuffle), ...);
+            ((Low[__LaneIndexes] = _mm_aesenclast_si128(Low[__LaneIndexes], _Key[_Nr][0])), ...);
+            ((High[__LaneIndexes] = _mm_aesenclast_si128(High[__LaneIndexes], _Key[_Nr][1])), ...);
+            (MemoryWriteAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes, Low[__LaneIndexes]), ...);
+            (MemoryWriteAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes + 1, High[__LaneIndexes]), ...);
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,ssse3")
+        void _DecryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            __m128i Low[sizeof...(__LaneIndexes)];
+            __m128i High[sizeof...(__LaneIndexes)];
+            __m128i Blend = _DecryptBlend();
+            __m128i Shuffle = _DecryptShuffle();
+
+            ((Low[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes), _InvKey[0][0])), ...);
+            ((High[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes + 1), _InvKey[0][1])), ...);
+            for (size_t i = 1; i < _Nr; ++i) {
+                __m128i RoundKeyLow = _InvKey[i][0];
+                __m128i RoundKeyHigh = _InvKey[i][1];
+                (_Permute(Low[__LaneIndexes], High[__LaneIndexes], Blend, Shuffle), ...);
+                ((Low[__LaneIndexes] = _mm_aesdec_si128(Low[__LaneIndexes], RoundKeyLow)), ...);
+                ((High[__LaneIndexes] = _mm_aesdec_si128(High[__LaneIndexes], RoundKeyHigh)), ...);
+            }
+            (_Permute(Low[__LaneIndexes], High[__LaneIndexes], Blend, Shuffle), ...);
+            ((Low[__LaneIndexes] = _mm_aesdeclast_si128(Low[__LaneIndexes], _InvKey[_Nr][0])), ...);
+            ((High[__LaneIndexes] = _mm_aesdeclast_si128(High[__LaneIndexes], _InvKey[_Nr][1])), ...);
+            (MemoryWriteAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes, Low[__LaneIndexes]), ...);
+            (MemoryWriteAs<__m128i>(pbBlocks, 16, 2 * __LaneIndexes + 1, High[__LaneIndexes]), ...);
+        }
+
+    public:
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t KeySize() const ACCEL_NOEXCEPT {
+            return KeySizeValue;
+        }
+
+        ACCEL_NODISCARD
+        ACCEL_TARGET("aes,ssse3")
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            if (cbUserKey != KeySizeValue) {
+                return false;
+            } else {
+                _KeyExpansion(pbUserKey);
+                _InverseKeyExpansion();
+                return true;
+            }
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        size_t EncryptBlock(void* pbPlaintext) const ACCEL_NOEXCEPT {
+            _EncryptLanes(pbPlaintext, std::make_index_sequence<1>{});
+            return BlockSizeValue;
+        }
+
+        ACCEL_TARGET("aes,ssse3")
+        size_t DecryptBlock(void* pbCiphertext) const ACCEL_NOEXCEPT {
+            _DecryptLanes(pbCiphertext, std::make_index_sequence<1>{});
+            return BlockSizeValue;
+        }
+
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion.
+        //  4 blocks, i.e. 8 AESENC, are kept in flight at a time; the tail is finished by a 2-block pass and then block by block.
+        //
+        ACCEL_TARGET("aes,ssse3")
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbPlaintext);
+            size_t i = 0;
+
+            for (; i + 4 <= BlockCount; i += 4)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<4>{});
+
+            if (i + 2 <= BlockCount) {
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<2>{});
+                i += 2;
+            }
+
+            for (; i < BlockCount; ++i)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion.
+        //
+        ACCEL_TARGET("aes,ssse3")
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbCiphertext);
+            size_t i = 0;
+
+            for (; i + 4 <= BlockCount; i += 4)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<4>{});
+
+            if (i + 2 <= BlockCount) {
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<2>{});
+                i += 2;
+            }
+
+            for (; i < BlockCount; ++i)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            return BlockCount * BlockSizeValue;
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _Key.SecureZero();
+            _InvKey.SecureZero();
+        }
+
+        ~RIJNDAEL256_AESNI_ALG() ACCEL_NOEXCEPT {
+            _Key.SecureZero();
+            _InvKey.SecureZero();
+        }
+    };
+
+}
@@ -2,7 +2,10 @@
 #include "../Config.hpp"
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
+#include "../CpuFeatures.hpp"
+#include "Internal/wordslice.hpp"
 #include <utility>
+#include <type_traits>
 #include <memory.h>
 
 namespace accel::CipherTraits {
@@ -16,21 +19,22 @@ namespace accel::CipherTraits {
         static constexpr size_t KeySizeValue = __KeyBits / 8;
     private:
         using BlockType = Array<uint32_t, 4>;
-        using VectorType = uint32_t[4];
 
         //
         // _SBoxTransform and _InverseSBoxTransform are based on
         // [Speeding up Serpent](http://www.ii.uib.no/~osvik/pub/aes3.pdf)
         //
+        // __WordType is uint32_t for one block, or Internal::WordsliceWord for 4 or 8 blocks at once.
+        //
 
-        template<size_t __Index>
+        template<size_t __Index, typename __WordType>
         ACCEL_FORCEINLINE
-        static void _SBoxTransform(VectorType& RefVector) ACCEL_NOEXCEPT {
-            uint32_t& r0 = RefVector[0];
-            uint32_t& r1 = RefVector[1];
-            uint32_t& r2 = RefVector[2];
-            uint32_t& r3 = RefVector[3];
-            uint32_t r4;
+        static void _SBoxTransform(__WordType (&RefVector)[4]) ACCEL_NOEXCEPT {
+            __WordType& r0 = RefVector[0];
+            __WordType& r1 = RefVector[1];
+            __WordType& r2 = RefVector[2];
+            __WordType& r3 = RefVector[3];
+            __WordType r4;
 
             if constexpr (__Index == 0) {
                 r3 ^= r0; r4 = r1;
@@ -64,17 +68,11 @@ namespace accel::CipherTraits {
 
                 // input:   r0, r1, r2, r3
                 // output:  r2, r0, r3, r1
-#if ACCEL_SSE2_AVAILABLE
-                __m128i temp = _mm_loadu_si128(reinterpret_cast<__m128i*>(RefVector));
-                temp = _mm_shuffle_epi32(temp, _MM_SHUFFLE(1, 3, 0, 2));
-                _mm_storeu_si128(reinterpret_cast<__m128i*>(RefVector), temp);
-#else
                 r4 = r0;
                 r0 = r2;
                 r2 = r3;
                 r3 = r1;
                 r1 = r4;
-#endif
             }
             
             if constexpr (__Index == 2) {
@@ -148,17 +146,11 @@ namespace accel::CipherTraits {
 
                 // input:   r0, r1, r2, r3
                 // output:  r1, r3, r0, r2
-#if ACCEL_SSE2_AVAILABLE
-                __m128i temp = _mm_loadu_si128(reinterpret_cast<__m128i*>(RefVector));
-                temp = _mm_shuffle_epi32(temp, _MM_SHUFFLE(2, 0, 3, 1));
-                _mm_storeu_si128(reinterpret_cast<__m128i*>(RefVector), temp);
-#else
                 r4 = r2;
                 r2 = r0;
                 r0 = r1;
                 r1 = r3;
                 r3 = r4;
-#endif
             }
 
             if constexpr (__Index == 6) {
@@ -203,14 +195,14 @@ namespace accel::CipherTraits {
             static_assert(__Index < 8);
         }
 
-        template<size_t __Index>
+        template<size_t __Index, typename __WordType>
         ACCEL_FORCEINLINE
-        static void _InverseSBoxTransform(VectorType& RefVector) ACCEL_NOEXCEPT {
-            uint32_t& r0 = RefVector[0];
-            uint32_t& r1 = RefVector[1];
-            uint32_t& r2 = RefVector[2];
-            uint32_t& r3 = RefVector[3];
-            uint32_t r4;
+        static void _InverseSBoxTransform(__WordType (&RefVector)[4]) ACCEL_NOEXCEPT {
+            __WordType& r0 = RefVector[0];
+            __WordType& r1 = RefVector[1];
+            __WordType& r2 = RefVector[2];
+            __WordType& r3 = RefVector[3];
+            __WordType r4;
 
             if constexpr (__Index == 0) {
                 r2 = ~r2; r4 = r1;
@@ -285,16 +277,10 @@ namespace accel::CipherTraits {
 
                 // input:   r0, r1, r2, r3
                 // output:  r2, r1, r3, r0
-#if ACCEL_SSE2_AVAILABLE
-                __m128i temp = _mm_loadu_si128(reinterpret_cast<__m128i*>(RefVector));
-                temp = _mm_shuffle_epi32(temp, _MM_SHUFFLE(0, 3, 1, 2));
-                _mm_storeu_si128(reinterpret_cast<__m128i*>(RefVector), temp);
-#else
                 r4 = r0;
                 r0 = r2;
                 r2 = r3;
                 r3 = r4;
-#endif
             }
 
             if constexpr (__Index == 4) {
@@ -379,32 +365,58 @@ namespace accel::CipherTraits {
 
         }
 
+        template<int __Shift>
+        ACCEL_FORCEINLINE
+        static uint32_t _RotateLeft(uint32_t x) ACCEL_NOEXCEPT {
+            return RotateShiftLeft<uint32_t>(x, __Shift);
+        }
+
+        template<int __Shift, typename __VectorPolicy>
         ACCEL_FORCEINLINE
-        static void _LinearTransform(VectorType& X) ACCEL_NOEXCEPT {
-            X[0] = RotateShiftLeft<uint32_t>(X[0], 13);
-            X[2] = RotateShiftLeft<uint32_t>(X[2], 3);
+        static Internal::WordsliceWord<__VectorPolicy> _RotateLeft(Internal::WordsliceWord<__VectorPolicy> x) ACCEL_NOEXCEPT {
+            return { __VectorPolicy::template RotateLeft32<__Shift>(x.Value) };
+        }
+
+        template<int __Shift>
+        ACCEL_FORCEINLINE
+        static uint32_t _ShiftLeft(uint32_t x) ACCEL_NOEXCEPT {
+            return x << __Shift;
+        }
+
+        template<int __Shift, typename __VectorPolicy>
+        ACCEL_FORCEINLINE
+        static Internal::WordsliceWord<__VectorPolicy> _ShiftLeft(Internal::WordsliceWord<__VectorPolicy> x) ACCEL_NOEXCEPT {
+            return { __VectorPolicy::template ShiftLeft32<__Shift>(x.Value) };
+        }
+
+        template<typename __WordType>
+        ACCEL_FORCEINLINE
+        static void _LinearTransform(__WordType (&X)[4]) ACCEL_NOEXCEPT {
+            X[0] = _RotateLeft<13>(X[0]);
+            X[2] = _RotateLeft<3>(X[2]);
             X[1] ^= X[0] ^ X[2];
-            X[3] ^= X[2] ^ (X[0] << 3);
-            X[1] = RotateShiftLeft<uint32_t>(X[1], 1);
-            X[3] = RotateShiftLeft<uint32_t>(X[3], 7);
+            X[3] ^= X[2] ^ _ShiftLeft<3>(X[0]);
+            X[1] = _RotateLeft<1>(X[1]);
+            X[3] = _RotateLeft<7>(X[3]);
             X[0] ^= X[1] ^ X[3];
-            X[2] ^= X[3] ^ (X[1] << 7);
-            X[0] = RotateShiftLeft<uint32_t>(X[0], 5);
-            X[2] = RotateShiftLeft<uint32_t>(X[2], 22);
+            X[2] ^= X[3] ^ _ShiftLeft<7>(X[1]);
+            X[0] = _RotateLeft<5>(X[0]);
+            X[2] = _RotateLeft<22>(X[2]);
         }
 
+        template<typename __WordType>
         ACCEL_FORCEINLINE
-        static void _InverseLinearTransform(VectorType& X) ACCEL_NOEXCEPT {
-            X[2] = RotateShiftRight<uint32_t>(X[2], 22);
-            X[0] = RotateShiftRight<uint32_t>(X[0], 5);
-            X[2] ^= X[3] ^ (X[1] << 7);
+        static void _InverseLinearTransform(__WordType (&X)[4]) ACCEL_NOEXCEPT {
+            X[2] = _RotateLeft<32 - 22>(X[2]);
+            X[0] = _RotateLeft<32 - 5>(X[0]);
+            X[2] ^= X[3] ^ _ShiftLeft<7>(X[1]);
             X[0] ^= X[1] ^ X[3];
-            X[3] = RotateShiftRight<uint32_t>(X[3], 7);
-            X[1] = RotateShiftRight<uint32_t>(X[1], 1);
-            X[3] ^= X[2] ^ (X[0] << 3);
+            X[3] = _RotateLeft<32 - 7>(X[3]);
+            X[1] = _RotateLeft<32 - 1>(X[1]);
+            X[3] ^= X[2] ^ _ShiftLeft<3>(X[0]);
             X[1] ^= X[0] ^ X[2];
-            X[2] = RotateShiftRight<uint32_t>(X[2], 3);
-            X[0] = RotateShiftRight<uint32_t>(X[0], 13);
+            X[2] = _RotateLeft<32 - 3>(X[2]);
+            X[0] = _RotateLeft<32 - 13>(X[0]);
         }
 
         ACCEL_FORCEINLINE
@@ -455,57 +467,143 @@ namespace accel::CipherTraits {
         
         template<size_t __Index>
         ACCEL_FORCEINLINE
-        void _XorWithKey(BlockType& RefBlock) const ACCEL_NOEXCEPT {
+        void _XorWithKey(uint32_t (&X)[4]) const ACCEL_NOEXCEPT {
 #if ACCEL_SSE2_AVAILABLE
-            __m128i temp = _mm_loadu_si128(RefBlock.template AsCArrayOf<__m128i[1]>());
+            __m128i temp = _mm_loadu_si128(reinterpret_cast<__m128i*>(X));
             temp = _mm_xor_si128(temp, _Key[__Index]);
-            _mm_storeu_si128(RefBlock.template AsCArrayOf<__m128i[1]>(), temp);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(X), temp);
 #else
-            RefBlock[0] ^= _Key[__Index][0];
-            RefBlock[1] ^= _Key[__Index][1];
-            RefBlock[2] ^= _Key[__Index][2];
-            RefBlock[3] ^= _Key[__Index][3];
+            X[0] ^= _Key[__Index][0];
+            X[1] ^= _Key[__Index][1];
+            X[2] ^= _Key[__Index][2];
+            X[3] ^= _Key[__Index][3];
 #endif
         }
 
-        template<size_t __Index>
+        //
+        //  Every word of the round key is broadcast to all lanes.
+        //
+        template<size_t __Index, typename __VectorPolicy>
         ACCEL_FORCEINLINE
-        void _R(BlockType& RefBlock) const ACCEL_NOEXCEPT {
+        void _XorWithKey(Internal::WordsliceWord<__VectorPolicy> (&X)[4]) const ACCEL_NOEXCEPT {
+            auto& RoundKey = _Key.template AsCArrayOf<uint32_t[33][4]>()[__Index];
+            X[0] ^= { __VectorPolicy::Set1(RoundKey[0]) };
+            X[1] ^= { __VectorPolicy::Set1(RoundKey[1]) };
+            X[2] ^= { __VectorPolicy::Set1(RoundKey[2]) };
+            X[3] ^= { __VectorPolicy::Set1(RoundKey[3]) };
+        }
+
+        template<size_t __Index, typename __WordType>
+        ACCEL_FORCEINLINE
+        void _R(__WordType (&X)[4]) const ACCEL_NOEXCEPT {
             if constexpr (__Index < 31) {
-                _XorWithKey<__Index>(RefBlock);
-                _SBoxTransform<__Index % 8>(RefBlock.AsCArray());
-                _LinearTransform(RefBlock.AsCArray());
+                _XorWithKey<__Index>(X);
+                _SBoxTransform<__Index % 8>(X);
+                _LinearTransform(X);
             } else if constexpr (__Index == 31) {
-                _XorWithKey<__Index>(RefBlock);
-                _SBoxTransform<__Index % 8>(RefBlock.AsCArray());
-                _XorWithKey<__Index + 1>(RefBlock);
+                _XorWithKey<__Index>(X);
+                _SBoxTransform<__Index % 8>(X);
+                _XorWithKey<__Index + 1>(X);
             }
         }
 
-        template<size_t __Index>
+        template<size_t __Index, typename __WordType>
         ACCEL_FORCEINLINE
-        void _InverseR(BlockType& RefBlock) const ACCEL_NOEXCEPT {
+        void _InverseR(__WordType (&X)[4]) const ACCEL_NOEXCEPT {
             if constexpr (__Index < 31) {
-                _InverseLinearTransform(RefBlock.AsCArray());
-                _InverseSBoxTransform<__Index % 8>(RefBlock.AsCArray());
-                _XorWithKey<__Index>(RefBlock);
+                _InverseLinearTransform(X);
+                _InverseSBoxTransform<__Index % 8>(X);
+                _XorWithKey<__Index>(X);
             } else if constexpr (__Index == 31) {
-                _XorWithKey<__Index + 1>(RefBlock);
-                _InverseSBoxTransform<__Index % 8>(RefBlock.AsCArray());
-                _XorWithKey<__Index>(RefBlock);
+                _XorWithKey<__Index + 1>(X);
+                _InverseSBoxTransform<__Index % 8>(X);
+                _XorWithKey<__Index>(X);
             }
         }
 
-        template<size_t... __Indexes>
+        template<typename __WordType, size_t... __Indexes>
         ACCEL_FORCEINLINE
-        void _EncryptProcess(BlockType& RefBlock, std::index_sequence<__Indexes...>) const ACCEL_NOEXCEPT {
-            (_R<__Indexes>(RefBlock), ...);
+        void _EncryptProcess(__WordType (&X)[4], std::index_sequence<__Indexes...>) const ACCEL_NOEXCEPT {
+            (_R<__Indexes>(X), ...);
         }
 
-        template<size_t... __Indexes>
+        template<typename __WordType, size_t... __Indexes>
         ACCEL_FORCEINLINE
-        void _DecryptProcess(BlockType& RefBlock, std::index_sequence<__Indexes...>) const ACCEL_NOEXCEPT {
-            (_InverseR<31 - __Indexes>(RefBlock), ...);
+        void _DecryptProcess(__WordType (&X)[4], std::index_sequence<__Indexes...>) const ACCEL_NOEXCEPT {
+            (_InverseR<31 - __Indexes>(X), ...);
+        }
+
+        //
+        //  Kernels for Internal::WordsliceVectorSSE2/AVX2: GroupCount groups of V::BlocksValue blocks,
+        //  each transposed so that the scalar formulas above run on all of its blocks at once.
+        //
+        struct _EncryptKernel {
+            template<typename __VectorPolicy>
+            ACCEL_FORCEINLINE
+            static void Run(const SERPENT_ALG& Alg, uint8_t*& pbBlocks, size_t& GroupCount) ACCEL_NOEXCEPT {
+                using V = __VectorPolicy;
+                typename V::VectorType x[4];
+
+                for (size_t g = 0; g < GroupCount; ++g, pbBlocks += V::BlocksValue * BlockSizeValue) {
+                    V::LoadBlocks(x, pbBlocks);
+                    Internal::WordsliceWord<V> w[4] = { { x[0] }, { x[1] }, { x[2] }, { x[3] } };
+                    Alg._EncryptProcess(w, std::make_index_sequence<32>{});
+                    x[0] = w[0].Value; x[1] = w[1].Value; x[2] = w[2].Value; x[3] = w[3].Value;
+                    V::StoreBlocks(pbBlocks, x);
+                }
+            }
+        };
+
+        struct _DecryptKernel {
+            template<typename __VectorPolicy>
+            ACCEL_FORCEINLINE
+            static void Run(const SERPENT_ALG& Alg, uint8_t*& pbBlocks, size_t& GroupCount) ACCEL_NOEXCEPT {
+                using V = __VectorPolicy;
+                typename V::VectorType x[4];
+
+                for (size_t g = 0; g < GroupCount; ++g, pbBlocks += V::BlocksValue * BlockSizeValue) {
+                    V::LoadBlocks(x, pbBlocks);
+                    Internal::WordsliceWord<V> w[4] = { { x[0] }, { x[1] }, { x[2] }, { x[3] } };
+                    Alg._DecryptProcess(w, std::make_index_sequence<32>{});
+                    x[0] = w[0].Value; x[1] = w[1].Value; x[2] = w[2].Value; x[3] = w[3].Value;
+                    V::StoreBlocks(pbBlocks, x);
+                }
+            }
+        };
+
+        //
+        //  8 blocks at a time on AVX2, then 4 at a time on SSE2, then the remaining blocks one by one.
+        //
+        template<typename __KernelType>
+        void _Process(void* pbData, size_t BlockCount) const ACCEL_NOEXCEPT {
+            constexpr size_t Narrow = Internal::WordsliceVectorSSE2::BlocksValue;
+            constexpr size_t Wide = Internal::WordsliceVectorAVX2::BlocksValue;
+            const CpuFeatureSet& Features = RuntimeCpuFeatures();
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbData);
+
+            if (BlockCount >= Wide && Features.AVX2) {
+                size_t GroupCount = BlockCount / Wide;
+                Internal::WordsliceVectorAVX2::template Invoke<__KernelType>(*this, pbBlocks, GroupCount);
+                BlockCount %= Wide;
+            }
+
+            if (BlockCount >= Narrow && Features.SSE2) {
+                size_t GroupCount = BlockCount / Narrow;
+                Internal::WordsliceVectorSSE2::template Invoke<__KernelType>(*this, pbBlocks, GroupCount);
+                BlockCount %= Narrow;
+            }
+
+            for (; BlockCount > 0; --BlockCount, pbBlocks += BlockSizeValue) {
+                BlockType Text;
+
+                Text.LoadFrom(pbBlocks);
+                if constexpr (std::is_same<__KernelType, _EncryptKernel>::value) {
+                    _EncryptProcess(Text.AsCArray(), std::make_index_sequence<32>{});
+                } else {
+                    _DecryptProcess(Text.AsCArray(), std::make_index_sequence<32>{});
+                }
+                Text.StoreTo(pbBlocks);
+            }
         }
 
 #if ACCEL_SSE2_AVAILABLE
@@ -538,7 +636,7 @@ namespace accel::CipherTraits {
             BlockType Text;
 
             Text.LoadFrom(pbPlaintext);
-            _EncryptProcess(Text, std::make_index_sequence<32>{});
+            _EncryptProcess(Text.AsCArray(), std::make_index_sequence<32>{});
             Text.StoreTo(pbPlaintext);
 
             return BlockSizeValue;
@@ -548,12 +646,28 @@ namespace accel::CipherTraits {
             BlockType Text;
 
             Text.LoadFrom(pbCiphertext);
-            _DecryptProcess(Text, std::make_index_sequence<32>{});
+            _DecryptProcess(Text.AsCArray(), std::make_index_sequence<32>{});
             Text.StoreTo(pbCiphertext);
 
             return BlockSizeValue;
         }
 
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion, word-sliced across 8 (AVX2) or 4 (SSE2) blocks.
+        //
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            _Process<_EncryptKernel>(pbPlaintext, BlockCount);
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion.
+        //
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            _Process<_DecryptKernel>(pbCiphertext, BlockCount);
+            return BlockCount * BlockSizeValue;
+        }
+
         void ClearKey() ACCEL_NOEXCEPT {
             _Key.SecureZero();
         }
@@ -3,10 +3,23 @@
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
 #include "Internal/twofish_constant.hpp"
+#include <utility>
 
 namespace accel::CipherTraits {
 
-    template<size_t __KeyBits>
+    //
+    //  How much of g() TWOFISH_ALG precomputes at SetKey, named after section 4.3 of the Twofish paper.
+    //
+    //      Full    the key-dependent S-boxes combined with the MDS matrix into four 256-entry tables, 4 KiB per key;
+    //              g() is then four lookups and three XORs.
+    //      Zero    only the S-box key words; g() runs the q0/q1 chain and the MDS multiplication every time.
+    //
+    enum class TwofishKeying {
+        Full,
+        Zero
+    };
+
+    template<size_t __KeyBits, TwofishKeying __Keying = TwofishKeying::Full>
     class TWOFISH_ALG : public Internal::TWOFISH_CONSTANT {
         static_assert(__KeyBits == 128 || __KeyBits == 192 || __KeyBits == 256,
                       "TWOFISH_ALG failure! Invalid __KeyBits.");
@@ -21,10 +34,15 @@ namespace accel::CipherTraits {
         Array<uint32_t, 40> _ExpandedKey;
         Array<uint8_t, __KeyBits / 16> _S;
 
+        // only used by TwofishKeying::Full: _SBoxTable[i][v] is column i of MDS times the i-th key-dependent S-box at v
+        Array<uint32_t, 4, __Keying == TwofishKeying::Full ? 256 : 1> _SBoxTable;
+
+        //
+        //  The key-dependent S-boxes without the MDS matrix, applied to the four bytes in place.
+        //
         template<typename __ByteType>
         ACCEL_FORCEINLINE
-        uint32_t _func_h(uint32_t X, const __ByteType& L) const ACCEL_NOEXCEPT {
-            auto& x = reinterpret_cast<uint8_t(&)[4]>(X);
+        static void _func_s(uint8_t (&x)[4], const __ByteType& L) ACCEL_NOEXCEPT {
             if constexpr (__KeyBits >= 256) {
                 x[0] = q1[x[0]] ^ L[12];
                 x[1] = q0[x[1]] ^ L[13];
@@ -43,20 +61,69 @@ namespace accel::CipherTraits {
                 x[2] = q1[q1[q0[x[2]] ^ L[6]] ^ L[2]];
                 x[3] = q0[q1[q1[x[3]] ^ L[7]] ^ L[3]];
             }
+        }
+
+        //
+        //  Column i of MDS times v, byte j of the result being row j.
+        //
+        ACCEL_FORCEINLINE
+        static uint32_t _MdsColumn(size_t i, uint8_t v) ACCEL_NOEXCEPT {
+            return
+                uint32_t{ GF2p8x169MulTable[MDS[0][i]][v] } |
+                uint32_t{ GF2p8x169MulTable[MDS[1][i]][v] } << 8 |
+                uint32_t{ GF2p8x169MulTable[MDS[2][i]][v] } << 16 |
+                uint32_t{ GF2p8x169MulTable[MDS[3][i]][v] } << 24;
+        }
 
-            union {
-                uint8_t bytes[4];
-                uint32_t dword;
-            } z;
-            z.dword = 0;
-            for (int i = 0; i < 4; ++i) {
-                z.bytes[i] ^= GF2p8x169MulTable[MDS[i][0]][x[0]];
-                z.bytes[i] ^= GF2p8x169MulTable[MDS[i][1]][x[1]];
-                z.bytes[i] ^= GF2p8x169MulTable[MDS[i][2]][x[2]];
-                z.bytes[i] ^= GF2p8x169MulTable[MDS[i][3]][x[3]];
+        template<typename __ByteType>
+        ACCEL_FORCEINLINE
+        static uint32_t _func_h(uint32_t X, const __ByteType& L) ACCEL_NOEXCEPT {
+            uint8_t x[4] = {
+                static_cast<uint8_t>(X),
+                static_cast<uint8_t>(X >> 8),
+                static_cast<uint8_t>(X >> 16),
+                static_cast<uint8_t>(X >> 24)
+            };
+
+            _func_s(x, L);
+
+            return _MdsColumn(0, x[0]) ^ _MdsColumn(1, x[1]) ^ _MdsColumn(2, x[2]) ^ _MdsColumn(3, x[3]);
+        }
+
+        //
+        //  g() of the round function, i.e. h() keyed with _S.
+        //
+        ACCEL_FORCEINLINE
+        uint32_t _func_g(uint32_t X) const ACCEL_NOEXCEPT {
+            if constexpr (__Keying == TwofishKeying::Full) {
+                return
+                    _SBoxTable[0][X & 0xff] ^
+                    _SBoxTable[1][(X >> 8) & 0xff] ^
+                    _SBoxTable[2][(X >> 16) & 0xff] ^
+                    _SBoxTable[3][X >> 24];
+            } else {
+                return _func_h(X, _S);
             }
+        }
 
-            return z.dword;
+        //
+        //  Fold the key-dependent S-boxes and MDS into _SBoxTable. The four bytes go through independent S-boxes,
+        //  so feeding v to all of them at once gives one entry of each table.
+        //
+        ACCEL_FORCEINLINE
+        void _SBoxTableExpansion() ACCEL_NOEXCEPT {
+            uint8_t x[4];
+
+            for (size_t v = 0; v < 256; ++v) {
+                x[0] = x[1] = x[2] = x[3] = static_cast<uint8_t>(v);
+                _func_s(x, _S);
+                _SBoxTable[0][v] = _MdsColumn(0, x[0]);
+                _SBoxTable[1][v] = _MdsColumn(1, x[1]);
+                _SBoxTable[2][v] = _MdsColumn(2, x[2]);
+                _SBoxTable[3][v] = _MdsColumn(3, x[3]);
+            }
+
+            SecureWipe(x, sizeof(x));
         }
 
         ACCEL_FORCEINLINE
@@ -97,33 +164,45 @@ namespace accel::CipherTraits {
 
             M_e.SecureZero();
             M_o.SecureZero();
+
+            if constexpr (__Keying == TwofishKeying::Full) {
+                _SBoxTableExpansion();
+            }
         }
 
         ACCEL_FORCEINLINE
-        void _EncryptProcess(BlockType& RefBlock) const ACCEL_NOEXCEPT {
-            RefBlock[0] ^= _ExpandedKey[0];
-            RefBlock[1] ^= _ExpandedKey[1];
-            RefBlock[2] ^= _ExpandedKey[2];
-            RefBlock[3] ^= _ExpandedKey[3];
-
-            for (int i = 0; i < 15; ++i) {
-                uint32_t T0 = _func_h(RefBlock[0], _S);
-                uint32_t T1 = RotateShiftLeft<uint32_t>(RefBlock[1], 8);
-                T1 = _func_h(T1, _S);
-                uint32_t F0 = T0 + T1 + _ExpandedKey[2 * i + 8];
-                uint32_t F1 = T0 + T1 * 2 + _ExpandedKey[2 * i + 9];
-
-                F0 ^= RefBlock[2];
-                F1 ^= RotateShiftLeft<uint32_t>(RefBlock[3], 1);
-                RefBlock[2] = RefBlock[0];
-                RefBlock[3] = RefBlock[1];
-                RefBlock[0] = RotateShiftRight<uint32_t>(F0, 1);
-                RefBlock[1] = F1;
-            }
+        void _Whitening(BlockType& RefBlock, size_t Index) const ACCEL_NOEXCEPT {
+            RefBlock[0] ^= _ExpandedKey[Index];
+            RefBlock[1] ^= _ExpandedKey[Index + 1];
+            RefBlock[2] ^= _ExpandedKey[Index + 2];
+            RefBlock[3] ^= _ExpandedKey[Index + 3];
+        }
+
+        //
+        //  Round i of encryption, including the swap of the halves.
+        //
+        ACCEL_FORCEINLINE
+        void _EncryptRound(BlockType& RefBlock, size_t i) const ACCEL_NOEXCEPT {
+            uint32_t T0 = _func_g(RefBlock[0]);
+            uint32_t T1 = _func_g(RotateShiftLeft<uint32_t>(RefBlock[1], 8));
+            uint32_t F0 = T0 + T1 + _ExpandedKey[2 * i + 8];
+            uint32_t F1 = T0 + T1 * 2 + _ExpandedKey[2 * i + 9];
 
-            uint32_t T0 = _func_h(RefBlock[0], _S);
-            uint32_t T1 = RotateShiftLeft<uint32_t>(RefBlock[1], 8);
-            T1 = _func_h(T1, _S);
+            F0 ^= RefBlock[2];
+            F1 ^= RotateShiftLeft<uint32_t>(RefBlock[3], 1);
+            RefBlock[2] = RefBlock[0];
+            RefBlock[3] = RefBlock[1];
+            RefBlock[0] = RotateShiftRight<uint32_t>(F0, 1);
+            RefBlock[1] = F1;
+        }
+
+        //
+        //  The last round of encryption, which leaves the halves unswapped.
+        //
+        ACCEL_FORCEINLINE
+        void _EncryptLastRound(BlockType& RefBlock) const ACCEL_NOEXCEPT {
+            uint32_t T0 = _func_g(RefBlock[0]);
+            uint32_t T1 = _func_g(RotateShiftLeft<uint32_t>(RefBlock[1], 8));
             uint32_t F0 = T0 + T1 + _ExpandedKey[38];
             uint32_t F1 = T0 + T1 * 2u + _ExpandedKey[39];
 
@@ -131,48 +210,67 @@ namespace accel::CipherTraits {
             F1 ^= RotateShiftLeft<uint32_t>(RefBlock[3], 1);
             RefBlock[2] = RotateShiftRight<uint32_t>(F0, 1);
             RefBlock[3] = F1;
-
-            RefBlock[0] ^= _ExpandedKey[4];
-            RefBlock[1] ^= _ExpandedKey[5];
-            RefBlock[2] ^= _ExpandedKey[6];
-            RefBlock[3] ^= _ExpandedKey[7];
         }
 
         ACCEL_FORCEINLINE
-        void _DecryptProcess(BlockType& RefBlock) const ACCEL_NOEXCEPT {
-            RefBlock[0] ^= _ExpandedKey[4];
-            RefBlock[1] ^= _ExpandedKey[5];
-            RefBlock[2] ^= _ExpandedKey[6];
-            RefBlock[3] ^= _ExpandedKey[7];
-
-            uint32_t T0 = _func_h(RefBlock[0], _S);
-            uint32_t T1 = RotateShiftLeft<uint32_t>(RefBlock[1], 8);
-            T1 = _func_h(T1, _S);
+        void _DecryptFirstRound(BlockType& RefBlock) const ACCEL_NOEXCEPT {
+            uint32_t T0 = _func_g(RefBlock[0]);
+            uint32_t T1 = _func_g(RotateShiftLeft<uint32_t>(RefBlock[1], 8));
             uint32_t F0 = T0 + T1 + _ExpandedKey[38];
             uint32_t F1 = T0 + T1 * 2 + _ExpandedKey[39];
 
             RefBlock[2] = RotateShiftLeft<uint32_t>(RefBlock[2], 1) ^ F0;
             F1 ^= RefBlock[3];
             RefBlock[3] = RotateShiftRight<uint32_t>(F1, 1);
+        }
 
-            for (int i = 14; i >= 0; --i) {
-                T0 = _func_h(RefBlock[2], _S);
-                T1 = _func_h(RotateShiftLeft<uint32_t>(RefBlock[3], 8), _S);
-                F0 = T0 + T1 + _ExpandedKey[2 * i + 8];
-                F1 = T0 + T1 * 2 + _ExpandedKey[2 * i + 9];
-
-                F0 ^= RotateShiftLeft<uint32_t>(RefBlock[0], 1);
-                F1 ^= RefBlock[1];
-                RefBlock[0] = RefBlock[2];
-                RefBlock[1] = RefBlock[3];
-                RefBlock[3] = RotateShiftRight<uint32_t>(F1, 1);
-                RefBlock[2] = F0;
-            }
+        ACCEL_FORCEINLINE
+        void _DecryptRound(BlockType& RefBlock, size_t i) const ACCEL_NOEXCEPT {
+            uint32_t T0 = _func_g(RefBlock[2]);
+            uint32_t T1 = _func_g(RotateShiftLeft<uint32_t>(RefBlock[3], 8));
+            uint32_t F0 = T0 + T1 + _ExpandedKey[2 * i + 8];
+            uint32_t F1 = T0 + T1 * 2 + _ExpandedKey[2 * i + 9];
+
+            F0 ^= RotateShiftLeft<uint32_t>(RefBlock[0], 1);
+            F1 ^= RefBlock[1];
+            RefBlock[0] = RefBlock[2];
+            RefBlock[1] = RefBlock[3];
+            RefBlock[3] = RotateShiftRight<uint32_t>(F1, 1);
+            RefBlock[2] = F0;
+        }
+
+        //
+        //  A round is a chain of dependent lookups and additions, so a single block leaves most execution units idle.
+        //  Lanes run each round on independent blocks back to back; one lane is the single-block path.
+        //
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        void _EncryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            BlockType Lanes[sizeof...(__LaneIndexes)];
+            auto pbBytes = reinterpret_cast<uint8_t*>(pbBlocks);
+
+            (Lanes[__LaneIndexes].LoadFrom(pbBytes + __LaneIndexes * BlockSizeValue), ...);
+            (_Whitening(Lanes[__LaneIndexes], 0), ...);
+            for (size_t i = 0; i < 15; ++i)
+                (_EncryptRound(Lanes[__LaneIndexes], i), ...);
+            (_EncryptLastRound(Lanes[__LaneIndexes]), ...);
+            (_Whitening(Lanes[__LaneIndexes], 4), ...);
+            (Lanes[__LaneIndexes].StoreTo(pbBytes + __LaneIndexes * BlockSizeValue), ...);
+        }
 
-            RefBlock[0] ^= _ExpandedKey[0];
-            RefBlock[1] ^= _ExpandedKey[1];
-            RefBlock[2] ^= _ExpandedKey[2];
-            RefBlock[3] ^= _ExpandedKey[3];
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        void _DecryptLanes(void* pbBlocks, std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            BlockType Lanes[sizeof...(__LaneIndexes)];
+            auto pbBytes = reinterpret_cast<uint8_t*>(pbBlocks);
+
+            (Lanes[__LaneIndexes].LoadFrom(pbBytes + __LaneIndexes * BlockSizeValue), ...);
+            (_Whitening(Lanes[__LaneIndexes], 4), ...);
+            (_DecryptFirstRound(Lanes[__LaneIndexes]), ...);
+            for (size_t i = 15; i-- > 0;)
+                (_DecryptRound(Lanes[__LaneIndexes], i), ...);
+            (_Whitening(Lanes[__LaneIndexes], 0), ...);
+            (Lanes[__LaneIndexes].StoreTo(pbBytes + __LaneIndexes * BlockSizeValue), ...);
         }
 
     public:
@@ -196,33 +294,57 @@ namespace accel::CipherTraits {
         }
 
         size_t EncryptBlock(void* pbPlaintext) const ACCEL_NOEXCEPT {
-            BlockType Text;
-
-            Text.LoadFrom(pbPlaintext);
-            _EncryptProcess(Text);
-            Text.StoreTo(pbPlaintext);
-
+            _EncryptLanes(pbPlaintext, std::make_index_sequence<1>{});
             return BlockSizeValue;
         }
 
         size_t DecryptBlock(void* pbCiphertext) const ACCEL_NOEXCEPT {
-            BlockType Text;
-            
-            Text.LoadFrom(pbCiphertext);
-            _DecryptProcess(Text);
-            Text.StoreTo(pbCiphertext);
-
+            _DecryptLanes(pbCiphertext, std::make_index_sequence<1>{});
             return BlockSizeValue;
         }
 
+        //
+        //  Encrypt `BlockCount` consecutive blocks in ECB fashion, 4 blocks interleaved at a time.
+        //
+        size_t EncryptBlocks(void* pbPlaintext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbPlaintext);
+            size_t i = 0;
+
+            for (; i + 4 <= BlockCount; i += 4)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<4>{});
+
+            for (; i < BlockCount; ++i)
+                _EncryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            return BlockCount * BlockSizeValue;
+        }
+
+        //
+        //  Decrypt `BlockCount` consecutive blocks in ECB fashion, 4 blocks interleaved at a time.
+        //
+        size_t DecryptBlocks(void* pbCiphertext, size_t BlockCount) const ACCEL_NOEXCEPT {
+            auto pbBlocks = reinterpret_cast<uint8_t*>(pbCiphertext);
+            size_t i = 0;
+
+            for (; i + 4 <= BlockCount; i += 4)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<4>{});
+
+            for (; i < BlockCount; ++i)
+                _DecryptLanes(pbBlocks + i * BlockSizeValue, std::make_index_sequence<1>{});
+
+            return BlockCount * BlockSizeValue;
+        }
+
         void ClearKey() ACCEL_NOEXCEPT {
             _ExpandedKey.SecureZero();
             _S.SecureZero();
+            _SBoxTable.SecureZero();
         }
 
         ~TWOFISH_ALG() ACCEL_NOEXCEPT {
             _ExpandedKey.SecureZero();
             _S.SecureZero();
+            _SBoxTable.SecureZero();
         }
     };
 
@@ -3,6 +3,8 @@
 #if defined(_MSC_VER)
     #define ACCEL_FORCEINLINE __forceinline
     #define ACCEL_UNREACHABLE() __assume(0)
+    #define ACCEL_TARGET(features)
+    #define ACCEL_FLATTEN
 
     #define ACCEL_SSE2_AVAILABLE (_M_IX86_FP >= 2 || _M_AMD64)
     #define ACCEL_SSE3_AVAILABLE ACCEL_SSE2_AVAILABLE
@@ -10,9 +12,14 @@
     #define ACCEL_AESNI_AVAILABLE ACCEL_SSE2_AVAILABLE
     #define ACCEL_AVX_AVAILABLE __AVX__
     #define ACCEL_AVX2_AVAILABLE __AVX2__
+    #define ACCEL_AVX512_AVAILABLE __AVX512F__
+    #define ACCEL_VAES_AVAILABLE 0    // AVX-512F does not imply VAES; the runtime probe decides
+    #define ACCEL_SHA_AVAILABLE 0     // MSVC has no macro for it; the runtime probe decides
 #elif defined(__GNUC__)
     #define ACCEL_FORCEINLINE __attribute__((always_inline)) inline
     #define ACCEL_UNREACHABLE() __builtin_unreachable()
+    #define ACCEL_TARGET(features) __attribute__((target(features)))
+    #define ACCEL_FLATTEN __attribute__((flatten))
 
     #define ACCEL_SSE2_AVAILABLE __SSE2__
     #define ACCEL_SSE3_AVAILABLE __SSE3__
@@ -20,6 +27,9 @@
     #define ACCEL_AESNI_AVAILABLE __AES__
     #define ACCEL_AVX_AVAILABLE __AVX__
     #define ACCEL_AVX2_AVAILABLE __AVX2__
+    #define ACCEL_AVX512_AVAILABLE __AVX512F__
+    #define ACCEL_VAES_AVAILABLE __VAES__
+    #define ACCEL_SHA_AVAILABLE __SHA__
 #else
 #error "Unknown compiler"
 #endif
@@ -65,6 +75,24 @@ namespace accel {
     constexpr bool CpuFeatureAVX2Available = false;
 #endif
 
+#if ACCEL_AVX512_AVAILABLE
+    constexpr bool CpuFeatureAVX512Available = true;
+#else
+    constexpr bool CpuFeatureAVX512Available = false;
+#endif
+
+#if ACCEL_VAES_AVAILABLE
+    constexpr bool CpuFeatureVAESAvailable = true;
+#else
+    constexpr bool CpuFeatureVAESAvailable = false;
+#endif
+
+#if ACCEL_SHA_AVAILABLE
+    constexpr bool CpuFeatureSHAAvailable = true;
+#else
+    constexpr bool CpuFeatureSHAAvailable = false;
+#endif
+
     // +----------------------------------------+
     // |    Definitions for endianness          |
     // +----------------------------------------+
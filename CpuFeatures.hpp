@@ -0,0 +1,128 @@
+#pragma once
+#include "Config.hpp"
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__)
+#include <cpuid.h>
+#else
+#error "Unknown compiler"
+#endif
+
+namespace accel {
+
+    //
+    //  The ACCEL_*_AVAILABLE macros in Config.hpp only tell what the compiler is allowed to emit everywhere.
+    //  CpuFeatureSet tells what the host we are running on actually supports,
+    //  so that one binary can take the fastest path on new hosts and still fall back safely on old ones.
+    //
+    struct CpuFeatureSet {
+        bool SSE2;
+        bool SSE3;
+        bool SSSE3;
+        bool SSE41;
+        bool PCLMULQDQ;
+        bool AESNI;
+        bool AVX;
+        bool AVX2;
+        bool SHA;
+        bool AVX512F;
+        bool AVX512BW;
+        bool AVX512VL;
+        bool VAES;
+        bool VPCLMULQDQ;
+        bool GFNI;
+    };
+
+    namespace Internal {
+
+        ACCEL_FORCEINLINE
+        void CpuId(uint32_t Leaf, uint32_t SubLeaf, uint32_t (&Registers)[4]) ACCEL_NOEXCEPT {
+#if defined(_MSC_VER)
+            int Values[4];
+            __cpuidex(Values, static_cast<int>(Leaf), static_cast<int>(SubLeaf));
+            for (size_t i = 0; i < 4; ++i)
+                Registers[i] = static_cast<uint32_t>(Values[i]);
+#else
+            __cpuid_count(Leaf, SubLeaf, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif
+        }
+
+        //
+        //  Only valid when CPUID reports OSXSAVE.
+        //
+        ACCEL_FORCEINLINE
+        uint64_t ReadXCR0() ACCEL_NOEXCEPT {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t eax, edx;
+            asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+        }
+
+        inline CpuFeatureSet ProbeCpuFeatures() ACCEL_NOEXCEPT {
+            CpuFeatureSet Features = {};
+            uint32_t Regs[4];
+
+            CpuId(0, 0, Regs);
+            uint32_t MaxLeaf = Regs[0];
+            if (MaxLeaf < 1)
+                return Features;
+
+            CpuId(1, 0, Regs);
+            uint32_t Leaf1Ecx = Regs[2];
+            uint32_t Leaf1Edx = Regs[3];
+
+            Features.SSE2 = (Leaf1Edx >> 26) & 1;
+            Features.SSE3 = (Leaf1Ecx >> 0) & 1;
+            Features.PCLMULQDQ = (Leaf1Ecx >> 1) & 1;
+            Features.SSSE3 = (Leaf1Ecx >> 9) & 1;
+            Features.SSE41 = (Leaf1Ecx >> 19) & 1;
+            Features.AESNI = (Leaf1Ecx >> 25) & 1;
+
+            //
+            //  AVX and AVX-512 also need the OS to save the corresponding register state on context switches.
+            //
+            bool OsSavesYmm = false;
+            bool OsSavesZmm = false;
+            if ((Leaf1Ecx >> 27) & 1) {     // OSXSAVE
+                uint64_t XCR0 = ReadXCR0();
+                OsSavesYmm = (XCR0 & 0x06) == 0x06;
+                OsSavesZmm = (XCR0 & 0xE6) == 0xE6;
+            }
+
+            Features.AVX = OsSavesYmm && ((Leaf1Ecx >> 28) & 1);
+
+            if (MaxLeaf >= 7) {
+                CpuId(7, 0, Regs);
+                uint32_t Leaf7Ebx = Regs[1];
+                uint32_t Leaf7Ecx = Regs[2];
+
+                Features.AVX2 = Features.AVX && ((Leaf7Ebx >> 5) & 1);
+                Features.SHA = (Leaf7Ebx >> 29) & 1;
+                Features.AVX512F = OsSavesZmm && ((Leaf7Ebx >> 16) & 1);
+                Features.AVX512BW = Features.AVX512F && ((Leaf7Ebx >> 30) & 1);
+                Features.AVX512VL = Features.AVX512F && ((Leaf7Ebx >> 31) & 1);
+                Features.VAES = Features.AVX && ((Leaf7Ecx >> 9) & 1);
+                Features.VPCLMULQDQ = Features.AVX && ((Leaf7Ecx >> 10) & 1);
+                Features.GFNI = (Leaf7Ecx >> 8) & 1;
+            }
+
+            return Features;
+        }
+
+    }
+
+    //
+    //  CPUID is executed once, the first time anybody asks; the result is shared by the whole process.
+    //
+    inline const CpuFeatureSet& RuntimeCpuFeatures() ACCEL_NOEXCEPT {
+        static const CpuFeatureSet Features = Internal::ProbeCpuFeatures();
+        return Features;
+    }
+
+}
+
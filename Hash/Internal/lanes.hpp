@@ -0,0 +1,561 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../../Intrinsic.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace accel::Hash::Internal {
+
+    //
+    //  32-bit lane vectors for the multi-buffer hashes: lane i of every vector belongs to message i.
+    //  A kernel is written once against this interface and each policy runs it through `Invoke`,
+    //  which is compiled with the policy's ACCEL_TARGET and flattens the whole kernel into itself.
+    //  The operations are not force-inlined on purpose: GCC refuses to force-inline a target-attributed function
+    //  into the kernel's generic templates, whereas flattening inlines everything once it sits inside `Invoke`.
+    //  So no `-mavx2` is needed; check RuntimeCpuFeatures() before picking a policy.
+    //
+    //  `LoadMessage` reads one 64-byte block from each lane's pointer and transposes it,
+    //  so that W[j] holds word j of every lane's block.
+    //
+
+    struct LaneVectorSSE2 {
+        using VectorType = __m128i;
+        static constexpr size_t LanesValue = 4;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("sse2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Compress<LaneVectorSSE2>(Args...);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Load(const void* p) ACCEL_NOEXCEPT {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        ACCEL_TARGET("sse2")
+        static void Store(void* p, __m128i a) ACCEL_NOEXCEPT {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Set1(uint32_t x) ACCEL_NOEXCEPT {
+            return _mm_set1_epi32(static_cast<int>(x));
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Add(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_add_epi32(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i And(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_and_si128(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Or(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_or_si128(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Xor(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(a, b);
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Xor3(__m128i a, __m128i b, __m128i c) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(_mm_xor_si128(a, b), c);
+        }
+
+        //
+        //  a | ~b
+        //
+        ACCEL_TARGET("sse2")
+        static __m128i OrNot(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            return _mm_or_si128(a, _mm_xor_si128(b, _mm_set1_epi32(-1)));
+        }
+
+        //
+        //  (a & b) | (~a & c), i.e. a ? b : c bit by bit
+        //
+        ACCEL_TARGET("sse2")
+        static __m128i Choose(__m128i a, __m128i b, __m128i c) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(c, _mm_and_si128(a, _mm_xor_si128(b, c)));
+        }
+
+        ACCEL_TARGET("sse2")
+        static __m128i Majority(__m128i a, __m128i b, __m128i c) ACCEL_NOEXCEPT {
+            return _mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(c, _mm_or_si128(a, b)));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("sse2")
+        static __m128i RotateLeft(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_or_si128(_mm_slli_epi32(a, __Shift), _mm_srli_epi32(a, 32 - __Shift));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("sse2")
+        static __m128i RotateRight(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_or_si128(_mm_srli_epi32(a, __Shift), _mm_slli_epi32(a, 32 - __Shift));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("sse2")
+        static __m128i ShiftRight(__m128i a) ACCEL_NOEXCEPT {
+            return _mm_srli_epi32(a, __Shift);
+        }
+
+        //
+        //  SSE2 has no byte shuffle: swap the bytes of every 16-bit word, then the 16-bit halves of every 32-bit word.
+        //
+        template<bool __BigEndian>
+        ACCEL_TARGET("sse2")
+        static void LoadMessage(__m128i (&W)[16], const uint8_t* const (&Blocks)[LanesValue]) ACCEL_NOEXCEPT {
+            for (size_t Quarter = 0; Quarter < 4; ++Quarter) {
+                __m128i r[4], t[4];
+
+                for (size_t i = 0; i < 4; ++i) {
+                    r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Blocks[i] + 16 * Quarter));
+                    if constexpr (__BigEndian) {
+                        r[i] = _mm_or_si128(_mm_slli_epi16(r[i], 8), _mm_srli_epi16(r[i], 8));
+                        r[i] = _mm_shufflehi_epi16(_mm_shufflelo_epi16(r[i], 0xB1), 0xB1);
+                    }
+                }
+
+                t[0] = _mm_unpacklo_epi32(r[0], r[1]);
+                t[1] = _mm_unpackhi_epi32(r[0], r[1]);
+                t[2] = _mm_unpacklo_epi32(r[2], r[3]);
+                t[3] = _mm_unpackhi_epi32(r[2], r[3]);
+
+                W[4 * Quarter + 0] = _mm_unpacklo_epi64(t[0], t[2]);
+                W[4 * Quarter + 1] = _mm_unpackhi_epi64(t[0], t[2]);
+                W[4 * Quarter + 2] = _mm_unpacklo_epi64(t[1], t[3]);
+                W[4 * Quarter + 3] = _mm_unpackhi_epi64(t[1], t[3]);
+            }
+        }
+    };
+
+    struct LaneVectorAVX2 {
+        using VectorType = __m256i;
+        static constexpr size_t LanesValue = 8;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("avx2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Compress<LaneVectorAVX2>(Args...);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Load(const void* p) ACCEL_NOEXCEPT {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ACCEL_TARGET("avx2")
+        static void Store(void* p, __m256i a) ACCEL_NOEXCEPT {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Set1(uint32_t x) ACCEL_NOEXCEPT {
+            return _mm256_set1_epi32(static_cast<int>(x));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Add(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_add_epi32(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i And(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_and_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Or(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Xor(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Xor3(__m256i a, __m256i b, __m256i c) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+        }
+
+        //
+        //  a | ~b
+        //
+        ACCEL_TARGET("avx2")
+        static __m256i OrNot(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(a, _mm256_xor_si256(b, _mm256_set1_epi32(-1)));
+        }
+
+        //
+        //  (a & b) | (~a & c), i.e. a ? b : c bit by bit
+        //
+        ACCEL_TARGET("avx2")
+        static __m256i Choose(__m256i a, __m256i b, __m256i c) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(c, _mm256_and_si256(a, _mm256_xor_si256(b, c)));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Majority(__m256i a, __m256i b, __m256i c) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i RotateLeft(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(_mm256_slli_epi32(a, __Shift), _mm256_srli_epi32(a, 32 - __Shift));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i RotateRight(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(_mm256_srli_epi32(a, __Shift), _mm256_slli_epi32(a, 32 - __Shift));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i ShiftRight(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_srli_epi32(a, __Shift);
+        }
+
+        template<bool __BigEndian>
+        ACCEL_TARGET("avx2")
+        static void LoadMessage(__m256i (&W)[16], const uint8_t* const (&Blocks)[LanesValue]) ACCEL_NOEXCEPT {
+            for (size_t Half = 0; Half < 2; ++Half) {
+                __m256i r[8], t[8], u[8];
+
+                for (size_t i = 0; i < 8; ++i) {
+                    r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Blocks[i] + 32 * Half));
+                    if constexpr (__BigEndian) {
+                        r[i] = _mm256_shuffle_epi8(r[i], _mm256_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll,
+                                                                           0x0c0d0e0f08090a0bll, 0x0405060700010203ll));
+                    }
+                }
+
+                for (size_t i = 0; i < 8; i += 2) {
+                    t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+                    t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+                }
+
+                for (size_t i = 0; i < 8; i += 4) {
+                    u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+                    u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+                    u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+                    u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+                }
+
+                for (size_t j = 0; j < 4; ++j) {
+                    W[8 * Half + j] = _mm256_permute2x128_si256(u[j], u[j + 4], 0x20);
+                    W[8 * Half + j + 4] = _mm256_permute2x128_si256(u[j], u[j + 4], 0x31);
+                }
+            }
+        }
+    };
+
+    struct LaneVectorAVX512 {
+        using VectorType = __m512i;
+        static constexpr size_t LanesValue = 16;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("avx512f,avx512bw")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Compress<LaneVectorAVX512>(Args...);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Load(const void* p) ACCEL_NOEXCEPT {
+            return _mm512_loadu_si512(p);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static void Store(void* p, __m512i a) ACCEL_NOEXCEPT {
+            _mm512_storeu_si512(p, a);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Set1(uint32_t x) ACCEL_NOEXCEPT {
+            return _mm512_set1_epi32(static_cast<int>(x));
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Add(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_add_epi32(a, b);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i And(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_and_si512(a, b);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Or(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_or_si512(a, b);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Xor(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_xor_si512(a, b);
+        }
+
+        //
+        //  The boolean functions below are single VPTERNLOGD instructions.
+        //  The immediate is the truth table, indexed by (a << 2) | (b << 1) | c.
+        //
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Xor3(__m512i a, __m512i b, __m512i c) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi32(a, b, c, 0x96);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i OrNot(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi32(a, b, b, 0xF3);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Choose(__m512i a, __m512i b, __m512i c) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi32(a, b, c, 0xCA);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Majority(__m512i a, __m512i b, __m512i c) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi32(a, b, c, 0xE8);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i RotateLeft(__m512i a) ACCEL_NOEXCEPT {
+            return _mm512_rol_epi32(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i RotateRight(__m512i a) ACCEL_NOEXCEPT {
+            return _mm512_ror_epi32(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i ShiftRight(__m512i a) ACCEL_NOEXCEPT {
+            return _mm512_srli_epi32(a, __Shift);
+        }
+
+        //
+        //  16x16 transpose of 32-bit words in four shuffle stages:
+        //  words within 128-bit slots (unpack epi32, then epi64), then the 128-bit slots themselves (two rounds of shuffle_i32x4).
+        //
+        template<bool __BigEndian>
+        ACCEL_TARGET("avx512f,avx512bw")
+        static void LoadMessage(__m512i (&W)[16], const uint8_t* const (&Blocks)[LanesValue]) ACCEL_NOEXCEPT {
+            __m512i r[16], t[16];
+
+            for (size_t i = 0; i < 16; ++i) {
+                r[i] = _mm512_loadu_si512(Blocks[i]);
+                if constexpr (__BigEndian) {
+                    r[i] = _mm512_shuffle_epi8(r[i], _mm512_set_epi64(0x0c0d0e0f08090a0bll, 0x0405060700010203ll,
+                                                                      0x0c0d0e0f08090a0bll, 0x0405060700010203ll,
+                                                                      0x0c0d0e0f08090a0bll, 0x0405060700010203ll,
+                                                                      0x0c0d0e0f08090a0bll, 0x0405060700010203ll));
+                }
+            }
+
+            for (size_t i = 0; i < 16; i += 2) {
+                t[i] = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+                t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+            }
+
+            //
+            //  r[4 * q + j], 128-bit slot k = word 4 * k + j of lanes 4 * q ... 4 * q + 3
+            //
+            for (size_t q = 0; q < 16; q += 4) {
+                r[q] = _mm512_unpacklo_epi64(t[q], t[q + 2]);
+                r[q + 1] = _mm512_unpackhi_epi64(t[q], t[q + 2]);
+                r[q + 2] = _mm512_unpacklo_epi64(t[q + 1], t[q + 3]);
+                r[q + 3] = _mm512_unpackhi_epi64(t[q + 1], t[q + 3]);
+            }
+
+            for (size_t j = 0; j < 4; ++j) {
+                __m512i LowLo = _mm512_shuffle_i32x4(r[j], r[j + 4], 0x44);
+                __m512i LowHi = _mm512_shuffle_i32x4(r[j], r[j + 4], 0xEE);
+                __m512i HighLo = _mm512_shuffle_i32x4(r[j + 8], r[j + 12], 0x44);
+                __m512i HighHi = _mm512_shuffle_i32x4(r[j + 8], r[j + 12], 0xEE);
+
+                W[j] = _mm512_shuffle_i32x4(LowLo, HighLo, 0x88);
+                W[j + 4] = _mm512_shuffle_i32x4(LowLo, HighLo, 0xDD);
+                W[j + 8] = _mm512_shuffle_i32x4(LowHi, HighHi, 0x88);
+                W[j + 12] = _mm512_shuffle_i32x4(LowHi, HighHi, 0xDD);
+            }
+        }
+    };
+
+
+    //
+    //  64-bit lane vectors, for the SHA-512 kernel of PBKDF2: the same interface as above, minus LoadMessage,
+    //  with `Set1` taking a 64-bit word. There is no SSE2 policy: two lanes do not beat the scalar SHA512_ALG.
+    //
+
+    struct LaneVector64AVX2 {
+        using VectorType = __m256i;
+        static constexpr size_t LanesValue = 4;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("avx2")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Compress<LaneVector64AVX2>(Args...);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Load(const void* p) ACCEL_NOEXCEPT {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        ACCEL_TARGET("avx2")
+        static void Store(void* p, __m256i a) ACCEL_NOEXCEPT {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Set1(uint64_t x) ACCEL_NOEXCEPT {
+            return _mm256_set1_epi64x(static_cast<long long>(x));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Add(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_add_epi64(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i And(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_and_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Or(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Xor(__m256i a, __m256i b) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(a, b);
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Xor3(__m256i a, __m256i b, __m256i c) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+        }
+
+        //
+        //  (a & b) | (~a & c), i.e. a ? b : c bit by bit
+        //
+        ACCEL_TARGET("avx2")
+        static __m256i Choose(__m256i a, __m256i b, __m256i c) ACCEL_NOEXCEPT {
+            return _mm256_xor_si256(c, _mm256_and_si256(a, _mm256_xor_si256(b, c)));
+        }
+
+        ACCEL_TARGET("avx2")
+        static __m256i Majority(__m256i a, __m256i b, __m256i c) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i RotateRight(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_or_si256(_mm256_srli_epi64(a, __Shift), _mm256_slli_epi64(a, 64 - __Shift));
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx2")
+        static __m256i ShiftRight(__m256i a) ACCEL_NOEXCEPT {
+            return _mm256_srli_epi64(a, __Shift);
+        }
+    };
+
+    struct LaneVector64AVX512 {
+        using VectorType = __m512i;
+        static constexpr size_t LanesValue = 8;
+
+        template<typename __KernelType, typename... __ArgTypes>
+        ACCEL_FLATTEN
+        ACCEL_TARGET("avx512f,avx512bw")
+        static void Invoke(__ArgTypes&... Args) ACCEL_NOEXCEPT {
+            __KernelType::template Compress<LaneVector64AVX512>(Args...);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Load(const void* p) ACCEL_NOEXCEPT {
+            return _mm512_loadu_si512(p);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static void Store(void* p, __m512i a) ACCEL_NOEXCEPT {
+            _mm512_storeu_si512(p, a);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Set1(uint64_t x) ACCEL_NOEXCEPT {
+            return _mm512_set1_epi64(static_cast<long long>(x));
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Add(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_add_epi64(a, b);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i And(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_and_si512(a, b);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Or(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_or_si512(a, b);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Xor(__m512i a, __m512i b) ACCEL_NOEXCEPT {
+            return _mm512_xor_si512(a, b);
+        }
+
+        //
+        //  VPTERNLOGQ, with the truth tables of LaneVectorAVX512.
+        //
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Xor3(__m512i a, __m512i b, __m512i c) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi64(a, b, c, 0x96);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Choose(__m512i a, __m512i b, __m512i c) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi64(a, b, c, 0xCA);
+        }
+
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i Majority(__m512i a, __m512i b, __m512i c) ACCEL_NOEXCEPT {
+            return _mm512_ternarylogic_epi64(a, b, c, 0xE8);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i RotateRight(__m512i a) ACCEL_NOEXCEPT {
+            return _mm512_ror_epi64(a, __Shift);
+        }
+
+        template<int __Shift>
+        ACCEL_TARGET("avx512f,avx512bw")
+        static __m512i ShiftRight(__m512i a) ACCEL_NOEXCEPT {
+            return _mm512_srli_epi64(a, __Shift);
+        }
+    };
+
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../../Intrinsic.hpp"
+#include "../../MemoryAccess.hpp"
+#include "../../SecureWiper.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+
+namespace accel::Hash {
+
+    //
+    //  One independent message for the batch hashers (SHA256_BATCH, ...).
+    //  The digest is written to `pbDigest`, which must have room for the hasher's DigestSizeValue bytes.
+    //
+    struct HashMessage {
+        const void* pbData;
+        size_t cbData;
+        void* pbDigest;
+    };
+
+}
+
+namespace accel::Hash::Internal {
+
+    //
+    //  Hashes `MessageCount` messages in lock-step, one message per lane of __LaneVectorType.
+    //  Whole blocks are read straight from the caller's buffers; only the padded tail of each message is staged.
+    //  Whenever a lane finishes its message, the next message takes the lane, so short and long messages can be mixed.
+    //  Once the queue is empty and at most a quarter of the lanes are still busy, those are finished one by one
+    //  with the single-stream kernel, which is faster than a mostly idle vector.
+    //
+    //  __KernelType describes the hash (MD-style padding with a 64-bit length, 64-byte blocks, 32-bit words):
+    //      StateWordsValue, DigestSizeValue, BigEndianValue, InitialStateValue[StateWordsValue],
+    //      template<typename __LaneVectorType> Compress(State, Blocks)     -- one block on every lane, always-inline
+    //      CompressSingle(uint32_t (&State)[StateWordsValue], const void* pData, size_t Rounds)
+    //
+    template<typename __KernelType, typename __LaneVectorType>
+    class MultiBufferScheduler {
+    private:
+        static constexpr size_t _Lanes = __LaneVectorType::LanesValue;
+        static constexpr size_t _StateWords = __KernelType::StateWordsValue;
+        static constexpr size_t _BlockSize = 64;
+
+        struct _LaneSlot {
+            const HashMessage* Message;         // nullptr if the lane is idle
+            const uint8_t* pbNext;              // the next block to compress, in the message or in Tail
+            size_t BlocksLeft;                  // blocks left at pbNext
+            bool InTail;
+            uint8_t Tail[2 * _BlockSize];
+        };
+
+        alignas(64) uint32_t _State[_StateWords][_Lanes];
+        _LaneSlot _Slots[_Lanes];
+
+        static inline const uint8_t _IdleBlock[_BlockSize] = {};
+
+        //
+        //  Pad the last partial block of the lane's message (0x80, zeros, 64-bit bit length) into Tail.
+        //
+        void _EnterTail(_LaneSlot& Slot) ACCEL_NOEXCEPT {
+            size_t cbFull = Slot.Message->cbData / _BlockSize * _BlockSize;
+            size_t cbTail = Slot.Message->cbData - cbFull;
+            size_t TailBlocks = cbTail < _BlockSize - sizeof(uint64_t) ? 1 : 2;
+            uint64_t BitLength = static_cast<uint64_t>(Slot.Message->cbData) * 8;
+
+            memset(Slot.Tail, 0, sizeof(Slot.Tail));
+            memcpy(Slot.Tail, reinterpret_cast<const uint8_t*>(Slot.Message->pbData) + cbFull, cbTail);
+            Slot.Tail[cbTail] = 0x80;
+            MemoryWriteAs<uint64_t>(Slot.Tail + TailBlocks * _BlockSize - sizeof(uint64_t),
+                                    __KernelType::BigEndianValue ? ByteSwap(BitLength) : BitLength);
+
+            Slot.pbNext = Slot.Tail;
+            Slot.BlocksLeft = TailBlocks;
+            Slot.InTail = true;
+        }
+
+        void _Start(size_t Lane, const HashMessage* Message) ACCEL_NOEXCEPT {
+            _LaneSlot& Slot = _Slots[Lane];
+
+            for (size_t i = 0; i < _StateWords; ++i)
+                _State[i][Lane] = __KernelType::InitialStateValue[i];
+
+            Slot.Message = Message;
+            Slot.pbNext = reinterpret_cast<const uint8_t*>(Message->pbData);
+            Slot.BlocksLeft = Message->cbData / _BlockSize;
+            Slot.InTail = false;
+
+            if (Slot.BlocksLeft == 0)
+                _EnterTail(Slot);
+        }
+
+        static void _Output(const HashMessage* Message, const uint32_t (&State)[_StateWords]) ACCEL_NOEXCEPT {
+            uint32_t Digest[_StateWords];
+
+            for (size_t i = 0; i < _StateWords; ++i)
+                Digest[i] = __KernelType::BigEndianValue ? ByteSwap(State[i]) : State[i];
+
+            memcpy(Message->pbDigest, Digest, __KernelType::DigestSizeValue);
+            SecureWipe(Digest, sizeof(Digest));
+        }
+
+        void _FinishSingle(_LaneSlot& Slot, size_t Lane) ACCEL_NOEXCEPT {
+            uint32_t State[_StateWords];
+
+            for (size_t i = 0; i < _StateWords; ++i)
+                State[i] = _State[i][Lane];
+
+            __KernelType::CompressSingle(State, Slot.pbNext, Slot.BlocksLeft);
+            if (Slot.InTail == false) {
+                _EnterTail(Slot);
+                __KernelType::CompressSingle(State, Slot.pbNext, Slot.BlocksLeft);
+            }
+
+            _Output(Slot.Message, State);
+            SecureWipe(State, sizeof(State));
+            Slot.Message = nullptr;
+        }
+
+    public:
+
+        MultiBufferScheduler() ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < _Lanes; ++i)
+                _Slots[i].Message = nullptr;
+        }
+
+        void Run(const HashMessage* Messages, size_t MessageCount) ACCEL_NOEXCEPT {
+            const uint8_t* Blocks[_Lanes];
+            size_t NextMessage = 0;
+
+            for (;;) {
+                size_t Busy = 0;
+                size_t Step = SIZE_MAX;
+
+                for (size_t i = 0; i < _Lanes; ++i) {
+                    if (_Slots[i].Message == nullptr && NextMessage < MessageCount)
+                        _Start(i, &Messages[NextMessage++]);
+
+                    if (_Slots[i].Message) {
+                        ++Busy;
+                        Step = _Slots[i].BlocksLeft < Step ? _Slots[i].BlocksLeft : Step;
+                    }
+                }
+
+                if (Busy == 0)
+                    break;
+
+                if (NextMessage == MessageCount && Busy * 4 <= _Lanes) {
+                    for (size_t i = 0; i < _Lanes; ++i) {
+                        if (_Slots[i].Message)
+                            _FinishSingle(_Slots[i], i);
+                    }
+                    break;
+                }
+
+                //
+                //  Every busy lane has at least `Step` contiguous blocks left; idle lanes hash a dummy block.
+                //
+                for (size_t k = 0; k < Step; ++k) {
+                    for (size_t i = 0; i < _Lanes; ++i)
+                        Blocks[i] = _Slots[i].Message ? _Slots[i].pbNext + k * _BlockSize : _IdleBlock;
+
+                    __LaneVectorType::template Invoke<__KernelType>(_State, Blocks);
+                }
+
+                for (size_t i = 0; i < _Lanes; ++i) {
+                    _LaneSlot& Slot = _Slots[i];
+
+                    if (Slot.Message == nullptr)
+                        continue;
+
+                    Slot.pbNext += Step * _BlockSize;
+                    Slot.BlocksLeft -= Step;
+
+                    if (Slot.BlocksLeft == 0) {
+                        if (Slot.InTail) {
+                            uint32_t State[_StateWords];
+
+                            for (size_t j = 0; j < _StateWords; ++j)
+                                State[j] = _State[j][i];
+
+                            _Output(Slot.Message, State);
+                            SecureWipe(State, sizeof(State));
+                            Slot.Message = nullptr;
+                        } else {
+                            _EnterTail(Slot);
+                        }
+                    }
+                }
+            }
+        }
+
+        ~MultiBufferScheduler() ACCEL_NOEXCEPT {
+            SecureWipe(_State, sizeof(_State));
+            SecureWipe(_Slots, sizeof(_Slots));
+        }
+    };
+
+}
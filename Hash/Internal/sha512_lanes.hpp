@@ -0,0 +1,80 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../sha512.hpp"
+#include "lanes.hpp"
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    //
+    //  SHA-512 on 64-bit lane vectors, laid out like SHA256_LANES: 80 unrolled rounds that name a..h by index,
+    //  and a 16-word schedule ring. PBKDF2 is its only user, so there is no Compress for raw message blocks.
+    //
+    struct SHA512_LANES {
+        using WordType = uint64_t;
+        static constexpr size_t StateWordsValue = 8;
+        static constexpr size_t BlockSizeValue = SHA512_ALG::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = SHA512_ALG::DigestSizeValue;
+        static constexpr bool BigEndianValue = true;
+
+        template<typename __LaneVectorType, size_t __Round>
+        ACCEL_FORCEINLINE
+        static void _Round(typename __LaneVectorType::VectorType (&S)[8], typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            constexpr size_t a = (8 - __Round % 8) % 8;
+            constexpr size_t b = (a + 1) % 8;
+            constexpr size_t c = (a + 2) % 8;
+            constexpr size_t d = (a + 3) % 8;
+            constexpr size_t e = (a + 4) % 8;
+            constexpr size_t f = (a + 5) % 8;
+            constexpr size_t g = (a + 6) % 8;
+            constexpr size_t h = (a + 7) % 8;
+
+            if constexpr (__Round >= 16) {
+                auto& W2 = W[(__Round + 14) % 16];
+                auto& W15 = W[(__Round + 1) % 16];
+                auto s0 = V::Xor3(V::template RotateRight<1>(W15), V::template RotateRight<8>(W15), V::template ShiftRight<7>(W15));
+                auto s1 = V::Xor3(V::template RotateRight<19>(W2), V::template RotateRight<61>(W2), V::template ShiftRight<6>(W2));
+                W[__Round % 16] = V::Add(V::Add(W[__Round % 16], s0), V::Add(W[(__Round + 9) % 16], s1));
+            }
+
+            auto T1 = V::Add(V::Add(S[h], V::Xor3(V::template RotateRight<14>(S[e]), V::template RotateRight<18>(S[e]), V::template RotateRight<41>(S[e]))),
+                             V::Add(V::Choose(S[e], S[f], S[g]), V::Add(V::Set1(SHA512_ALG::_K[__Round]), W[__Round % 16])));
+            auto T2 = V::Add(V::Xor3(V::template RotateRight<28>(S[a]), V::template RotateRight<34>(S[a]), V::template RotateRight<39>(S[a])),
+                             V::Majority(S[a], S[b], S[c]));
+
+            S[d] = V::Add(S[d], T1);
+            S[h] = V::Add(T1, T2);
+        }
+
+        template<typename __LaneVectorType, size_t... __Rounds>
+        ACCEL_FORCEINLINE
+        static void _Rounds(typename __LaneVectorType::VectorType (&S)[8], typename __LaneVectorType::VectorType (&W)[16], std::index_sequence<__Rounds...>) ACCEL_NOEXCEPT {
+            (_Round<__LaneVectorType, __Rounds>(S, W), ...);
+        }
+
+        //
+        //  One block on every lane, with the state and the message words already in vectors.
+        //  W is used as the schedule ring and is clobbered.
+        //
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void CompressWords(typename __LaneVectorType::VectorType (&State)[8], typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType S[8];
+
+            for (size_t i = 0; i < 8; ++i)
+                S[i] = State[i];
+
+            _Rounds<V>(S, W, std::make_index_sequence<80>{});
+
+            for (size_t i = 0; i < 8; ++i)
+                State[i] = V::Add(State[i], S[i]);
+        }
+
+        static void CompressSingle(uint64_t (&State)[8], const void* pData, size_t Rounds) ACCEL_NOEXCEPT {
+            SHA512_ALG::_Compress(State, pData, Rounds);
+        }
+    };
+
+}
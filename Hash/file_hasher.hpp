@@ -0,0 +1,176 @@
+#pragma once
+#include "../Config.hpp"
+#include "hasher.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <new>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace accel::Hash {
+
+    //
+    //  Hashes whole files with one of the hash algorithms (POSIX only).
+    //
+    //  A regular file is mapped with mmap and fed to UnkeyedHasher in windows of WindowSizeValue bytes, which go
+    //  straight to the algorithm's Cycle: no read() calls and no copies. The mapping is advised MADV_SEQUENTIAL,
+    //  the window ahead MADV_WILLNEED while the current one is hashed, and a hashed window MADV_DONTNEED so that
+    //  the resident set stays small.
+    //  If the file cannot be mapped, or is not a regular file (a pipe, a terminal, ...), it is read instead,
+    //  ReadSizeValue bytes at a time, with pread where the file is seekable.
+    //
+    //  A mapped file that is truncated while it is hashed raises SIGBUS, as with any mmap reader.
+    //
+    template<typename __AlgType>
+    class FileHasher {
+    public:
+        static constexpr size_t DigestSizeValue = __AlgType::DigestSizeValue;
+        static constexpr size_t WindowSizeValue = 32 * 1024 * 1024;
+        static constexpr size_t ReadSizeValue = 1024 * 1024;
+
+        static_assert(WindowSizeValue % 65536 == 0 && WindowSizeValue % __AlgType::BlockSizeValue == 0,
+                      "FileHasher failure! A window must be whole pages and whole blocks.");
+        static_assert(ReadSizeValue % __AlgType::BlockSizeValue == 0, "FileHasher failure! A read must be whole blocks.");
+    private:
+
+        //
+        //  Hash bytes [Start, FileSize) of the file. The mapping begins at the page boundary at or below `Start`,
+        //  so windows stay page-aligned for madvise and the bytes before `Start` are skipped in the first one.
+        //  Returns false if the file cannot be mapped; nothing has been hashed then.
+        //
+        static bool _HashMapped(int FileDescriptor, off_t Start, size_t FileSize, UnkeyedHasher<__AlgType>& Hasher) ACCEL_NOEXCEPT {
+            long PageSize = sysconf(_SC_PAGESIZE);
+            if (PageSize <= 0) {
+                return false;
+            }
+
+            off_t MappingStart = Start - Start % PageSize;
+            size_t cbSkipped = static_cast<size_t>(Start - MappingStart);
+            size_t cbMapping = FileSize - static_cast<size_t>(MappingStart);
+
+            void* pMapping = mmap(nullptr, cbMapping, PROT_READ, MAP_PRIVATE, FileDescriptor, MappingStart);
+            if (pMapping == MAP_FAILED) {
+                return false;
+            }
+
+            auto pbFile = reinterpret_cast<const uint8_t*>(pMapping);
+
+            (void)madvise(pMapping, cbMapping, MADV_SEQUENTIAL);
+            (void)madvise(pMapping, cbMapping < WindowSizeValue ? cbMapping : WindowSizeValue, MADV_WILLNEED);
+
+            for (size_t Offset = 0; Offset < cbMapping; Offset += WindowSizeValue) {
+                size_t cbWindow = cbMapping - Offset < WindowSizeValue ? cbMapping - Offset : WindowSizeValue;
+
+                if (cbMapping - Offset > WindowSizeValue) {
+                    size_t cbNext = cbMapping - Offset - WindowSizeValue;
+                    (void)madvise(const_cast<uint8_t*>(pbFile) + Offset + WindowSizeValue,
+                                  cbNext < WindowSizeValue ? cbNext : WindowSizeValue,
+                                  MADV_WILLNEED);
+                }
+
+                if (Offset == 0) {
+                    Hasher.Update(pbFile + cbSkipped, cbWindow - cbSkipped);
+                } else {
+                    Hasher.Update(pbFile + Offset, cbWindow);
+                }
+                (void)madvise(const_cast<uint8_t*>(pbFile) + Offset, cbWindow, MADV_DONTNEED);
+            }
+
+            munmap(pMapping, cbMapping);
+            return true;
+        }
+
+        //
+        //  `Start` is where pread begins if the file is seekable; read() goes on from the current position anyway.
+        //
+        static bool _HashRead(int FileDescriptor, bool Seekable, off_t Start, UnkeyedHasher<__AlgType>& Hasher) ACCEL_NOEXCEPT {
+            std::unique_ptr<uint8_t[]> Buffer(new (std::nothrow) uint8_t[ReadSizeValue]);
+            if (Buffer == nullptr) {
+                errno = ENOMEM;
+                return false;
+            }
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+            if (Seekable)
+                (void)posix_fadvise(FileDescriptor, Start, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+            for (off_t Offset = Start;;) {
+                ssize_t cbRead = Seekable ? pread(FileDescriptor, Buffer.get(), ReadSizeValue, Offset) :
+                                            read(FileDescriptor, Buffer.get(), ReadSizeValue);
+                if (cbRead < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                } else if (cbRead == 0) {
+                    return true;
+                } else {
+                    Hasher.Update(Buffer.get(), static_cast<size_t>(cbRead));
+                    Offset += cbRead;
+                }
+            }
+        }
+
+    public:
+
+        //
+        //  Hash everything from the current position of an open file to its end, as md5sum and sha256sum do,
+        //  and write DigestSizeValue bytes to `pbDigest`. A regular file is mapped or read with pread from that
+        //  position, which is left where it was.
+        //  Returns false, with errno set, on an I/O error.
+        //
+        ACCEL_NODISCARD
+        static bool HashDescriptor(int FileDescriptor, void* pbDigest) ACCEL_NOEXCEPT {
+            UnkeyedHasher<__AlgType> Hasher;
+            struct stat FileStat;
+
+            if (fstat(FileDescriptor, &FileStat) != 0) {
+                return false;
+            }
+
+            bool Regular = S_ISREG(FileStat.st_mode);
+            bool Hashed = false;
+            off_t Start = Regular ? lseek(FileDescriptor, 0, SEEK_CUR) : 0;
+
+            if (Start < 0) {
+                return false;
+            }
+
+            // Files that report size 0 (empty ones, but also /proc and sysfs files) are read.
+            if (Regular && FileStat.st_size > Start && static_cast<uint64_t>(FileStat.st_size) <= SIZE_MAX) {
+                Hashed = _HashMapped(FileDescriptor, Start, static_cast<size_t>(FileStat.st_size), Hasher);
+            }
+
+            if (Hashed == false && _HashRead(FileDescriptor, Regular, Start, Hasher) == false) {
+                return false;
+            }
+
+            Hasher.DigestTo(pbDigest);
+            return true;
+        }
+
+        //
+        //  The same for a file given by path.
+        //
+        ACCEL_NODISCARD
+        static bool HashPath(const char* Path, void* pbDigest) ACCEL_NOEXCEPT {
+            int FileDescriptor = open(Path, O_RDONLY);
+            if (FileDescriptor < 0) {
+                return false;
+            }
+
+            bool Succeeded = HashDescriptor(FileDescriptor, pbDigest);
+            int SavedErrno = errno;
+
+            close(FileDescriptor);
+            errno = SavedErrno;
+            return Succeeded;
+        }
+    };
+
+}
+
@@ -1,67 +1,227 @@
 #pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../MemoryAccess.hpp"
+#include "../SecureWiper.hpp"
+#include <stddef.h>
 #include <stdint.h>
-#include "../Common/Array.hpp"
 #include <memory.h>
 
 namespace accel::Hash {
 
+    //
+    //  Streaming front end for the hash algorithms (MD5_ALG, SHA256_ALG, ...).
+    //  Whole blocks are compressed straight from the caller's buffer; only a block that straddles two Update calls
+    //  is staged, so an Update copies at most one block however long its input is.
+    //  Digest and DigestTo finish a copy of the state, so more data may follow. Reset starts a new message.
+    //
+    //  ExportState/ImportState carry an unfinished message across objects, processes or restarts,
+    //  e.g. to hash a shared prefix once and resume it with many suffixes. The serialized state is, little-endian
+    //  whatever the host byte order:
+    //      offset  0   uint32  magic, the bytes "ACHS"
+    //      offset  4   uint16  format version, StateFormatVersionValue
+    //      offset  6   uint16  __AlgType::StateSizeValue
+    //      offset  8   uint16  BlockSizeValue
+    //      offset 10   uint16  DigestSizeValue
+    //      offset 12   uint32  number of buffered bytes, less than BlockSizeValue
+    //      offset 16   uint64  number of bytes fed so far
+    //      offset 24           chaining state from __AlgType::ExportState, __AlgType::StateSizeValue bytes
+    //                          as words of __AlgType::StateWordSizeValue bytes each
+    //      then                the buffered bytes, zero-padded to BlockSizeValue
+    //  The sizes guard against importing into the wrong algorithm, but do not tell apart algorithms that share them
+    //  (SHA256 and SM3, for instance).
+    //
     template<typename __AlgType>
     class UnkeyedHasher {
+    public:
+        static constexpr size_t BlockSizeValue = __AlgType::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = __AlgType::DigestSizeValue;
+        static constexpr uint16_t StateFormatVersionValue = 1;
+        static constexpr size_t SerializedStateSizeValue = 24 + __AlgType::StateSizeValue + BlockSizeValue;
     private:
+        static constexpr uint32_t _StateFormatMagic = 0x53484341u;     // "ACHS"
+
         __AlgType _AlgInstance;
         uint64_t _ProcessedBytes;
-        SecureByteArray<__AlgType::BlockSize> _StreamBuffer;
+        Array<uint8_t, BlockSizeValue> _StreamBuffer;
         size_t _StreamLength;
+
+        template<typename __IntegerType>
+        static void _StoreLittleEndian(uint8_t* pb, __IntegerType x) noexcept {
+            if constexpr (NativeEndianness == Endianness::BigEndian) {
+                x = ByteSwap<__IntegerType>(x);
+            }
+            MemoryWriteAs<__IntegerType>(pb, x);
+        }
+
+        template<typename __IntegerType>
+        static __IntegerType _LoadLittleEndian(const uint8_t* pb) noexcept {
+            __IntegerType x = MemoryReadAs<__IntegerType>(pb);
+            if constexpr (NativeEndianness == Endianness::BigEndian) {
+                x = ByteSwap<__IntegerType>(x);
+            }
+            return x;
+        }
+
+        //
+        //  __AlgType::ExportState/ImportState use host byte order; swapping each word converts either way.
+        //
+        static void _SwapStateWords(uint8_t* pbChainingState) noexcept {
+            if constexpr (NativeEndianness == Endianness::BigEndian && __AlgType::StateWordSizeValue == 4) {
+                for (size_t i = 0; i < __AlgType::StateSizeValue; i += 4) {
+                    MemoryWriteAs<uint32_t>(pbChainingState + i, ByteSwap(MemoryReadAs<uint32_t>(pbChainingState + i)));
+                }
+            } else if constexpr (NativeEndianness == Endianness::BigEndian && __AlgType::StateWordSizeValue == 8) {
+                for (size_t i = 0; i < __AlgType::StateSizeValue; i += 8) {
+                    MemoryWriteAs<uint64_t>(pbChainingState + i, ByteSwap(MemoryReadAs<uint64_t>(pbChainingState + i)));
+                }
+            } else {
+                static_assert(__AlgType::StateWordSizeValue == 1 || __AlgType::StateWordSizeValue == 4 || __AlgType::StateWordSizeValue == 8,
+                              "UnkeyedHasher failure! Unsupported state word size.");
+                (void)pbChainingState;
+            }
+        }
+
+        __AlgType _Fork() const noexcept {
+            __AlgType ForkedAlgInstance = _AlgInstance;
+            ForkedAlgInstance.Finish(_StreamBuffer.AsCArray(), _StreamLength, _ProcessedBytes);
+            return ForkedAlgInstance;
+        }
+
     public:
-        static constexpr size_t BlockSize = __AlgType::BlockSize;
-        static constexpr size_t DigestSize = __AlgType::DigestSize;
 
         UnkeyedHasher() noexcept : _ProcessedBytes(0), _StreamLength(0) {}
 
+        //
+        //  Go on from `Midstate`, which has compressed `PrefixBytes` bytes already, a multiple of BlockSizeValue.
+        //  HMAC streams its inner hash this way, from the state after the key XOR ipad block.
+        //
+        UnkeyedHasher(const __AlgType& Midstate, uint64_t PrefixBytes) noexcept :
+            _AlgInstance(Midstate), _ProcessedBytes(PrefixBytes), _StreamLength(0) {}
+
+        constexpr size_t BlockSize() const noexcept {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t DigestSize() const noexcept {
+            return DigestSizeValue;
+        }
+
+        //
+        //  Forget everything fed so far and start a new message.
+        //
+        void Reset() noexcept {
+            _AlgInstance = __AlgType{};
+            _ProcessedBytes = 0;
+            _StreamBuffer.SecureZero();
+            _StreamLength = 0;
+        }
+
         void Update(const void* pData, size_t DataSize) noexcept {
-            if (DataSize + _StreamLength < BlockSize) {
-                memcpy(_StreamBuffer.GetPtr() + _StreamLength, pData, DataSize);
-                _StreamLength += DataSize;
-                _ProcessedBytes += DataSize;
-            } else {
-                auto pBytes = reinterpret_cast<const uint8_t*>(pData);
-                size_t DataReadPtr = 0;
-
-                {
-                    size_t BytesToCopy = BlockSize - _StreamLength;
-                    memcpy(_StreamBuffer.GetPtr() + _StreamLength, pBytes, BytesToCopy);
-                    _AlgInstance.Cycle(_StreamBuffer.GetPtr(), 1);
-                    _StreamLength = 0;
-                    DataReadPtr += BytesToCopy;
-                    DataSize -= BytesToCopy;
-                }
+            auto pBytes = reinterpret_cast<const uint8_t*>(pData);
 
-                {
-                    size_t Rounds = DataSize / BlockSize;
-                    if (Rounds) {
-                        _AlgInstance.Cycle(pBytes + DataReadPtr, Rounds);
-                        DataReadPtr += Rounds * BlockSize;
-                        DataSize -= Rounds * BlockSize;
-                    }
-                }
+            _ProcessedBytes += DataSize;
 
-                {
-                    if (DataSize) {
-                        memcpy(_StreamBuffer.GetPtr(), pBytes + DataReadPtr, DataSize);
-                        _StreamLength += DataSize;
-                        DataReadPtr += DataSize;
-                        DataSize = 0;
-                    }
+            if (_StreamLength) {
+                size_t BytesToCopy = BlockSizeValue - _StreamLength;
+
+                if (DataSize < BytesToCopy) {
+                    memcpy(_StreamBuffer.AsCArray() + _StreamLength, pBytes, DataSize);
+                    _StreamLength += DataSize;
+                    return;
                 }
 
-                _ProcessedBytes += DataReadPtr;
+                memcpy(_StreamBuffer.AsCArray() + _StreamLength, pBytes, BytesToCopy);
+                _AlgInstance.Cycle(_StreamBuffer.AsCArray(), 1);
+                _StreamLength = 0;
+                pBytes += BytesToCopy;
+                DataSize -= BytesToCopy;
+            }
+
+            size_t Rounds = DataSize / BlockSizeValue;
+            if (Rounds) {
+                _AlgInstance.Cycle(pBytes, Rounds);
+                pBytes += Rounds * BlockSizeValue;
+                DataSize -= Rounds * BlockSizeValue;
+            }
+
+            if (DataSize) {
+                memcpy(_StreamBuffer.AsCArray(), pBytes, DataSize);
+                _StreamLength = DataSize;
             }
         }
 
-        ByteArray<DigestSize> Digest() const {
-            __AlgType ForkedAlgInstance = _AlgInstance;
-            ForkedAlgInstance.Finish(_StreamBuffer.GetPtr(), _StreamLength, _ProcessedBytes);
-            return ForkedAlgInstance.Digest();
+        Array<uint8_t, DigestSizeValue> Digest() const noexcept {
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Write DigestSizeValue bytes to `pbDigest`.
+        //
+        void DigestTo(void* pbDigest) const noexcept {
+            _Fork().DigestTo(pbDigest);
+        }
+
+        //
+        //  Write SerializedStateSizeValue bytes to `pbState`.
+        //
+        void ExportState(void* pbState) const noexcept {
+            auto pbBytes = reinterpret_cast<uint8_t*>(pbState);
+
+            _StoreLittleEndian<uint32_t>(pbBytes + 0, _StateFormatMagic);
+            _StoreLittleEndian<uint16_t>(pbBytes + 4, StateFormatVersionValue);
+            _StoreLittleEndian<uint16_t>(pbBytes + 6, static_cast<uint16_t>(__AlgType::StateSizeValue));
+            _StoreLittleEndian<uint16_t>(pbBytes + 8, static_cast<uint16_t>(BlockSizeValue));
+            _StoreLittleEndian<uint16_t>(pbBytes + 10, static_cast<uint16_t>(DigestSizeValue));
+            _StoreLittleEndian<uint32_t>(pbBytes + 12, static_cast<uint32_t>(_StreamLength));
+            _StoreLittleEndian<uint64_t>(pbBytes + 16, _ProcessedBytes);
+            _AlgInstance.ExportState(pbBytes + 24);
+            _SwapStateWords(pbBytes + 24);
+            memcpy(pbBytes + 24 + __AlgType::StateSizeValue, _StreamBuffer.AsCArray(), _StreamLength);
+            memset(pbBytes + 24 + __AlgType::StateSizeValue + _StreamLength, 0, BlockSizeValue - _StreamLength);
+        }
+
+        //
+        //  Resume from a state written by ExportState. Returns false, and leaves this object alone,
+        //  if the state is truncated, of another format version or of another algorithm.
+        //
+        ACCEL_NODISCARD
+        bool ImportState(const void* pbState, size_t cbState) noexcept {
+            auto pbBytes = reinterpret_cast<const uint8_t*>(pbState);
+
+            if (cbState != SerializedStateSizeValue) {
+                return false;
+            }
+
+            uint32_t StreamLength = _LoadLittleEndian<uint32_t>(pbBytes + 12);
+            uint64_t ProcessedBytes = _LoadLittleEndian<uint64_t>(pbBytes + 16);
+
+            if (_LoadLittleEndian<uint32_t>(pbBytes + 0) != _StateFormatMagic ||
+                _LoadLittleEndian<uint16_t>(pbBytes + 4) != StateFormatVersionValue ||
+                _LoadLittleEndian<uint16_t>(pbBytes + 6) != __AlgType::StateSizeValue ||
+                _LoadLittleEndian<uint16_t>(pbBytes + 8) != BlockSizeValue ||
+                _LoadLittleEndian<uint16_t>(pbBytes + 10) != DigestSizeValue ||
+                StreamLength >= BlockSizeValue ||
+                ProcessedBytes % BlockSizeValue != StreamLength) {
+                return false;
+            }
+
+            uint8_t ChainingState[__AlgType::StateSizeValue];
+            memcpy(ChainingState, pbBytes + 24, __AlgType::StateSizeValue);
+            _SwapStateWords(ChainingState);
+            _AlgInstance.ImportState(ChainingState);
+            SecureWipe(ChainingState, sizeof(ChainingState));
+            _ProcessedBytes = ProcessedBytes;
+            _StreamBuffer.SecureZero();
+            memcpy(_StreamBuffer.AsCArray(), pbBytes + 24 + __AlgType::StateSizeValue, StreamLength);
+            _StreamLength = StreamLength;
+            return true;
+        }
+
+        ~UnkeyedHasher() noexcept {
+            _StreamBuffer.SecureZero();
         }
     };
 
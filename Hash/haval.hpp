@@ -236,15 +236,15 @@ namespace accel::Hash {
             _Loops<__i>(T, MessageBlock, std::make_index_sequence<32>{});
         }
 
-        SecureWiper<Array<uint32_t, 8>> _StateWiper;
         Array<uint32_t, 8> _State;
 
     public:
         static constexpr size_t BlockSizeValue = 128;
         static constexpr size_t DigestSizeValue = __Bits / 8;
+        static constexpr size_t StateSizeValue = 32;
+        static constexpr size_t StateWordSizeValue = 4;
 
         HAVAL_ALG() noexcept :
-            _StateWiper(_State),
             _State{ 0x243F6A88u,
                     0x85A308D3u,
                     0x13198A2Eu,
@@ -323,114 +323,139 @@ namespace accel::Hash {
             }
         }
 
-        Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            Array<uint8_t, DigestSizeValue> result;
+        void DigestTo(void* pbDigest) const noexcept {
             if constexpr (__Bits == 128) {
-                result.template AsArrayOf<uint32_t, 4>()[0] =
+                uint32_t result[DigestSizeValue / sizeof(uint32_t)];
+                result[0] =
                     RotateShiftRight((_State[7] & 0x000000ffu) |
                                      (_State[6] & 0xff000000u) |
                                      (_State[5] & 0x00ff0000u) |
                                      (_State[4] & 0x0000ff00u), 8);
-                result.template AsArrayOf<uint32_t, 4>()[1] =
+                result[1] =
                     RotateShiftRight((_State[7] & 0x0000ff00u) |
                                      (_State[6] & 0x000000ffu) |
                                      (_State[5] & 0xff000000u) |
                                      (_State[4] & 0x00ff0000u), 16);
-                result.template AsArrayOf<uint32_t, 4>()[2] =
+                result[2] =
                     RotateShiftRight((_State[7] & 0x00ff0000u) |
                                      (_State[6] & 0x0000ff00u) |
                                      (_State[5] & 0x000000ffu) |
                                      (_State[4] & 0xff000000u), 24);
-                result.template AsArrayOf<uint32_t, 4>()[3] =
+                result[3] =
                     (_State[7] & 0xff000000u) |
                     (_State[6] & 0x00ff0000u) |
                     (_State[5] & 0x0000ff00u) |
                     (_State[4] & 0x000000ffu);
-                result.template AsArrayOf<uint32_t, 4>()[0] += _State[0];
-                result.template AsArrayOf<uint32_t, 4>()[1] += _State[1];
-                result.template AsArrayOf<uint32_t, 4>()[2] += _State[2];
-                result.template AsArrayOf<uint32_t, 4>()[3] += _State[3];
-                return result;
+                result[0] += _State[0];
+                result[1] += _State[1];
+                result[2] += _State[2];
+                result[3] += _State[3];
+                memcpy(pbDigest, result, DigestSizeValue);
             } else if constexpr (__Bits == 160) {
-                result.template AsArrayOf<uint32_t, 5>()[0] =
+                uint32_t result[DigestSizeValue / sizeof(uint32_t)];
+                result[0] =
                     RotateShiftRight((_State[7] & 0x0000003fu) |
                                      (_State[6] & 0xfe000000u) |
                                      (_State[5] & 0x01f80000u), 19);
-                result.template AsArrayOf<uint32_t, 5>()[1] =
+                result[1] =
                     RotateShiftRight((_State[7] & 0x00000fc0u) |
                                      (_State[6] & 0x0000003fu) |
                                      (_State[5] & 0xfe000000u), 25);
-                result.template AsArrayOf<uint32_t, 5>()[2] =
+                result[2] =
                     (_State[7] & 0x0007f000u) |
                     (_State[6] & 0x00000fc0u) |
                     (_State[5] & 0x0000003fu);
-                result.template AsArrayOf<uint32_t, 5>()[3] =
+                result[3] =
                     ((_State[7] & 0x01f80000u) |
                      (_State[6] & 0x0007f000u) |
                      (_State[5] & 0x00000fc0u)) >> 6;
-                result.template AsArrayOf<uint32_t, 5>()[4] =
+                result[4] =
                     ((_State[7] & 0xfe000000u) |
                      (_State[6] & 0x01f80000u) |
                      (_State[5] & 0x0007f000u)) >> 12;
-                result.template AsArrayOf<uint32_t, 5>()[0] += _State[0];
-                result.template AsArrayOf<uint32_t, 5>()[1] += _State[1];
-                result.template AsArrayOf<uint32_t, 5>()[2] += _State[2];
-                result.template AsArrayOf<uint32_t, 5>()[3] += _State[3];
-                result.template AsArrayOf<uint32_t, 5>()[4] += _State[4];
-                return result;
+                result[0] += _State[0];
+                result[1] += _State[1];
+                result[2] += _State[2];
+                result[3] += _State[3];
+                result[4] += _State[4];
+                memcpy(pbDigest, result, DigestSizeValue);
             } else if constexpr (__Bits == 192) {
-                result.template AsArrayOf<uint32_t, 6>()[0] =
+                uint32_t result[DigestSizeValue / sizeof(uint32_t)];
+                result[0] =
                     RotateShiftRight((_State[7] & 0x0000001fu) |
                                      (_State[6] & 0xfc000000u), 26);
-                result.template AsArrayOf<uint32_t, 6>()[1] =
+                result[1] =
                     (_State[7] & 0x000003e0u) |
                     (_State[6] & 0x0000001fu);
-                result.template AsArrayOf<uint32_t, 6>()[2] =
+                result[2] =
                     ((_State[7] & 0x0000fc00u) |
                      (_State[6] & 0x000003e0u)) >> 5;
-                result.template AsArrayOf<uint32_t, 6>()[3] =
+                result[3] =
                     ((_State[7] & 0x001f0000u) |
                      (_State[6] & 0x0000fc00u)) >> 10;
-                result.template AsArrayOf<uint32_t, 6>()[4] =
+                result[4] =
                     ((_State[7] & 0x03e00000u) |
                      (_State[6] & 0x001f0000u)) >> 16;
-                result.template AsArrayOf<uint32_t, 6>()[5] =
+                result[5] =
                     ((_State[7] & 0xfc000000u) |
                      (_State[6] & 0x03e00000u)) >> 21;
-                result.template AsArrayOf<uint32_t, 6>()[0] += _State[0];
-                result.template AsArrayOf<uint32_t, 6>()[1] += _State[1];
-                result.template AsArrayOf<uint32_t, 6>()[2] += _State[2];
-                result.template AsArrayOf<uint32_t, 6>()[3] += _State[3];
-                result.template AsArrayOf<uint32_t, 6>()[4] += _State[4];
-                result.template AsArrayOf<uint32_t, 6>()[5] += _State[5];
-                return result;
+                result[0] += _State[0];
+                result[1] += _State[1];
+                result[2] += _State[2];
+                result[3] += _State[3];
+                result[4] += _State[4];
+                result[5] += _State[5];
+                memcpy(pbDigest, result, DigestSizeValue);
             } else if constexpr (__Bits == 224) {
-                result.template AsArrayOf<uint32_t, 7>()[0] =
+                uint32_t result[DigestSizeValue / sizeof(uint32_t)];
+                result[0] =
                     (_State[7] & 0xf8000000u) >> 27;
-                result.template AsArrayOf<uint32_t, 7>()[1] =
+                result[1] =
                     (_State[7] & 0x07c00000u) >> 22;
-                result.template AsArrayOf<uint32_t, 7>()[2] =
+                result[2] =
                     (_State[7] & 0x003c0000u) >> 18;
-                result.template AsArrayOf<uint32_t, 7>()[3] =
+                result[3] =
                     (_State[7] & 0x0003e000u) >> 13;
-                result.template AsArrayOf<uint32_t, 7>()[4] =
+                result[4] =
                     (_State[7] & 0x00001e00u) >> 9;
-                result.template AsArrayOf<uint32_t, 7>()[5] =
+                result[5] =
                     (_State[7] & 0x000001f0u) >> 4;
-                result.template AsArrayOf<uint32_t, 7>()[6] =
+                result[6] =
                     (_State[7] & 0x0000000fu);
-                result.template AsArrayOf<uint32_t, 7>()[0] += _State[0];
-                result.template AsArrayOf<uint32_t, 7>()[1] += _State[1];
-                result.template AsArrayOf<uint32_t, 7>()[2] += _State[2];
-                result.template AsArrayOf<uint32_t, 7>()[3] += _State[3];
-                result.template AsArrayOf<uint32_t, 7>()[4] += _State[4];
-                result.template AsArrayOf<uint32_t, 7>()[5] += _State[5];
-                result.template AsArrayOf<uint32_t, 7>()[6] += _State[6];
-                return result;
+                result[0] += _State[0];
+                result[1] += _State[1];
+                result[2] += _State[2];
+                result[3] += _State[3];
+                result[4] += _State[4];
+                result[5] += _State[5];
+                result[6] += _State[6];
+                memcpy(pbDigest, result, DigestSizeValue);
             } else {
-                return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+                memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
             }
         }
+
+        Array<uint8_t, DigestSizeValue> Digest() const noexcept {
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: the eight 32-bit chaining words, before the output folding that Digest applies.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~HAVAL_ALG() noexcept {
+            _State.SecureZero();
+        }
     };
 }
 
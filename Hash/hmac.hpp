@@ -0,0 +1,171 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../SecureWiper.hpp"
+#include "hasher.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+
+namespace accel::Hash {
+
+    //
+    //  HMAC (RFC 2104) over any hash algorithm (MD5_ALG, SHA256_ALG, ...).
+    //  SetKey compresses the key XOR ipad and the key XOR opad blocks once and keeps the two states.
+    //  Every message then starts from copies of them, so it costs its own blocks plus one outer block,
+    //  instead of the two extra key blocks a plain HMAC pays per message.
+    //
+    //  Compute and Verify are const and may be called from several threads on one keyed object;
+    //  Update and Final stream one message at a time.
+    //
+    template<typename __AlgType>
+    class HMAC {
+    public:
+        static constexpr size_t BlockSizeValue = __AlgType::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = __AlgType::DigestSizeValue;
+
+        //
+        //  The shortest MAC Verify accepts: half the digest and no less than 80 bits (RFC 2104, section 5).
+        //
+        static constexpr size_t MinTruncatedSizeValue = DigestSizeValue / 2 > 10 ? DigestSizeValue / 2 : 10;
+
+        static_assert(DigestSizeValue <= BlockSizeValue, "HMAC failure! A hashed key must fit in one block.");
+    private:
+        __AlgType _InnerMidstate;           // after the key XOR ipad block
+        __AlgType _OuterMidstate;           // after the key XOR opad block
+        UnkeyedHasher<__AlgType> _Inner;    // the streamed message, from _InnerMidstate on
+
+        //
+        //  Hash the whole blocks of `pbData` in place and finish with its tail. `PrefixBytes` were hashed before.
+        //
+        static void _FinishWith(__AlgType& Alg, const uint8_t* pbData, size_t cbData, uint64_t PrefixBytes) ACCEL_NOEXCEPT {
+            size_t Rounds = cbData / BlockSizeValue;
+
+            if (Rounds)
+                Alg.Cycle(pbData, Rounds);
+            Alg.Finish(pbData + Rounds * BlockSizeValue, cbData % BlockSizeValue, PrefixBytes + cbData);
+        }
+
+        //
+        //  Finish the MAC from the inner digest, and wipe the latter.
+        //
+        void _OuterTo(uint8_t (&InnerDigest)[DigestSizeValue], uint8_t* pbMac) const ACCEL_NOEXCEPT {
+            __AlgType Outer = _OuterMidstate;
+
+            _FinishWith(Outer, InnerDigest, DigestSizeValue, BlockSizeValue);
+            Outer.DigestTo(pbMac);
+            SecureWipe(InnerDigest, sizeof(InnerDigest));
+        }
+
+    public:
+
+        HMAC() ACCEL_NOEXCEPT = default;
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t DigestSize() const ACCEL_NOEXCEPT {
+            return DigestSizeValue;
+        }
+
+        //
+        //  Any key length is accepted; keys longer than a block are hashed first. Starts a new message.
+        //
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbKey, size_t cbKey) ACCEL_NOEXCEPT {
+            Array<uint8_t, BlockSizeValue> Pad = {};
+
+            if (cbKey > BlockSizeValue) {
+                __AlgType KeyAlg;
+                _FinishWith(KeyAlg, reinterpret_cast<const uint8_t*>(pbKey), cbKey, 0);
+                KeyAlg.DigestTo(Pad.AsCArray());
+            } else {
+                memcpy(Pad.AsCArray(), pbKey, cbKey);
+            }
+
+            for (size_t i = 0; i < BlockSizeValue; ++i)
+                Pad[i] ^= 0x36;
+            _InnerMidstate = __AlgType{};
+            _InnerMidstate.Cycle(Pad.AsCArray(), 1);
+
+            for (size_t i = 0; i < BlockSizeValue; ++i)
+                Pad[i] ^= 0x36 ^ 0x5C;
+            _OuterMidstate = __AlgType{};
+            _OuterMidstate.Cycle(Pad.AsCArray(), 1);
+
+            Pad.SecureZero();
+            Reset();
+            return true;
+        }
+
+        //
+        //  Drop the streamed message and start a new one with the same key.
+        //
+        void Reset() ACCEL_NOEXCEPT {
+            _Inner = UnkeyedHasher<__AlgType>(_InnerMidstate, BlockSizeValue);
+        }
+
+        void Update(const void* pData, size_t DataSize) ACCEL_NOEXCEPT {
+            _Inner.Update(pData, DataSize);
+        }
+
+        //
+        //  Write the DigestSizeValue-byte MAC of the streamed message to `pbMac`, then start a new message.
+        //
+        void Final(void* pbMac) ACCEL_NOEXCEPT {
+            uint8_t InnerDigest[DigestSizeValue];
+
+            _Inner.DigestTo(InnerDigest);
+            _OuterTo(InnerDigest, reinterpret_cast<uint8_t*>(pbMac));
+            Reset();
+        }
+
+        //
+        //  The states after the key XOR ipad and the key XOR opad blocks, e.g. for a multi-lane kernel
+        //  that runs the iterations of PBKDF2 itself.
+        //
+        const __AlgType& InnerMidstate() const ACCEL_NOEXCEPT {
+            return _InnerMidstate;
+        }
+
+        const __AlgType& OuterMidstate() const ACCEL_NOEXCEPT {
+            return _OuterMidstate;
+        }
+
+        //
+        //  MAC of one whole message, without touching the streamed one.
+        //
+        void Compute(const void* pbMessage, size_t cbMessage, void* pbMac) const ACCEL_NOEXCEPT {
+            __AlgType Inner = _InnerMidstate;
+            uint8_t InnerDigest[DigestSizeValue];
+
+            _FinishWith(Inner, reinterpret_cast<const uint8_t*>(pbMessage), cbMessage, BlockSizeValue);
+            Inner.DigestTo(InnerDigest);
+            _OuterTo(InnerDigest, reinterpret_cast<uint8_t*>(pbMac));
+        }
+
+        //
+        //  Check the first `cbMac` bytes of a MAC in constant time. Returns false if they do not match,
+        //  or if `cbMac` is less than MinTruncatedSizeValue or larger than DigestSizeValue.
+        //
+        ACCEL_NODISCARD
+        bool Verify(const void* pbMessage, size_t cbMessage, const void* pbMac, size_t cbMac) const ACCEL_NOEXCEPT {
+            if (cbMac < MinTruncatedSizeValue || cbMac > DigestSizeValue) {
+                return false;
+            }
+
+            uint8_t Mac[DigestSizeValue];
+            uint8_t Difference = 0;
+
+            Compute(pbMessage, cbMessage, Mac);
+            for (size_t i = 0; i < cbMac; ++i)
+                Difference |= Mac[i] ^ reinterpret_cast<const uint8_t*>(pbMac)[i];
+
+            SecureWipe(Mac, sizeof(Mac));
+            return Difference == 0;
+        }
+    };
+
+}
+
@@ -3,6 +3,7 @@
 #include "../SecureWiper.hpp"
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
+#include <memory.h>
 #include <assert.h>
 
 namespace accel::Hash {
@@ -28,17 +29,15 @@ namespace accel::Hash {
             0x31, 0x44, 0x50, 0xB4, 0x8F, 0xED, 0x1F, 0x1A, 0xDB, 0x99, 0x8D, 0x33, 0x9F, 0x11, 0x83, 0x14
         };
 
-        SecureWiper<Array<uint32_t, 4>> _StateWiper;
-        SecureWiper<Array<uint8_t, 16>> _TailWiper;
         Array<uint32_t, 4> _State;
         Array<uint8_t, 16> _Tail;
     public:
         static constexpr size_t BlockSizeValue = 16;
         static constexpr size_t DigestSizeValue = 16;
+        static constexpr size_t StateSizeValue = 2 * 16;
+        static constexpr size_t StateWordSizeValue = 1;
 
         MD2_ALG() noexcept :
-            _StateWiper(_State),
-            _TailWiper(_Tail),
             _State{ 0u, 0u, 0u, 0u },
             // use static_cast to avoid compile warning
             _Tail{ static_cast<uint8_t>(0), static_cast<uint8_t>(0), static_cast<uint8_t>(0), static_cast<uint8_t>(0),
@@ -98,7 +97,7 @@ namespace accel::Hash {
             memcpy(FormattedTailData, pTailData, TailDataSize);
             for (uint8_t padding = static_cast<uint8_t>(BlockSizeValue - TailDataSize), i = 0; i < padding; ++i)
                 FormattedTailData[TailDataSize + i] = padding;
-            memcpy(FormattedTailData + BlockSizeValue, _Tail.CArray(), BlockSizeValue);
+            memcpy(FormattedTailData + BlockSizeValue, _Tail.AsCArray(), BlockSizeValue);
             for (uint32_t j = 0, L = _Tail[_Tail.Length() - 1]; j < BlockSizeValue; ++j) {
                 FormattedTailData[BlockSizeValue + j] ^= _PI_SUBST[FormattedTailData[j] ^ L];
                 L = FormattedTailData[BlockSizeValue + j];
@@ -113,8 +112,33 @@ namespace accel::Hash {
             }
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: the 16-byte MD2 state block followed by the 16-byte checksum.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), sizeof(_State));
+            memcpy(reinterpret_cast<uint8_t*>(pbState) + sizeof(_State), _Tail.AsCArray(), sizeof(_Tail));
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, sizeof(_State));
+            memcpy(_Tail.AsCArray(), reinterpret_cast<const uint8_t*>(pbState) + sizeof(_State), sizeof(_Tail));
+        }
+
+        ~MD2_ALG() noexcept {
+            _State.SecureZero();
+            _Tail.SecureZero();
         }
     };
 }
@@ -10,7 +10,6 @@ namespace accel::Hash {
 
     class MD4_ALG {
     private:
-        SecureWiper<Array<uint32_t, 4>> _StateWiper;
         Array<uint32_t, 4> _State;
 
         ACCEL_FORCEINLINE
@@ -49,9 +48,10 @@ namespace accel::Hash {
     public:
         static constexpr size_t BlockSizeValue = 64;
         static constexpr size_t DigestSizeValue = 16;
+        static constexpr size_t StateSizeValue = 16;
+        static constexpr size_t StateWordSizeValue = 4;
 
         MD4_ALG() noexcept :
-            _StateWiper(_State),
             _State{ 0x67452301u,
                     0xEFCDAB89u,
                     0x98BADCFEu,
@@ -146,8 +146,30 @@ namespace accel::Hash {
             }
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: A, B, C, D as 32-bit words.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~MD4_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
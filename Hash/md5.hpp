@@ -5,12 +5,18 @@
 #include "../Intrinsic.hpp"
 #include <memory.h>
 #include <assert.h>
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    struct MD5_LANES;
+
+}
 
 namespace accel::Hash {
 
     class MD5_ALG {
     private:
-        SecureWiper<Array<uint32_t, 4>> _StateWiper;
         Array<uint32_t, 4> _State;
 
         template<size_t __Index>
@@ -81,38 +87,45 @@ namespace accel::Hash {
         template<size_t... __Indexes>
         ACCEL_FORCEINLINE
         static void _Loops(uint32_t& A, uint32_t& B, uint32_t& C, uint32_t &D,
-                           const uint32_t (&MessageBlock)[16], std::index_sequence<__Indexes...>) {
+                           const uint32_t (&MessageBlock)[16], std::index_sequence<__Indexes...>) noexcept {
             (_Loop<__Indexes>(A, B, C, D, MessageBlock), ...);
         }
 
+        static void _Compress(uint32_t (&State)[4], const void* pData, size_t Rounds) noexcept {
+            uint32_t AA = 0, BB = 0, CC = 0, DD = 0;
+            auto MessageBlock = reinterpret_cast<const uint32_t(*)[16]>(pData);
+
+            for (size_t i = 0; i < Rounds; ++i) {
+                AA = State[0];
+                BB = State[1];
+                CC = State[2];
+                DD = State[3];
+
+                _Loops(AA, BB, CC, DD, MessageBlock[i], std::make_index_sequence<64>{});
+
+                State[0] += AA;
+                State[1] += BB;
+                State[2] += CC;
+                State[3] += DD;
+            }
+        }
+
+        friend struct Internal::MD5_LANES;
+
     public:
         static constexpr size_t BlockSizeValue = 64;
         static constexpr size_t DigestSizeValue = 16;
+        static constexpr size_t StateSizeValue = 16;
+        static constexpr size_t StateWordSizeValue = 4;
 
         MD5_ALG() noexcept :
-            _StateWiper(_State),
             _State{ 0x67452301u,
                     0xEFCDAB89u,
                     0x98BADCFEu,
                     0x10325476u } {}
 
         void Cycle(const void* pData, size_t Rounds) noexcept {
-            uint32_t AA = 0, BB = 0, CC = 0, DD = 0;
-            auto MessageBlock = reinterpret_cast<const uint32_t(*)[16]>(pData);
-
-            for (size_t i = 0; i < Rounds; ++i) {
-                AA = _State[0];
-                BB = _State[1];
-                CC = _State[2];
-                DD = _State[3];
-
-                _Loops(AA, BB, CC, DD, MessageBlock[i], std::make_index_sequence<64>{});
-
-                _State[0] += AA;
-                _State[1] += BB;
-                _State[2] += CC;
-                _State[3] += DD;
-            }
+            _Compress(_State.AsCArray(), pData, Rounds);
         }
 
         void Finish(const void* pTailData, size_t TailDataSize, uint64_t ProcessedBytes) noexcept {
@@ -143,8 +156,30 @@ namespace accel::Hash {
             }
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: A, B, C, D as 32-bit words.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~MD5_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
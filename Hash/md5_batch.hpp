@@ -0,0 +1,114 @@
+#pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
+#include "md5.hpp"
+#include "Internal/lanes.hpp"
+#include "Internal/multibuffer.hpp"
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    //
+    //  MD5 on lane vectors, for MultiBufferScheduler.
+    //  Round j names A, B, C, D by index (4 - j % 4) % 4 ..., the same rotation MD5_ALG::_Loop spells out.
+    //
+    struct MD5_LANES {
+        static constexpr size_t StateWordsValue = 4;
+        static constexpr size_t DigestSizeValue = MD5_ALG::DigestSizeValue;
+        static constexpr bool BigEndianValue = false;
+        static constexpr uint32_t InitialStateValue[4] = {
+            0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u
+        };
+
+        template<typename __LaneVectorType, size_t __Round>
+        ACCEL_FORCEINLINE
+        static void _Round(typename __LaneVectorType::VectorType (&S)[4], const typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            constexpr size_t a = (4 - __Round % 4) % 4;
+            constexpr size_t b = (a + 1) % 4;
+            constexpr size_t c = (a + 2) % 4;
+            constexpr size_t d = (a + 3) % 4;
+
+            typename V::VectorType F;
+            if constexpr (__Round < 16) {
+                F = V::Choose(S[b], S[c], S[d]);
+            } else if constexpr (__Round < 32) {
+                F = V::Choose(S[d], S[b], S[c]);
+            } else if constexpr (__Round < 48) {
+                F = V::Xor3(S[b], S[c], S[d]);
+            } else {
+                F = V::Xor(S[c], V::OrNot(S[b], S[d]));
+            }
+
+            F = V::Add(V::Add(S[a], F), V::Add(V::Set1(MD5_ALG::_T_Const[__Round]), W[MD5_ALG::_r[__Round]]));
+            S[a] = V::Add(S[b], V::template RotateLeft<MD5_ALG::_s[__Round]>(F));
+        }
+
+        template<typename __LaneVectorType, size_t... __Rounds>
+        ACCEL_FORCEINLINE
+        static void _Rounds(typename __LaneVectorType::VectorType (&S)[4], const typename __LaneVectorType::VectorType (&W)[16], std::index_sequence<__Rounds...>) ACCEL_NOEXCEPT {
+            (_Round<__LaneVectorType, __Rounds>(S, W), ...);
+        }
+
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void Compress(uint32_t (&State)[4][__LaneVectorType::LanesValue], const uint8_t* (&Blocks)[__LaneVectorType::LanesValue]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType S[4];
+            typename V::VectorType W[16];
+
+            V::template LoadMessage<false>(W, Blocks);
+
+            for (size_t i = 0; i < 4; ++i)
+                S[i] = V::Load(State[i]);
+
+            _Rounds<V>(S, W, std::make_index_sequence<64>{});
+
+            for (size_t i = 0; i < 4; ++i)
+                V::Store(State[i], V::Add(S[i], V::Load(State[i])));
+        }
+
+        static void CompressSingle(uint32_t (&State)[4], const void* pData, size_t Rounds) ACCEL_NOEXCEPT {
+            MD5_ALG::_Compress(State, pData, Rounds);
+        }
+    };
+
+}
+
+namespace accel::Hash {
+
+    //
+    //  MD5 of many independent messages at once. Every digest equals what MD5_ALG gives for that message alone.
+    //  The backend is chosen at runtime:
+    //      16 lanes on AVX-512  >  8 lanes on AVX2  >  4 lanes on SSE2  >  MD5_ALG
+    //  Batches with fewer messages than a quarter of the lanes are hashed one by one with MD5_ALG anyway.
+    //
+    class MD5_BATCH {
+    public:
+        static constexpr size_t BlockSizeValue = MD5_ALG::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = MD5_ALG::DigestSizeValue;
+
+        static void HashMessages(const HashMessage* Messages, size_t MessageCount) ACCEL_NOEXCEPT {
+            const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+            if (Features.AVX512F && Features.AVX512BW) {
+                Internal::MultiBufferScheduler<Internal::MD5_LANES, Internal::LaneVectorAVX512>{}.Run(Messages, MessageCount);
+            } else if (Features.AVX2) {
+                Internal::MultiBufferScheduler<Internal::MD5_LANES, Internal::LaneVectorAVX2>{}.Run(Messages, MessageCount);
+            } else if (Features.SSE2) {
+                Internal::MultiBufferScheduler<Internal::MD5_LANES, Internal::LaneVectorSSE2>{}.Run(Messages, MessageCount);
+            } else {
+                for (size_t i = 0; i < MessageCount; ++i) {
+                    auto pbData = reinterpret_cast<const uint8_t*>(Messages[i].pbData);
+                    size_t Rounds = Messages[i].cbData / BlockSizeValue;
+                    MD5_ALG Alg;
+
+                    Alg.Cycle(pbData, Rounds);
+                    Alg.Finish(pbData + Rounds * BlockSizeValue, Messages[i].cbData % BlockSizeValue, Messages[i].cbData);
+                    Alg.DigestTo(Messages[i].pbDigest);
+                }
+            }
+        }
+    };
+
+}
@@ -0,0 +1,557 @@
+#pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
+#include "../Array.hpp"
+#include "../MemoryAccess.hpp"
+#include "../SecureWiper.hpp"
+#include "hmac.hpp"
+#include "sha1_batch.hpp"
+#include "sha256_batch.hpp"
+#include "Internal/sha512_lanes.hpp"
+#include "Internal/lanes.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+#include <type_traits>
+
+namespace accel::Hash {
+
+    //
+    //  One PBKDF2 derivation for PBKDF2<...>::DeriveKeys.
+    //
+    struct PBKDF2Job {
+        const void* pbPassword;
+        size_t cbPassword;
+        const void* pbSalt;
+        size_t cbSalt;
+        size_t Iterations;
+        void* pbDerivedKey;
+        size_t cbDerivedKey;
+    };
+
+}
+
+namespace accel::Hash::Internal {
+
+    //
+    //  The lane kernel that PBKDF2 uses for an algorithm, or void if there is none.
+    //
+    template<typename __AlgType>
+    struct PBKDF2LanesOf {
+        using Type = void;
+    };
+
+    template<>
+    struct PBKDF2LanesOf<SHA1_ALG> {
+        using Type = SHA1_LANES;
+    };
+
+    template<>
+    struct PBKDF2LanesOf<SHA256_ALG> {
+        using Type = SHA256_LANES;
+    };
+
+    template<>
+    struct PBKDF2LanesOf<SHA512_ALG> {
+        using Type = SHA512_LANES;
+    };
+
+    template<typename __LaneVectorType>
+    struct PBKDF2LaneCount {
+        static constexpr size_t Value = __LaneVectorType::LanesValue;
+    };
+
+    template<>
+    struct PBKDF2LaneCount<void> {
+        static constexpr size_t Value = 1;
+    };
+
+    //
+    //  Iterations 2, 3, ... of PBKDF2-HMAC on lane vectors.
+    //  U is one digest, so both compressions of an iteration see a single block whose padding never changes:
+    //      U (or the inner digest) || 0x80 || zeros || bit length of one key block plus one digest
+    //  The blocks are built straight in W from the state words, without a round trip through memory.
+    //  The kernel's WordType is uint32_t for SHA-1 and SHA-256, and uint64_t for SHA-512 on 64-bit lane vectors.
+    //
+    template<typename __KernelType>
+    struct PBKDF2_LANES {
+        using WordType = typename __KernelType::WordType;
+        static constexpr size_t StateWordsValue = __KernelType::StateWordsValue;
+        static constexpr size_t BlockSizeValue = __KernelType::BlockSizeValue;
+
+        static_assert(__KernelType::BigEndianValue, "PBKDF2_LANES failure! Only big-endian hashes are supported.");
+        static_assert(__KernelType::DigestSizeValue == StateWordsValue * sizeof(WordType), "PBKDF2_LANES failure! The digest must be the whole state.");
+        static_assert(BlockSizeValue == 16 * sizeof(WordType), "PBKDF2_LANES failure! A block must be 16 words.");
+
+        static constexpr WordType _LengthBits = (BlockSizeValue + __KernelType::DigestSizeValue) * 8;
+
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void _FillBlock(typename __LaneVectorType::VectorType (&W)[16], const typename __LaneVectorType::VectorType (&Words)[StateWordsValue]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+
+            for (size_t i = 0; i < StateWordsValue; ++i)
+                W[i] = Words[i];
+            W[StateWordsValue] = V::Set1(static_cast<WordType>(0x80) << (sizeof(WordType) * 8 - 8));
+            for (size_t i = StateWordsValue + 1; i < 15; ++i)
+                W[i] = V::Set1(0);
+            W[15] = V::Set1(_LengthBits);
+        }
+
+        //
+        //  `Iterations` iterations on every lane: U = HMAC(P, U) and T ^= U, two compressions each.
+        //  Inner and Outer hold each lane's state after its key XOR ipad / opad block.
+        //
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void Compress(const WordType (&Inner)[StateWordsValue][__LaneVectorType::LanesValue],
+                             const WordType (&Outer)[StateWordsValue][__LaneVectorType::LanesValue],
+                             WordType (&U)[StateWordsValue][__LaneVectorType::LanesValue],
+                             WordType (&T)[StateWordsValue][__LaneVectorType::LanesValue],
+                             const size_t& Iterations) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType u[StateWordsValue];
+            typename V::VectorType t[StateWordsValue];
+            typename V::VectorType S[StateWordsValue];
+            typename V::VectorType W[16];
+
+            for (size_t i = 0; i < StateWordsValue; ++i) {
+                u[i] = V::Load(U[i]);
+                t[i] = V::Load(T[i]);
+            }
+
+            for (size_t j = 0; j < Iterations; ++j) {
+                for (size_t i = 0; i < StateWordsValue; ++i)
+                    S[i] = V::Load(Inner[i]);
+                _FillBlock<V>(W, u);
+                __KernelType::template CompressWords<V>(S, W);
+
+                _FillBlock<V>(W, S);
+                for (size_t i = 0; i < StateWordsValue; ++i)
+                    u[i] = V::Load(Outer[i]);
+                __KernelType::template CompressWords<V>(u, W);
+
+                for (size_t i = 0; i < StateWordsValue; ++i)
+                    t[i] = V::Xor(t[i], u[i]);
+            }
+
+            for (size_t i = 0; i < StateWordsValue; ++i) {
+                V::Store(U[i], u[i]);
+                V::Store(T[i], t[i]);
+            }
+        }
+
+        //
+        //  The same for one lane, with the single-stream kernel (SHA-NI where available).
+        //
+        static void CompressSingle(const WordType (&Inner)[StateWordsValue],
+                                   const WordType (&Outer)[StateWordsValue],
+                                   WordType (&U)[StateWordsValue],
+                                   WordType (&T)[StateWordsValue],
+                                   size_t Iterations) ACCEL_NOEXCEPT {
+            uint8_t Block[BlockSizeValue] = {};
+            WordType S[StateWordsValue];
+
+            //
+            //  SHA-512 has a 128-bit length field, but the high half stays zero.
+            //
+            Block[__KernelType::DigestSizeValue] = 0x80;
+            MemoryWriteAs<uint64_t>(Block + BlockSizeValue - sizeof(uint64_t), ByteSwap<uint64_t>(_LengthBits));
+
+            for (size_t j = 0; j < Iterations; ++j) {
+                for (size_t i = 0; i < StateWordsValue; ++i) {
+                    MemoryWriteAs<WordType>(Block + sizeof(WordType) * i, ByteSwap(U[i]));
+                    S[i] = Inner[i];
+                }
+                __KernelType::CompressSingle(S, Block, 1);
+
+                for (size_t i = 0; i < StateWordsValue; ++i) {
+                    MemoryWriteAs<WordType>(Block + sizeof(WordType) * i, ByteSwap(S[i]));
+                    U[i] = Outer[i];
+                }
+                __KernelType::CompressSingle(U, Block, 1);
+
+                for (size_t i = 0; i < StateWordsValue; ++i)
+                    T[i] ^= U[i];
+            }
+
+            SecureWipe(Block, sizeof(Block));
+            SecureWipe(S, sizeof(S));
+        }
+    };
+
+    //
+    //  Runs the output blocks of a list of PBKDF2 jobs, one block per lane, in the manner of MultiBufferScheduler:
+    //  a lane that finishes its block takes the next one, so jobs with different iteration counts can be mixed,
+    //  and once the queue is empty and at most a quarter of the lanes are busy, those are finished one by one.
+    //  With __LaneVectorType = void every block runs on the single-stream kernel.
+    //
+    //  The first iteration, HMAC(P, S || INT(i)), is computed with HMAC<__AlgType>.
+    //
+    template<typename __AlgType, typename __KernelType, typename __LaneVectorType>
+    class PBKDF2Scheduler {
+    private:
+        using _Word = typename __KernelType::WordType;
+
+        static constexpr size_t _Words = __KernelType::StateWordsValue;
+        static constexpr size_t _DigestSize = __KernelType::DigestSizeValue;
+        static constexpr size_t _BlockSize = __AlgType::BlockSizeValue;
+        static constexpr size_t _Lanes = PBKDF2LaneCount<__LaneVectorType>::Value;
+
+        using _IterationsKernel = PBKDF2_LANES<__KernelType>;
+
+        struct _Task {
+            _Word Inner[_Words];
+            _Word Outer[_Words];
+            _Word U[_Words];
+            _Word T[_Words];
+            size_t IterationsLeft;
+            uint8_t* pbOut;
+            size_t cbOut;
+        };
+
+        struct _LaneSlot {
+            bool Busy;
+            size_t IterationsLeft;
+            uint8_t* pbOut;
+            size_t cbOut;
+        };
+
+        alignas(64) _Word _Inner[_Words][_Lanes];
+        alignas(64) _Word _Outer[_Words][_Lanes];
+        alignas(64) _Word _U[_Words][_Lanes];
+        alignas(64) _Word _T[_Words][_Lanes];
+        _LaneSlot _Slots[_Lanes];
+
+        //
+        //  The queue: the next block is block `_BlockIndex` (1-based) of job `_JobIndex`.
+        //
+        const PBKDF2Job* _Jobs;
+        size_t _JobCount;
+        size_t _JobIndex;
+        size_t _BlockIndex;
+        HMAC<__AlgType> _Hmac;
+        _Word _JobInner[_Words];
+        _Word _JobOuter[_Words];
+
+        //
+        //  _Hmac serves the first iteration; its midstates seed the lanes for the others.
+        //
+        void _KeyJob(const PBKDF2Job& Job) ACCEL_NOEXCEPT {
+            static_assert(__AlgType::StateSizeValue == sizeof(_JobInner), "PBKDF2Scheduler failure! State layouts differ.");
+
+            (void)_Hmac.SetKey(Job.pbPassword, Job.cbPassword);
+            _Hmac.InnerMidstate().ExportState(_JobInner);
+            _Hmac.OuterMidstate().ExportState(_JobOuter);
+        }
+
+        bool _NextTask(_Task& Task) ACCEL_NOEXCEPT {
+            while (_JobIndex < _JobCount && (_BlockIndex - 1) * _DigestSize >= _Jobs[_JobIndex].cbDerivedKey) {
+                ++_JobIndex;
+                _BlockIndex = 1;
+                if (_JobIndex < _JobCount)
+                    _KeyJob(_Jobs[_JobIndex]);
+            }
+
+            if (_JobIndex == _JobCount)
+                return false;
+
+            const PBKDF2Job& Job = _Jobs[_JobIndex];
+            uint8_t BlockIndex[4];
+            uint8_t U[_DigestSize];
+
+            MemoryWriteAs<uint32_t>(BlockIndex, ByteSwap(static_cast<uint32_t>(_BlockIndex)));
+            _Hmac.Update(Job.pbSalt, Job.cbSalt);
+            _Hmac.Update(BlockIndex, sizeof(BlockIndex));
+            _Hmac.Final(U);
+
+            for (size_t i = 0; i < _Words; ++i) {
+                Task.Inner[i] = _JobInner[i];
+                Task.Outer[i] = _JobOuter[i];
+                Task.U[i] = ByteSwap(MemoryReadAs<_Word>(U + sizeof(_Word) * i));
+                Task.T[i] = Task.U[i];
+            }
+
+            Task.IterationsLeft = Job.Iterations - 1;
+            Task.pbOut = reinterpret_cast<uint8_t*>(Job.pbDerivedKey) + (_BlockIndex - 1) * _DigestSize;
+            Task.cbOut = Job.cbDerivedKey - (_BlockIndex - 1) * _DigestSize;
+            if (Task.cbOut > _DigestSize)
+                Task.cbOut = _DigestSize;
+
+            ++_BlockIndex;
+            SecureWipe(U, sizeof(U));
+            return true;
+        }
+
+        static void _Output(const _Word (&T)[_Words], uint8_t* pbOut, size_t cbOut) ACCEL_NOEXCEPT {
+            uint8_t Block[_DigestSize];
+
+            for (size_t i = 0; i < _Words; ++i)
+                MemoryWriteAs<_Word>(Block + sizeof(_Word) * i, ByteSwap(T[i]));
+
+            memcpy(pbOut, Block, cbOut);
+            SecureWipe(Block, sizeof(Block));
+        }
+
+        static void _RunSingle(_Task& Task) ACCEL_NOEXCEPT {
+            _IterationsKernel::CompressSingle(Task.Inner, Task.Outer, Task.U, Task.T, Task.IterationsLeft);
+            _Output(Task.T, Task.pbOut, Task.cbOut);
+        }
+
+        void _Start(size_t Lane, const _Task& Task) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < _Words; ++i) {
+                _Inner[i][Lane] = Task.Inner[i];
+                _Outer[i][Lane] = Task.Outer[i];
+                _U[i][Lane] = Task.U[i];
+                _T[i][Lane] = Task.T[i];
+            }
+
+            _Slots[Lane].Busy = true;
+            _Slots[Lane].IterationsLeft = Task.IterationsLeft;
+            _Slots[Lane].pbOut = Task.pbOut;
+            _Slots[Lane].cbOut = Task.cbOut;
+        }
+
+        void _Gather(size_t Lane, _Task& Task) const ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < _Words; ++i) {
+                Task.Inner[i] = _Inner[i][Lane];
+                Task.Outer[i] = _Outer[i][Lane];
+                Task.U[i] = _U[i][Lane];
+                Task.T[i] = _T[i][Lane];
+            }
+
+            Task.IterationsLeft = _Slots[Lane].IterationsLeft;
+            Task.pbOut = _Slots[Lane].pbOut;
+            Task.cbOut = _Slots[Lane].cbOut;
+        }
+
+        void _RunLanes() ACCEL_NOEXCEPT {
+            _Task Task;
+
+            for (;;) {
+                size_t Busy = 0;
+                size_t Step = SIZE_MAX;
+                bool QueueEmpty = false;
+
+                for (size_t i = 0; i < _Lanes; ++i) {
+                    if (_Slots[i].Busy == false && QueueEmpty == false) {
+                        if (_NextTask(Task)) {
+                            _Start(i, Task);
+                        } else {
+                            QueueEmpty = true;
+                        }
+                    }
+
+                    if (_Slots[i].Busy) {
+                        ++Busy;
+                        Step = _Slots[i].IterationsLeft < Step ? _Slots[i].IterationsLeft : Step;
+                    }
+                }
+
+                if (Busy == 0)
+                    break;
+
+                if (QueueEmpty && Busy * 4 <= _Lanes) {
+                    for (size_t i = 0; i < _Lanes; ++i) {
+                        if (_Slots[i].Busy) {
+                            _Gather(i, Task);
+                            _RunSingle(Task);
+                            _Slots[i].Busy = false;
+                        }
+                    }
+                    break;
+                }
+
+                //
+                //  Idle lanes iterate on whatever they hold; their results are never read.
+                //
+                if (Step)
+                    __LaneVectorType::template Invoke<_IterationsKernel>(_Inner, _Outer, _U, _T, Step);
+
+                for (size_t i = 0; i < _Lanes; ++i) {
+                    if (_Slots[i].Busy == false)
+                        continue;
+
+                    _Slots[i].IterationsLeft -= Step;
+                    if (_Slots[i].IterationsLeft == 0) {
+                        _Word T[_Words];
+
+                        for (size_t j = 0; j < _Words; ++j)
+                            T[j] = _T[j][i];
+
+                        _Output(T, _Slots[i].pbOut, _Slots[i].cbOut);
+                        SecureWipe(T, sizeof(T));
+                        _Slots[i].Busy = false;
+                    }
+                }
+            }
+
+            SecureWipe(&Task, sizeof(Task));
+        }
+
+    public:
+
+        PBKDF2Scheduler() ACCEL_NOEXCEPT {
+            memset(_Inner, 0, sizeof(_Inner));
+            memset(_Outer, 0, sizeof(_Outer));
+            memset(_U, 0, sizeof(_U));
+            memset(_T, 0, sizeof(_T));
+            for (size_t i = 0; i < _Lanes; ++i)
+                _Slots[i].Busy = false;
+        }
+
+        //
+        //  The jobs must have been checked by the caller: Iterations >= 1 and at most 2^32 - 1 blocks each.
+        //
+        void Run(const PBKDF2Job* Jobs, size_t JobCount) ACCEL_NOEXCEPT {
+            _Jobs = Jobs;
+            _JobCount = JobCount;
+            _JobIndex = 0;
+            _BlockIndex = 1;
+
+            if (_JobCount == 0)
+                return;
+
+            _KeyJob(_Jobs[0]);
+
+            if constexpr (std::is_void<__LaneVectorType>::value) {
+                _Task Task;
+                while (_NextTask(Task))
+                    _RunSingle(Task);
+                SecureWipe(&Task, sizeof(Task));
+            } else {
+                _RunLanes();
+            }
+        }
+
+        PBKDF2Scheduler(const PBKDF2Scheduler&) = delete;
+        PBKDF2Scheduler& operator=(const PBKDF2Scheduler&) = delete;
+
+        ~PBKDF2Scheduler() ACCEL_NOEXCEPT {
+            SecureWipe(_Inner, sizeof(_Inner));
+            SecureWipe(_Outer, sizeof(_Outer));
+            SecureWipe(_U, sizeof(_U));
+            SecureWipe(_T, sizeof(_T));
+            SecureWipe(_JobInner, sizeof(_JobInner));
+            SecureWipe(_JobOuter, sizeof(_JobOuter));
+        }
+    };
+
+}
+
+namespace accel::Hash {
+
+    //
+    //  PBKDF2 (RFC 8018) with HMAC<__AlgType> as the PRF.
+    //  Every iteration starts from the HMAC key states, so it costs exactly two compressions.
+    //
+    //  For SHA1_ALG, SHA256_ALG and SHA512_ALG, the output blocks of all jobs are spread over SIMD lanes, so both a long
+    //  derived key and a batch of candidate passwords fill the lanes. The backend is chosen at runtime like SHA256_BATCH:
+    //      16 lanes on AVX-512  >  one block after another on SHA-NI  >  8 lanes on AVX2  >  4 lanes on SSE2  >  portable
+    //  SHA-512 runs on 64-bit lanes and has no SHA-NI path:
+    //      8 lanes on AVX-512  >  4 lanes on AVX2  >  portable
+    //  A lone 32-byte SHA-256 or 64-byte SHA-512 key is a single block, so it always runs on the single-stream kernel.
+    //  Other algorithms iterate with HMAC<__AlgType>::Compute.
+    //
+    template<typename __AlgType>
+    class PBKDF2 {
+    public:
+        static constexpr size_t DigestSizeValue = __AlgType::DigestSizeValue;
+    private:
+        using _KernelType = typename Internal::PBKDF2LanesOf<__AlgType>::Type;
+
+        static bool _Check(const PBKDF2Job& Job) ACCEL_NOEXCEPT {
+            return Job.Iterations != 0 && (Job.cbDerivedKey + DigestSizeValue - 1) / DigestSizeValue <= UINT32_MAX;
+        }
+
+        static void _DeriveGeneric(const PBKDF2Job& Job) ACCEL_NOEXCEPT {
+            HMAC<__AlgType> Hmac;
+            uint8_t U[DigestSizeValue];
+            uint8_t T[DigestSizeValue];
+
+            (void)Hmac.SetKey(Job.pbPassword, Job.cbPassword);
+
+            for (size_t Offset = 0, BlockIndex = 1; Offset < Job.cbDerivedKey; Offset += DigestSizeValue, ++BlockIndex) {
+                uint8_t BlockIndexBytes[4];
+
+                MemoryWriteAs<uint32_t>(BlockIndexBytes, ByteSwap(static_cast<uint32_t>(BlockIndex)));
+                Hmac.Update(Job.pbSalt, Job.cbSalt);
+                Hmac.Update(BlockIndexBytes, sizeof(BlockIndexBytes));
+                Hmac.Final(U);
+                memcpy(T, U, DigestSizeValue);
+
+                for (size_t j = 1; j < Job.Iterations; ++j) {
+                    Hmac.Compute(U, DigestSizeValue, U);
+                    for (size_t i = 0; i < DigestSizeValue; ++i)
+                        T[i] ^= U[i];
+                }
+
+                size_t cbOut = Job.cbDerivedKey - Offset < DigestSizeValue ? Job.cbDerivedKey - Offset : DigestSizeValue;
+                memcpy(reinterpret_cast<uint8_t*>(Job.pbDerivedKey) + Offset, T, cbOut);
+            }
+
+            SecureWipe(U, sizeof(U));
+            SecureWipe(T, sizeof(T));
+        }
+
+    public:
+
+        //
+        //  Derive `cbDerivedKey` bytes. Returns false, and writes nothing, if `Iterations` is 0
+        //  or the key is longer than 2^32 - 1 digests.
+        //
+        ACCEL_NODISCARD
+        static bool DeriveKey(const void* pbPassword, size_t cbPassword,
+                              const void* pbSalt, size_t cbSalt,
+                              size_t Iterations,
+                              void* pbDerivedKey, size_t cbDerivedKey) ACCEL_NOEXCEPT {
+            PBKDF2Job Job = { pbPassword, cbPassword, pbSalt, cbSalt, Iterations, pbDerivedKey, cbDerivedKey };
+            return DeriveKeys(&Job, 1);
+        }
+
+        //
+        //  Run a batch of independent derivations, e.g. one per candidate password.
+        //  Returns false, and writes nothing, if any job is invalid (see DeriveKey).
+        //
+        ACCEL_NODISCARD
+        static bool DeriveKeys(const PBKDF2Job* Jobs, size_t JobCount) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < JobCount; ++i) {
+                if (_Check(Jobs[i]) == false)
+                    return false;
+            }
+
+            if constexpr (std::is_void<_KernelType>::value) {
+                for (size_t i = 0; i < JobCount; ++i)
+                    _DeriveGeneric(Jobs[i]);
+            } else if constexpr (sizeof(typename _KernelType::WordType) == sizeof(uint64_t)) {
+                const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+                if (Features.AVX512F && Features.AVX512BW) {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, Internal::LaneVector64AVX512>{}.Run(Jobs, JobCount);
+                } else if (Features.AVX2) {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, Internal::LaneVector64AVX2>{}.Run(Jobs, JobCount);
+                } else {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, void>{}.Run(Jobs, JobCount);
+                }
+            } else {
+                const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+                if (Features.AVX512F && Features.AVX512BW) {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, Internal::LaneVectorAVX512>{}.Run(Jobs, JobCount);
+                } else if (Features.SHA && Features.SSE41) {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, void>{}.Run(Jobs, JobCount);
+                } else if (Features.AVX2) {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, Internal::LaneVectorAVX2>{}.Run(Jobs, JobCount);
+                } else if (Features.SSE2) {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, Internal::LaneVectorSSE2>{}.Run(Jobs, JobCount);
+                } else {
+                    Internal::PBKDF2Scheduler<__AlgType, _KernelType, void>{}.Run(Jobs, JobCount);
+                }
+            }
+
+            return true;
+        }
+    };
+
+}
+
@@ -58,7 +58,6 @@ namespace accel::Hash {
                       __Bits == 256 ||
                       __Bits == 320, "RIPEMD_ALG failure! Unsupported bits.");
     private:
-        SecureWiper<Array<uint32_t, __Bits / 32>> _StateWiper;
         Array<uint32_t, __Bits / 32> _State;
 
         template<size_t __Index>
@@ -275,9 +274,10 @@ namespace accel::Hash {
     public:
         static constexpr size_t BlockSizeValue = 64;
         static constexpr size_t DigestSizeValue = __Bits / 8;
+        static constexpr size_t StateSizeValue = __Bits / 8;
+        static constexpr size_t StateWordSizeValue = 4;
 
         RIPEMD_ALG() noexcept :
-            _StateWiper(_State),
             _State{ Internal::RIPEMD_CONSTANT<__Bits>::_InitValue } {}
 
         void Cycle(const void* pData, size_t Rounds) noexcept {
@@ -405,8 +405,30 @@ namespace accel::Hash {
             }
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.template AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: the __Bits / 32 chaining words, h0 first.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~RIPEMD_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
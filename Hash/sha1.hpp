@@ -1,29 +1,26 @@
 #pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
 #include "../SecureWiper.hpp"
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
 #include <memory.h>
 #include <assert.h>
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    struct SHA1_LANES;
+
+}
 
 namespace accel::Hash {
 
     class SHA1_ALG {
     private:
-        SecureWiper<Array<uint32_t, 5>> _StateWiper;
         Array<uint32_t, 5> _State;
-    public:
-        static constexpr size_t BlockSizeValue = 64;
-        static constexpr size_t DigestSizeValue = 20;
 
-        SHA1_ALG() noexcept :
-            _StateWiper(_State),
-            _State{ 0x67452301u,
-                    0xEFCDAB89u,
-                    0x98BADCFEu,
-                    0x10325476u,
-                    0xC3D2E1F0u } {}
-
-        void Cycle(const void* pData, size_t Rounds) noexcept {
+        static void _CompressPortable(uint32_t (&State)[5], const void* pData, size_t Rounds) noexcept {
             uint32_t Buffer[80] = {};
             uint32_t a, b, c, d, e;
             auto MessageBlock = reinterpret_cast<const uint32_t(*)[BlockSizeValue / sizeof(uint32_t)]>(pData);
@@ -38,11 +35,11 @@ namespace accel::Hash {
                                                            Buffer[j - 14] ^
                                                            Buffer[j - 16], 1);
                 
-                a = _State[0];
-                b = _State[1];
-                c = _State[2];
-                d = _State[3];
-                e = _State[4];
+                a = State[0];
+                b = State[1];
+                c = State[2];
+                d = State[3];
+                e = State[4];
 
                 for (int j = 0; j < 20; ++j) {
                     uint32_t T = RotateShiftLeft(a, 5);
@@ -80,14 +77,125 @@ namespace accel::Hash {
                     b = a;
                     a = T;
                 }
-                _State[0] += a;
-                _State[1] += b;
-                _State[2] += c;
-                _State[3] += d;
-                _State[4] += e;
+                State[0] += a;
+                State[1] += b;
+                State[2] += c;
+                State[3] += d;
+                State[4] += e;
+            }
+
+            SecureWipe(Buffer, sizeof(Buffer));
+        }
+
+        //
+        //  Rounds 4 * __Index ... 4 * __Index + 3 with SHA1RNDS4.
+        //  E[__Index % 2] carries E into these rounds (SHA1NEXTE adds it to the message words), E[(__Index + 1) % 2] saves A for the next quad.
+        //  The schedule runs ahead of the rounds: SHA1MSG1 and the XOR for words 8 and 12 rounds ahead, SHA1MSG2 for the next quad.
+        //
+        template<size_t __Index>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("sha,sse4.1,ssse3")
+        static void _ShaNiQuadRound(__m128i& ABCD, __m128i (&E)[2], __m128i (&Msg)[4], const uint8_t* pBlock, __m128i ByteSwapMask) noexcept {
+            constexpr size_t Cur = __Index % 4;
+            constexpr size_t Next = (__Index + 1) % 4;
+            constexpr size_t Prev = (__Index + 3) % 4;
+            constexpr size_t Far = (__Index + 2) % 4;
+
+            if constexpr (__Index < 4) {
+                Msg[Cur] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pBlock + 16 * __Index)), ByteSwapMask);
+            }
+
+            if constexpr (__Index == 0) {
+                E[0] = _mm_add_epi32(E[0], Msg[Cur]);
+            } else {
+                E[__Index % 2] = _mm_sha1nexte_epu32(E[__Index % 2], Msg[Cur]);
+            }
+
+            E[(__Index + 1) % 2] = ABCD;
+
+            if constexpr (3 <= __Index && __Index <= 18) {
+                Msg[Next] = _mm_sha1msg2_epu32(Msg[Next], Msg[Cur]);
+            }
+
+            ABCD = _mm_sha1rnds4_epu32(ABCD, E[__Index % 2], __Index / 5);
+
+            if constexpr (1 <= __Index && __Index <= 16) {
+                Msg[Prev] = _mm_sha1msg1_epu32(Msg[Prev], Msg[Cur]);
+            }
+
+            if constexpr (2 <= __Index && __Index <= 17) {
+                Msg[Far] = _mm_xor_si128(Msg[Far], Msg[Cur]);
+            }
+        }
+
+        template<size_t... __Indexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("sha,sse4.1,ssse3")
+        static void _ShaNiBlock(__m128i& ABCD, __m128i (&E)[2], const uint8_t* pBlock, __m128i ByteSwapMask, std::index_sequence<__Indexes...>) noexcept {
+            __m128i Msg[4];
+            (_ShaNiQuadRound<__Indexes>(ABCD, E, Msg, pBlock, ByteSwapMask), ...);
+        }
+
+        //
+        //  SHA1RNDS4 wants A in the highest lane, and E alone in the highest lane of its own register.
+        //
+        ACCEL_TARGET("sha,sse4.1,ssse3")
+        static void _CompressShaNi(uint32_t (&State)[5], const void* pData, size_t Rounds) noexcept {
+            const __m128i ByteSwapMask = _mm_set_epi64x(0x0001020304050607ll, 0x08090a0b0c0d0e0fll);
+            auto pBlock = reinterpret_cast<const uint8_t*>(pData);
+
+            __m128i ABCD = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(State)), 0x1B);
+            __m128i E0 = _mm_set_epi32(static_cast<int>(State[4]), 0, 0, 0);
+
+            for (size_t i = 0; i < Rounds; ++i, pBlock += BlockSizeValue) {
+                __m128i E[2] = { E0, E0 };
+                __m128i SavedABCD = ABCD;
+
+                _ShaNiBlock(ABCD, E, pBlock, ByteSwapMask, std::make_index_sequence<20>{});
+
+                E0 = _mm_sha1nexte_epu32(E[0], E0);
+                ABCD = _mm_add_epi32(ABCD, SavedABCD);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(State), _mm_shuffle_epi32(ABCD, 0x1B));
+            State[4] = static_cast<uint32_t>(_mm_extract_epi32(E0, 3));
+        }
+
+        //
+        //  SHA-NI when the compiler may assume it or the host reports it (with SSSE3 and SSE4.1, which the kernel also uses);
+        //  the portable loop otherwise. Both give the same state, bit for bit.
+        //
+        static void _Compress(uint32_t (&State)[5], const void* pData, size_t Rounds) noexcept {
+            if constexpr (CpuFeatureSHAAvailable) {
+                _CompressShaNi(State, pData, Rounds);
+            } else {
+                const CpuFeatureSet& Features = RuntimeCpuFeatures();
+                if (Features.SHA && Features.SSE41 && Features.SSSE3) {
+                    _CompressShaNi(State, pData, Rounds);
+                } else {
+                    _CompressPortable(State, pData, Rounds);
+                }
             }
         }
 
+        friend struct Internal::SHA1_LANES;
+    public:
+        static constexpr size_t BlockSizeValue = 64;
+        static constexpr size_t DigestSizeValue = 20;
+        static constexpr size_t StateSizeValue = 20;
+        static constexpr size_t StateWordSizeValue = 4;
+
+        SHA1_ALG() noexcept :
+            _State{ 0x67452301u,
+                    0xEFCDAB89u,
+                    0x98BADCFEu,
+                    0x10325476u,
+                    0xC3D2E1F0u } {}
+
+        void Cycle(const void* pData, size_t Rounds) noexcept {
+            _Compress(_State.AsCArray(), pData, Rounds);
+        }
+
         //
         //  Once Finish(...) is called, this object should be treated as const
         //
@@ -118,8 +226,30 @@ namespace accel::Hash {
             _State[4] = ByteSwap(_State[4]);
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: H0 ... H4 as 32-bit words.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~SHA1_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
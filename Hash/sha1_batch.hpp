@@ -0,0 +1,157 @@
+#pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
+#include "sha1.hpp"
+#include "Internal/lanes.hpp"
+#include "Internal/multibuffer.hpp"
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    //
+    //  SHA-1 on lane vectors, for MultiBufferScheduler.
+    //  The 80 rounds are unrolled; round j names a..e by index (5 - j % 5) % 5 ....
+    //  The message schedule is kept in a 16-word ring.
+    //
+    struct SHA1_LANES {
+        using WordType = uint32_t;
+        static constexpr size_t StateWordsValue = 5;
+        static constexpr size_t BlockSizeValue = SHA1_ALG::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = SHA1_ALG::DigestSizeValue;
+        static constexpr bool BigEndianValue = true;
+        static constexpr uint32_t InitialStateValue[5] = {
+            0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u
+        };
+
+        template<typename __LaneVectorType, size_t __Round>
+        ACCEL_FORCEINLINE
+        static void _Round(typename __LaneVectorType::VectorType (&S)[5], typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            constexpr size_t a = (5 - __Round % 5) % 5;
+            constexpr size_t b = (a + 1) % 5;
+            constexpr size_t c = (a + 2) % 5;
+            constexpr size_t d = (a + 3) % 5;
+            constexpr size_t e = (a + 4) % 5;
+
+            if constexpr (__Round >= 16) {
+                W[__Round % 16] = V::template RotateLeft<1>(
+                    V::Xor(V::Xor3(W[(__Round + 13) % 16], W[(__Round + 8) % 16], W[(__Round + 2) % 16]), W[__Round % 16])
+                );
+            }
+
+            typename V::VectorType F;
+            uint32_t K;
+            if constexpr (__Round < 20) {
+                F = V::Choose(S[b], S[c], S[d]);
+                K = 0x5A827999u;
+            } else if constexpr (__Round < 40) {
+                F = V::Xor3(S[b], S[c], S[d]);
+                K = 0x6ED9EBA1u;
+            } else if constexpr (__Round < 60) {
+                F = V::Majority(S[b], S[c], S[d]);
+                K = 0x8F1BBCDCu;
+            } else {
+                F = V::Xor3(S[b], S[c], S[d]);
+                K = 0xCA62C1D6u;
+            }
+
+            S[e] = V::Add(V::Add(S[e], V::template RotateLeft<5>(S[a])), V::Add(F, V::Add(V::Set1(K), W[__Round % 16])));
+            S[b] = V::template RotateLeft<30>(S[b]);
+        }
+
+        template<typename __LaneVectorType, size_t... __Rounds>
+        ACCEL_FORCEINLINE
+        static void _Rounds(typename __LaneVectorType::VectorType (&S)[5], typename __LaneVectorType::VectorType (&W)[16], std::index_sequence<__Rounds...>) ACCEL_NOEXCEPT {
+            (_Round<__LaneVectorType, __Rounds>(S, W), ...);
+        }
+
+        //
+        //  One block on every lane, with the state and the message words already in vectors.
+        //  W is used as the schedule ring and is clobbered.
+        //
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void CompressWords(typename __LaneVectorType::VectorType (&State)[5], typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType S[5];
+
+            for (size_t i = 0; i < 5; ++i)
+                S[i] = State[i];
+
+            _Rounds<V>(S, W, std::make_index_sequence<80>{});
+
+            for (size_t i = 0; i < 5; ++i)
+                State[i] = V::Add(State[i], S[i]);
+        }
+
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void Compress(uint32_t (&State)[5][__LaneVectorType::LanesValue], const uint8_t* (&Blocks)[__LaneVectorType::LanesValue]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType S[5];
+            typename V::VectorType W[16];
+
+            V::template LoadMessage<true>(W, Blocks);
+
+            for (size_t i = 0; i < 5; ++i)
+                S[i] = V::Load(State[i]);
+
+            CompressWords<V>(S, W);
+
+            for (size_t i = 0; i < 5; ++i)
+                V::Store(State[i], S[i]);
+        }
+
+        static void CompressSingle(uint32_t (&State)[5], const void* pData, size_t Rounds) ACCEL_NOEXCEPT {
+            SHA1_ALG::_Compress(State, pData, Rounds);
+        }
+    };
+
+}
+
+namespace accel::Hash {
+
+    //
+    //  SHA-1 of many independent messages at once. Every digest equals what SHA1_ALG gives for that message alone.
+    //  The backend is chosen at runtime:
+    //      16 lanes on AVX-512  >  SHA1_ALG on SHA-NI, one message after another  >  8 lanes on AVX2  >  4 lanes on SSE2  >  SHA1_ALG
+    //  A single SHA-NI stream keeps up with 8 AVX2 lanes and needs no batch to fill, but not with 16 AVX-512 lanes.
+    //  Batches with fewer messages than a quarter of the lanes are hashed one by one with SHA1_ALG anyway.
+    //
+    class SHA1_BATCH {
+    public:
+        static constexpr size_t BlockSizeValue = SHA1_ALG::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = SHA1_ALG::DigestSizeValue;
+    private:
+        static void _HashSequentially(const HashMessage* Messages, size_t MessageCount) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < MessageCount; ++i) {
+                auto pbData = reinterpret_cast<const uint8_t*>(Messages[i].pbData);
+                size_t Rounds = Messages[i].cbData / BlockSizeValue;
+                SHA1_ALG Alg;
+
+                Alg.Cycle(pbData, Rounds);
+                Alg.Finish(pbData + Rounds * BlockSizeValue, Messages[i].cbData % BlockSizeValue, Messages[i].cbData);
+                Alg.DigestTo(Messages[i].pbDigest);
+            }
+        }
+
+    public:
+
+        static void HashMessages(const HashMessage* Messages, size_t MessageCount) ACCEL_NOEXCEPT {
+            const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+            if (Features.AVX512F && Features.AVX512BW) {
+                Internal::MultiBufferScheduler<Internal::SHA1_LANES, Internal::LaneVectorAVX512>{}.Run(Messages, MessageCount);
+            } else if (Features.SHA && Features.SSE41) {
+                _HashSequentially(Messages, MessageCount);
+            } else if (Features.AVX2) {
+                Internal::MultiBufferScheduler<Internal::SHA1_LANES, Internal::LaneVectorAVX2>{}.Run(Messages, MessageCount);
+            } else if (Features.SSE2) {
+                Internal::MultiBufferScheduler<Internal::SHA1_LANES, Internal::LaneVectorSSE2>{}.Run(Messages, MessageCount);
+            } else {
+                _HashSequentially(Messages, MessageCount);
+            }
+        }
+    };
+
+}
@@ -1,9 +1,18 @@
 #pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
 #include "../SecureWiper.hpp"
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
 #include <memory.h>
 #include <assert.h>
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    struct SHA256_LANES;
+
+}
 
 namespace accel::Hash {
 
@@ -20,24 +29,9 @@ namespace accel::Hash {
             0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
         };
 
-        SecureWiper<Array<uint32_t, 8>> _StateWiper;
         Array<uint32_t, 8> _State;
-    public:
-        static constexpr size_t BlockSize = 64;
-        static constexpr size_t DigestSizeValue = 32;
 
-        SHA256_ALG() noexcept :
-            _StateWiper(_State),
-            _State{ 0x6A09E667u,
-                    0xBB67AE85u,
-                    0x3C6EF372u,
-                    0xA54FF53Au,
-                    0x510E527Fu,
-                    0x9B05688Cu,
-                    0x1F83D9ABu,
-                    0x5BE0CD19u } {}
-
-        void Cycle(const void* pData, size_t Rounds) noexcept {
+        static void _CompressPortable(uint32_t (&State)[8], const void* pData, size_t Rounds) noexcept {
             uint32_t Buffer[64] = {};
             uint32_t a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0;
             auto MessageBlock = reinterpret_cast<const uint32_t(*)[16]>(pData);
@@ -59,14 +53,14 @@ namespace accel::Hash {
                     Buffer[j] += Buffer[j - 16];
                 }
 
-                a = _State[0];
-                b = _State[1];
-                c = _State[2];
-                d = _State[3];
-                e = _State[4];
-                f = _State[5];
-                g = _State[6];
-                h = _State[7];
+                a = State[0];
+                b = State[1];
+                c = State[2];
+                d = State[3];
+                e = State[4];
+                f = State[5];
+                g = State[6];
+                h = State[7];
 
                 for (int j = 0; j < 64; j++) {
                     uint32_t T1 =
@@ -93,30 +87,144 @@ namespace accel::Hash {
                     a = T1 + T2;
                 }
 
-                _State[0] += a;
-                _State[1] += b;
-                _State[2] += c;
-                _State[3] += d;
-                _State[4] += e;
-                _State[5] += f;
-                _State[6] += g;
-                _State[7] += h;
+                State[0] += a;
+                State[1] += b;
+                State[2] += c;
+                State[3] += d;
+                State[4] += e;
+                State[5] += f;
+                State[6] += g;
+                State[7] += h;
+            }
+
+            SecureWipe(Buffer, sizeof(Buffer));
+        }
+
+        //
+        //  Rounds 4 * __Index ... 4 * __Index + 3 with SHA256RNDS2, two rounds per instruction.
+        //  Msg[__Index % 4] holds the 4 words for these rounds; the schedule for the words 4 rounds and 12 rounds ahead
+        //  (SHA256MSG2 and SHA256MSG1) is interleaved with the rounds, as in Intel's reference code.
+        //
+        template<size_t __Index>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("sha,sse4.1,ssse3")
+        static void _ShaNiQuadRound(__m128i& StateABEF, __m128i& StateCDGH, __m128i (&Msg)[4], const uint8_t* pBlock, __m128i ByteSwapMask) noexcept {
+            constexpr size_t Cur = __Index % 4;
+            constexpr size_t Next = (__Index + 1) % 4;
+            constexpr size_t Prev = (__Index + 3) % 4;
+
+            if constexpr (__Index < 4) {
+                Msg[Cur] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pBlock + 16 * __Index)), ByteSwapMask);
+            }
+
+            __m128i WK = _mm_add_epi32(Msg[Cur], _mm_loadu_si128(reinterpret_cast<const __m128i*>(_K + 4 * __Index)));
+            StateCDGH = _mm_sha256rnds2_epu32(StateCDGH, StateABEF, WK);
+
+            if constexpr (3 <= __Index && __Index < 15) {
+                Msg[Next] = _mm_add_epi32(Msg[Next], _mm_alignr_epi8(Msg[Cur], Msg[Prev], 4));
+                Msg[Next] = _mm_sha256msg2_epu32(Msg[Next], Msg[Cur]);
+            }
+
+            WK = _mm_shuffle_epi32(WK, 0x0E);
+            StateABEF = _mm_sha256rnds2_epu32(StateABEF, StateCDGH, WK);
+
+            if constexpr (1 <= __Index && __Index < 13) {
+                Msg[Prev] = _mm_sha256msg1_epu32(Msg[Prev], Msg[Cur]);
+            }
+        }
+
+        template<size_t... __Indexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("sha,sse4.1,ssse3")
+        static void _ShaNiBlock(__m128i& StateABEF, __m128i& StateCDGH, const uint8_t* pBlock, __m128i ByteSwapMask, std::index_sequence<__Indexes...>) noexcept {
+            __m128i Msg[4];
+            (_ShaNiQuadRound<__Indexes>(StateABEF, StateCDGH, Msg, pBlock, ByteSwapMask), ...);
+        }
+
+        //
+        //  SHA256RNDS2 wants the state as {A, B, E, F} and {C, D, G, H} (highest lane first),
+        //  so the state is shuffled into that form once per call rather than once per block.
+        //
+        ACCEL_TARGET("sha,sse4.1,ssse3")
+        static void _CompressShaNi(uint32_t (&State)[8], const void* pData, size_t Rounds) noexcept {
+            const __m128i ByteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+            auto pBlock = reinterpret_cast<const uint8_t*>(pData);
+
+            __m128i DCBA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(State + 0));
+            __m128i HGFE = _mm_loadu_si128(reinterpret_cast<const __m128i*>(State + 4));
+            __m128i CDAB = _mm_shuffle_epi32(DCBA, 0xB1);
+            __m128i EFGH = _mm_shuffle_epi32(HGFE, 0x1B);
+            __m128i StateABEF = _mm_alignr_epi8(CDAB, EFGH, 8);
+            __m128i StateCDGH = _mm_blend_epi16(EFGH, CDAB, 0xF0);
+
+            for (size_t i = 0; i < Rounds; ++i, pBlock += BlockSizeValue) {
+                __m128i SavedABEF = StateABEF;
+                __m128i SavedCDGH = StateCDGH;
+
+                _ShaNiBlock(StateABEF, StateCDGH, pBlock, ByteSwapMask, std::make_index_sequence<16>{});
+
+                StateABEF = _mm_add_epi32(StateABEF, SavedABEF);
+                StateCDGH = _mm_add_epi32(StateCDGH, SavedCDGH);
             }
+
+            __m128i FEBA = _mm_shuffle_epi32(StateABEF, 0x1B);
+            __m128i DCHG = _mm_shuffle_epi32(StateCDGH, 0xB1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(State + 0), _mm_blend_epi16(FEBA, DCHG, 0xF0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(State + 4), _mm_alignr_epi8(DCHG, FEBA, 8));
+        }
+
+        //
+        //  SHA-NI when the compiler may assume it or the host reports it (with SSSE3 and SSE4.1, which the kernel also uses);
+        //  the portable loop otherwise. SHA224_ALG shares this.
+        //
+        static void _Compress(uint32_t (&State)[8], const void* pData, size_t Rounds) noexcept {
+            if constexpr (CpuFeatureSHAAvailable) {
+                _CompressShaNi(State, pData, Rounds);
+            } else {
+                const CpuFeatureSet& Features = RuntimeCpuFeatures();
+                if (Features.SHA && Features.SSE41 && Features.SSSE3) {
+                    _CompressShaNi(State, pData, Rounds);
+                } else {
+                    _CompressPortable(State, pData, Rounds);
+                }
+            }
+        }
+
+        friend class SHA224_ALG;
+        friend struct Internal::SHA256_LANES;
+    public:
+        static constexpr size_t BlockSizeValue = 64;
+        static constexpr size_t DigestSizeValue = 32;
+        static constexpr size_t StateSizeValue = 32;
+        static constexpr size_t StateWordSizeValue = 4;
+
+        SHA256_ALG() noexcept :
+            _State{ 0x6A09E667u,
+                    0xBB67AE85u,
+                    0x3C6EF372u,
+                    0xA54FF53Au,
+                    0x510E527Fu,
+                    0x9B05688Cu,
+                    0x1F83D9ABu,
+                    0x5BE0CD19u } {}
+
+        void Cycle(const void* pData, size_t Rounds) noexcept {
+            _Compress(_State.AsCArray(), pData, Rounds);
         }
 
         //
         //  Once Finish(...) is called, this object should be treated as const
         //
         void Finish(const void* pTailData, size_t TailDataSize, uint64_t ProcessedBytes) noexcept {
-            assert(TailDataSize <= 2 * BlockSize - sizeof(uint64_t) - 1);
+            assert(TailDataSize <= 2 * BlockSizeValue - sizeof(uint64_t) - 1);
 
-            uint8_t FormattedTailData[2 * BlockSize] = {};
+            uint8_t FormattedTailData[2 * BlockSizeValue] = {};
             size_t Rounds;
 
             memcpy(FormattedTailData, pTailData, TailDataSize);
             FormattedTailData[TailDataSize] = 0x80;
-            Rounds = TailDataSize >= BlockSize - sizeof(uint64_t) ? 2 : 1;
-            *reinterpret_cast<uint64_t*>(FormattedTailData + (Rounds > 1 ? (2 * BlockSize - sizeof(uint64_t)) : (BlockSize - sizeof(uint64_t)))) =
+            Rounds = TailDataSize >= BlockSizeValue - sizeof(uint64_t) ? 2 : 1;
+            *reinterpret_cast<uint64_t*>(FormattedTailData + (Rounds > 1 ? (2 * BlockSizeValue - sizeof(uint64_t)) : (BlockSizeValue - sizeof(uint64_t)))) =
                     ByteSwap<uint64_t>(ProcessedBytes * 8);
 
             Cycle(FormattedTailData, Rounds);
@@ -137,8 +245,30 @@ namespace accel::Hash {
             _State[7] = ByteSwap(_State[7]);
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: H0 ... H7 as 32-bit words.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~SHA256_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
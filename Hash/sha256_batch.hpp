@@ -0,0 +1,141 @@
+#pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
+#include "sha256.hpp"
+#include "Internal/lanes.hpp"
+#include "Internal/multibuffer.hpp"
+#include <utility>
+
+namespace accel::Hash::Internal {
+
+    //
+    //  SHA-256 on lane vectors, for MultiBufferScheduler.
+    //  The 64 rounds are unrolled; instead of moving a..h around, round j names them by index (8 - j % 8) % 8 ....
+    //  The message schedule is kept in a 16-word ring.
+    //
+    struct SHA256_LANES {
+        using WordType = uint32_t;
+        static constexpr size_t StateWordsValue = 8;
+        static constexpr size_t BlockSizeValue = SHA256_ALG::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = SHA256_ALG::DigestSizeValue;
+        static constexpr bool BigEndianValue = true;
+        static constexpr uint32_t InitialStateValue[8] = {
+            0x6A09E667u, 0xBB67AE85u, 0x3C6EF372u, 0xA54FF53Au, 0x510E527Fu, 0x9B05688Cu, 0x1F83D9ABu, 0x5BE0CD19u
+        };
+
+        template<typename __LaneVectorType, size_t __Round>
+        ACCEL_FORCEINLINE
+        static void _Round(typename __LaneVectorType::VectorType (&S)[8], typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            constexpr size_t a = (8 - __Round % 8) % 8;
+            constexpr size_t b = (a + 1) % 8;
+            constexpr size_t c = (a + 2) % 8;
+            constexpr size_t d = (a + 3) % 8;
+            constexpr size_t e = (a + 4) % 8;
+            constexpr size_t f = (a + 5) % 8;
+            constexpr size_t g = (a + 6) % 8;
+            constexpr size_t h = (a + 7) % 8;
+
+            if constexpr (__Round >= 16) {
+                auto& W2 = W[(__Round + 14) % 16];
+                auto& W15 = W[(__Round + 1) % 16];
+                auto s0 = V::Xor3(V::template RotateRight<7>(W15), V::template RotateRight<18>(W15), V::template ShiftRight<3>(W15));
+                auto s1 = V::Xor3(V::template RotateRight<17>(W2), V::template RotateRight<19>(W2), V::template ShiftRight<10>(W2));
+                W[__Round % 16] = V::Add(V::Add(W[__Round % 16], s0), V::Add(W[(__Round + 9) % 16], s1));
+            }
+
+            auto T1 = V::Add(V::Add(S[h], V::Xor3(V::template RotateRight<6>(S[e]), V::template RotateRight<11>(S[e]), V::template RotateRight<25>(S[e]))),
+                             V::Add(V::Choose(S[e], S[f], S[g]), V::Add(V::Set1(SHA256_ALG::_K[__Round]), W[__Round % 16])));
+            auto T2 = V::Add(V::Xor3(V::template RotateRight<2>(S[a]), V::template RotateRight<13>(S[a]), V::template RotateRight<22>(S[a])),
+                             V::Majority(S[a], S[b], S[c]));
+
+            S[d] = V::Add(S[d], T1);
+            S[h] = V::Add(T1, T2);
+        }
+
+        template<typename __LaneVectorType, size_t... __Rounds>
+        ACCEL_FORCEINLINE
+        static void _Rounds(typename __LaneVectorType::VectorType (&S)[8], typename __LaneVectorType::VectorType (&W)[16], std::index_sequence<__Rounds...>) ACCEL_NOEXCEPT {
+            (_Round<__LaneVectorType, __Rounds>(S, W), ...);
+        }
+
+        //
+        //  One block on every lane, with the state and the message words already in vectors.
+        //  W is used as the schedule ring and is clobbered.
+        //
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void CompressWords(typename __LaneVectorType::VectorType (&State)[8], typename __LaneVectorType::VectorType (&W)[16]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType S[8];
+
+            for (size_t i = 0; i < 8; ++i)
+                S[i] = State[i];
+
+            _Rounds<V>(S, W, std::make_index_sequence<64>{});
+
+            for (size_t i = 0; i < 8; ++i)
+                State[i] = V::Add(State[i], S[i]);
+        }
+
+        template<typename __LaneVectorType>
+        ACCEL_FORCEINLINE
+        static void Compress(uint32_t (&State)[8][__LaneVectorType::LanesValue], const uint8_t* (&Blocks)[__LaneVectorType::LanesValue]) ACCEL_NOEXCEPT {
+            using V = __LaneVectorType;
+            typename V::VectorType S[8];
+            typename V::VectorType W[16];
+
+            V::template LoadMessage<true>(W, Blocks);
+
+            for (size_t i = 0; i < 8; ++i)
+                S[i] = V::Load(State[i]);
+
+            CompressWords<V>(S, W);
+
+            for (size_t i = 0; i < 8; ++i)
+                V::Store(State[i], S[i]);
+        }
+
+        static void CompressSingle(uint32_t (&State)[8], const void* pData, size_t Rounds) ACCEL_NOEXCEPT {
+            SHA256_ALG::_Compress(State, pData, Rounds);
+        }
+    };
+
+}
+
+namespace accel::Hash {
+
+    //
+    //  SHA-256 of many independent messages at once. Every digest equals what SHA256_ALG gives for that message alone.
+    //  The backend is chosen at runtime:
+    //      16 lanes on AVX-512  >  SHA256_ALG on SHA-NI, one message after another  >  8 lanes on AVX2  >  SHA256_ALG
+    //  A single SHA-NI stream beats 8 AVX2 lanes, but not 16 AVX-512 lanes.
+    //  Batches with fewer messages than a quarter of the lanes are hashed one by one with SHA256_ALG anyway.
+    //
+    class SHA256_BATCH {
+    public:
+        static constexpr size_t BlockSizeValue = SHA256_ALG::BlockSizeValue;
+        static constexpr size_t DigestSizeValue = SHA256_ALG::DigestSizeValue;
+
+        static void HashMessages(const HashMessage* Messages, size_t MessageCount) ACCEL_NOEXCEPT {
+            const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+            if (Features.AVX512F && Features.AVX512BW) {
+                Internal::MultiBufferScheduler<Internal::SHA256_LANES, Internal::LaneVectorAVX512>{}.Run(Messages, MessageCount);
+            } else if (Features.AVX2 && !(Features.SHA && Features.SSE41)) {
+                Internal::MultiBufferScheduler<Internal::SHA256_LANES, Internal::LaneVectorAVX2>{}.Run(Messages, MessageCount);
+            } else {
+                for (size_t i = 0; i < MessageCount; ++i) {
+                    auto pbData = reinterpret_cast<const uint8_t*>(Messages[i].pbData);
+                    size_t Rounds = Messages[i].cbData / BlockSizeValue;
+                    SHA256_ALG Alg;
+
+                    Alg.Cycle(pbData, Rounds);
+                    Alg.Finish(pbData + Rounds * BlockSizeValue, Messages[i].cbData % BlockSizeValue, Messages[i].cbData);
+                    Alg.DigestTo(Messages[i].pbDigest);
+                }
+            }
+        }
+    };
+
+}
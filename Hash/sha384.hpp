@@ -22,14 +22,14 @@ namespace accel::Hash {
             0x28DB77F523047D84, 0x32CAAB7B40C72493, 0x3C9EBE0A15C9BEBC, 0x431D67C49C100D4C, 0x4CC5D4BECB3E42B6, 0x597F299CFC657E2A, 0x5FCB6FAB3AD6FAEC, 0x6C44198C4A475817
         };
 
-        SecureWiper<Array<uint64_t, 8>> _StateWiper;
         Array<uint64_t, 8> _State;
     public:
         static constexpr size_t BlockSizeValue = 128;
         static constexpr size_t DigestSizeValue = 48;
+        static constexpr size_t StateSizeValue = 64;
+        static constexpr size_t StateWordSizeValue = 8;
 
         SHA384_ALG() noexcept :
-            _StateWiper(_State),
             _State { 0xCBBB9D5DC1059ED8u,
                      0x629A292A367CD507u,
                      0x9159015A3070DD17u,
@@ -144,8 +144,30 @@ namespace accel::Hash {
             _State[7] = ByteSwap(_State[7]);
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: all eight 64-bit words H0 ... H7, including the two the digest drops.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~SHA384_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
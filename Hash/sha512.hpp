@@ -5,6 +5,12 @@
 #include <memory.h>
 #include <assert.h>
 
+namespace accel::Hash::Internal {
+
+    struct SHA512_LANES;
+
+}
+
 namespace accel::Hash {
 
     class SHA512_ALG {
@@ -22,24 +28,9 @@ namespace accel::Hash {
             0x28DB77F523047D84, 0x32CAAB7B40C72493, 0x3C9EBE0A15C9BEBC, 0x431D67C49C100D4C, 0x4CC5D4BECB3E42B6, 0x597F299CFC657E2A, 0x5FCB6FAB3AD6FAEC, 0x6C44198C4A475817
         };
 
-        SecureWiper<Array<uint64_t, 8>> _StateWiper;
         Array<uint64_t, 8> _State;
-    public:
-        static constexpr size_t BlockSizeValue = 128;
-        static constexpr size_t DigestSizeValue = 64;
 
-        SHA512_ALG() noexcept :
-            _StateWiper(_State),
-            _State{ 0x6A09E667F3BCC908u,
-                    0xBB67AE8584CAA73Bu,
-                    0x3C6EF372FE94F82Bu,
-                    0xA54FF53A5F1D36F1u,
-                    0x510E527FADE682D1u,
-                    0x9B05688C2B3E6C1Fu,
-                    0x1F83D9ABFB41BD6Bu,
-                    0x5BE0CD19137E2179u } {}
-
-        void Cycle(const void* pData, size_t Rounds) noexcept {
+        static void _Compress(uint64_t (&State)[8], const void* pData, size_t Rounds) noexcept {
             uint64_t Buffer[80] = {};
             uint64_t a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0;
             auto MessageBlock = reinterpret_cast<const uint64_t(*)[16]>(pData);
@@ -61,14 +52,14 @@ namespace accel::Hash {
                     Buffer[j] += Buffer[j - 16];
                 }
 
-                a = _State[0];
-                b = _State[1];
-                c = _State[2];
-                d = _State[3];
-                e = _State[4];
-                f = _State[5];
-                g = _State[6];
-                h = _State[7];
+                a = State[0];
+                b = State[1];
+                c = State[2];
+                d = State[3];
+                e = State[4];
+                f = State[5];
+                g = State[6];
+                h = State[7];
 
                 for (int j = 0; j < 80; ++j) {
                     uint64_t T1 =
@@ -94,17 +85,38 @@ namespace accel::Hash {
                     a = T1 + T2;
                 }
 
-                _State[0] += a;
-                _State[1] += b;
-                _State[2] += c;
-                _State[3] += d;
-                _State[4] += e;
-                _State[5] += f;
-                _State[6] += g;
-                _State[7] += h;
+                State[0] += a;
+                State[1] += b;
+                State[2] += c;
+                State[3] += d;
+                State[4] += e;
+                State[5] += f;
+                State[6] += g;
+                State[7] += h;
             }
         }
 
+        friend struct Internal::SHA512_LANES;
+    public:
+        static constexpr size_t BlockSizeValue = 128;
+        static constexpr size_t DigestSizeValue = 64;
+        static constexpr size_t StateSizeValue = 64;
+        static constexpr size_t StateWordSizeValue = 8;
+
+        SHA512_ALG() noexcept :
+            _State{ 0x6A09E667F3BCC908u,
+                    0xBB67AE8584CAA73Bu,
+                    0x3C6EF372FE94F82Bu,
+                    0xA54FF53A5F1D36F1u,
+                    0x510E527FADE682D1u,
+                    0x9B05688C2B3E6C1Fu,
+                    0x1F83D9ABFB41BD6Bu,
+                    0x5BE0CD19137E2179u } {}
+
+        void Cycle(const void* pData, size_t Rounds) noexcept {
+            _Compress(_State.AsCArray(), pData, Rounds);
+        }
+
         //
         //  Once Finish(...) is called, this object should be treated as const
         //
@@ -144,8 +156,30 @@ namespace accel::Hash {
             _State[7] = ByteSwap(_State[7]);
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: H0 ... H7 as 64-bit words.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~SHA512_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
@@ -3,6 +3,7 @@
 #include "../SecureWiper.hpp"
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
+#include <memory.h>
 #include <assert.h>
 
 namespace accel::Hash {
@@ -10,7 +11,6 @@ namespace accel::Hash {
     class SM3_ALG {
     private:
 
-        SecureWiper<Array<uint32_t, 8>> _StateWiper;
         Array<uint32_t, 8> _State;
 
         // rename _T to _T_Constant, 
@@ -144,9 +144,10 @@ namespace accel::Hash {
     public:
         static constexpr size_t BlockSizeValue = 64;
         static constexpr size_t DigestSizeValue = 32;
+        static constexpr size_t StateSizeValue = 32;
+        static constexpr size_t StateWordSizeValue = 4;
 
         SM3_ALG() noexcept :
-            _StateWiper(_State),
             _State{ 0x7380166fu,
                     0x4914b2b9u,
                     0x172442d7u,
@@ -199,8 +200,30 @@ namespace accel::Hash {
             _State[7] = ByteSwap(_State[7]);
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: V0 ... V7 as 32-bit words.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~SM3_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
@@ -3,6 +3,7 @@
 #include "../SecureWiper.hpp"
 #include "../Array.hpp"
 #include "../Intrinsic.hpp"
+#include <memory.h>
 #include <assert.h>
 
 namespace accel::Hash {
@@ -535,7 +536,6 @@ namespace accel::Hash {
         static_assert(__Bits == 128 || __Bits == 160 || __Bits == 192, "TIGER_ALG failure! Unsupported bits.");
     private:
 
-        SecureWiper<Array<uint64_t, 3>> _StateWiper;
         Array<uint64_t, 3> _State;
 
         template<unsigned __mul>
@@ -590,9 +590,10 @@ namespace accel::Hash {
     public:
         static constexpr size_t BlockSizeValue = 64;
         static constexpr size_t DigestSizeValue = __Bits / 8;
+        static constexpr size_t StateSizeValue = 24;
+        static constexpr size_t StateWordSizeValue = 8;
 
         TIGER_ALG() noexcept :
-            _StateWiper(_State),
             _State{ 0x0123456789ABCDEFull,
                     0xFEDCBA9876543210ull,
                     0xF096A5B4C3B2E187ull } {}
@@ -650,8 +651,30 @@ namespace accel::Hash {
             }
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, DigestSizeValue>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: a, b, c as 64-bit words, whatever the digest length.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~TIGER_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
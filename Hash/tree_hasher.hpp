@@ -0,0 +1,449 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../MemoryAccess.hpp"
+#include "../ThreadPool.hpp"
+#include "md5_batch.hpp"
+#include "sha1_batch.hpp"
+#include "sha256_batch.hpp"
+#include "Internal/multibuffer.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+#include <type_traits>
+#include <vector>
+
+namespace accel::Hash::Internal {
+
+    //
+    //  The batch hasher that hashes many leaves of __AlgType at once, or void if there is none.
+    //
+    template<typename __AlgType>
+    struct TreeBatchOf {
+        using Type = void;
+    };
+
+    template<>
+    struct TreeBatchOf<MD5_ALG> {
+        using Type = MD5_BATCH;
+    };
+
+    template<>
+    struct TreeBatchOf<SHA1_ALG> {
+        using Type = SHA1_BATCH;
+    };
+
+    template<>
+    struct TreeBatchOf<SHA256_ALG> {
+        using Type = SHA256_BATCH;
+    };
+
+}
+
+namespace accel::Hash {
+
+    //
+    //  Tree hash over any hash algorithm H, for inputs too large for one hash stream.
+    //
+    //  The input is cut into chunks of __ChunkSize bytes; the last one may be shorter, and an empty input is one
+    //  empty chunk. Leaves and nodes are, with `||` for concatenation:
+    //      leaf        H(chunk)
+    //      node        H(0x01 || left || right)
+    //      root        H(0x02 || top || total length as uint64 little-endian)
+    //  The leaves form a left-balanced binary tree, as in RFC 6962/9162: a tree of n > 1 leaves is a perfect tree of
+    //  the largest power of two k < n leaves on the left, and a tree of the other n - k leaves on the right.
+    //  Its top node is the `top` of the root, which binds the total length, so the tree shape is never ambiguous.
+    //
+    //  Leaves are hashed in parallel on a ThreadPool, if one is given, and several at a time with the batch hasher
+    //  (MD5_BATCH, SHA1_BATCH, SHA256_BATCH) where __AlgType has one. Nodes are merged as soon as a perfect subtree
+    //  is complete, so at most one digest per level is kept while streaming.
+    //
+    //  A chunk can be checked against a root on its own with VerifyChunk, given its audit path: the digests of
+    //  the sibling subtrees from the leaf up (RFC 9162, section 2.1.3). BuildProof makes the audit path from the
+    //  leaf digests, which HashLeaves computes and which can be kept next to the data (DigestSizeValue bytes per chunk).
+    //
+    template<typename __AlgType, size_t __ChunkSize = 1024 * 1024>
+    class TreeHasher {
+    public:
+        static constexpr size_t ChunkSizeValue = __ChunkSize;
+        static constexpr size_t DigestSizeValue = __AlgType::DigestSizeValue;
+
+        static_assert(__ChunkSize > 0 && __ChunkSize % __AlgType::BlockSizeValue == 0, "TreeHasher failure! The chunk size must be whole blocks.");
+    private:
+        using _BatchType = typename Internal::TreeBatchOf<__AlgType>::Type;
+        using _Digest = Array<uint8_t, DigestSizeValue>;
+
+        static constexpr uint8_t _NodePrefix = 0x01;
+        static constexpr uint8_t _RootPrefix = 0x02;
+        static constexpr size_t _MaxChunksPerTask = 16;
+        static constexpr size_t _MaxChunksPerRound = 1024;
+
+        //
+        //  Perfect subtrees of the leaves pushed so far, largest first; at most one per level.
+        //
+        struct _NodeStack {
+            _Digest Nodes[64];
+            size_t Depth;
+            uint64_t LeafCount;
+
+            _NodeStack() ACCEL_NOEXCEPT : Depth(0), LeafCount(0) {}
+
+            void Push(const uint8_t* pbLeafDigest) ACCEL_NOEXCEPT {
+                Nodes[Depth++].LoadFrom(pbLeafDigest);
+                ++LeafCount;
+
+                for (uint64_t c = LeafCount; (c & 1) == 0; c >>= 1) {
+                    _HashNode(Nodes[Depth - 2].AsCArray(), Nodes[Depth - 1].AsCArray(), Nodes[Depth - 2].AsCArray());
+                    --Depth;
+                }
+            }
+
+            //
+            //  The top node of the tree, with nodes for the smaller subtrees folded in from the right.
+            //
+            _Digest Top() const ACCEL_NOEXCEPT {
+                _Digest Result = Nodes[Depth - 1];
+
+                for (size_t i = Depth - 1; i-- > 0;)
+                    _HashNode(Nodes[i].AsCArray(), Result.AsCArray(), Result.AsCArray());
+
+                return Result;
+            }
+        };
+
+        ThreadPool* _pPool;
+        _NodeStack _Stack;
+        uint64_t _ProcessedBytes;
+        std::vector<uint8_t> _ChunkBuffer;      // the chunk that straddles Update calls
+        size_t _ChunkLength;
+        std::vector<uint8_t> _LeafDigests;      // scratch for one round of leaves
+
+        //
+        //  `pbData` may be null when `cbData` is 0, e.g. the empty chunk of an empty input, whose buffer was
+        //  never allocated. Finish copies from it, so it is swapped for a valid address first.
+        //
+        static void _HashWhole(const uint8_t* pbData, size_t cbData, uint8_t* pbDigest) ACCEL_NOEXCEPT {
+            static constexpr uint8_t EmptyChunk[1] = {};
+            size_t Rounds = cbData / __AlgType::BlockSizeValue;
+            __AlgType Alg;
+
+            if (cbData == 0)
+                pbData = EmptyChunk;
+            if (Rounds)
+                Alg.Cycle(pbData, Rounds);
+            Alg.Finish(pbData + Rounds * __AlgType::BlockSizeValue, cbData % __AlgType::BlockSizeValue, cbData);
+            Alg.DigestTo(pbDigest);
+        }
+
+        //
+        //  `pbResult` may alias either child.
+        //
+        static void _HashNode(const uint8_t* pbLeft, const uint8_t* pbRight, uint8_t* pbResult) ACCEL_NOEXCEPT {
+            uint8_t Node[1 + 2 * DigestSizeValue];
+
+            Node[0] = _NodePrefix;
+            memcpy(Node + 1, pbLeft, DigestSizeValue);
+            memcpy(Node + 1 + DigestSizeValue, pbRight, DigestSizeValue);
+            _HashWhole(Node, sizeof(Node), pbResult);
+        }
+
+        static void _HashRoot(const _Digest& Top, uint64_t TotalLength, uint8_t* pbRoot) ACCEL_NOEXCEPT {
+            uint8_t Root[1 + DigestSizeValue + sizeof(uint64_t)];
+
+            Root[0] = _RootPrefix;
+            memcpy(Root + 1, Top.AsCArray(), DigestSizeValue);
+            if constexpr (NativeEndianness == Endianness::BigEndian) {
+                TotalLength = ByteSwap<uint64_t>(TotalLength);
+            }
+            MemoryWriteAs<uint64_t>(Root + 1 + DigestSizeValue, TotalLength);
+            _HashWhole(Root, sizeof(Root), pbRoot);
+        }
+
+        //
+        //  Digests of `ChunkCount` whole chunks at `pbData`, in parallel on `pPool` if it is not null.
+        //
+        static void _HashChunks(ThreadPool* pPool, const uint8_t* pbData, size_t ChunkCount, uint8_t* pbDigests) ACCEL_NOEXCEPT {
+            if (ChunkCount == 0)
+                return;
+
+            size_t Threads = pPool ? pPool->ThreadCount() : 1;
+            size_t ChunksPerTask = (ChunkCount + Threads - 1) / Threads;
+
+            if (ChunksPerTask > _MaxChunksPerTask)
+                ChunksPerTask = _MaxChunksPerTask;
+
+            auto Task = [=](size_t TaskIndex) {
+                size_t First = TaskIndex * ChunksPerTask;
+                size_t Count = ChunkCount - First < ChunksPerTask ? ChunkCount - First : ChunksPerTask;
+
+                if constexpr (std::is_void_v<_BatchType>) {
+                    for (size_t i = First; i < First + Count; ++i)
+                        _HashWhole(pbData + i * __ChunkSize, __ChunkSize, pbDigests + i * DigestSizeValue);
+                } else {
+                    HashMessage Messages[_MaxChunksPerTask];
+
+                    for (size_t i = 0; i < Count; ++i)
+                        Messages[i] = HashMessage{ pbData + (First + i) * __ChunkSize, __ChunkSize, pbDigests + (First + i) * DigestSizeValue };
+                    _BatchType::HashMessages(Messages, Count);
+                }
+            };
+
+            size_t TaskCount = (ChunkCount + ChunksPerTask - 1) / ChunksPerTask;
+
+            if (pPool) {
+                pPool->Run(TaskCount, Task);
+            } else {
+                for (size_t i = 0; i < TaskCount; ++i)
+                    Task(i);
+            }
+        }
+
+        //
+        //  The top node of the tree over `LeafCount` leaf digests.
+        //
+        static _Digest _SubtreeTop(const uint8_t* pbLeafDigests, uint64_t LeafCount) ACCEL_NOEXCEPT {
+            _NodeStack Stack;
+
+            for (uint64_t i = 0; i < LeafCount; ++i)
+                Stack.Push(pbLeafDigests + i * DigestSizeValue);
+
+            return Stack.Top();
+        }
+
+        static uint64_t _LargestPowerOf2Below(uint64_t n) ACCEL_NOEXCEPT {
+            uint64_t k = 1;
+            while (k * 2 < n)
+                k *= 2;
+            return k;
+        }
+
+    public:
+
+        //
+        //  `pPool` is borrowed, and must outlive this object and not run other jobs during Update.
+        //  With no pool, leaves are hashed on the calling thread.
+        //
+        explicit TreeHasher(ThreadPool* pPool = nullptr) :
+            _pPool(pPool),
+            _ProcessedBytes(0),
+            _ChunkLength(0) {}
+
+        static constexpr uint64_t LeafCount(uint64_t TotalLength) ACCEL_NOEXCEPT {
+            return TotalLength == 0 ? 1 : (TotalLength - 1) / __ChunkSize + 1;
+        }
+
+        //
+        //  Forget everything fed so far and start a new input.
+        //
+        void Reset() ACCEL_NOEXCEPT {
+            _Stack = _NodeStack{};
+            _ProcessedBytes = 0;
+            _ChunkLength = 0;
+        }
+
+        //
+        //  Whole chunks are hashed in place; only a chunk that straddles two Update calls is staged.
+        //  Throws std::bad_alloc if the staging or scratch buffers cannot be allocated.
+        //
+        void Update(const void* pData, size_t DataSize) {
+            auto pBytes = reinterpret_cast<const uint8_t*>(pData);
+
+            _ProcessedBytes += DataSize;
+
+            if (_ChunkLength) {
+                size_t BytesToCopy = __ChunkSize - _ChunkLength;
+
+                if (DataSize < BytesToCopy) {
+                    memcpy(_ChunkBuffer.data() + _ChunkLength, pBytes, DataSize);
+                    _ChunkLength += DataSize;
+                    return;
+                }
+
+                uint8_t LeafDigest[DigestSizeValue];
+
+                memcpy(_ChunkBuffer.data() + _ChunkLength, pBytes, BytesToCopy);
+                _HashWhole(_ChunkBuffer.data(), __ChunkSize, LeafDigest);
+                _Stack.Push(LeafDigest);
+                _ChunkLength = 0;
+                pBytes += BytesToCopy;
+                DataSize -= BytesToCopy;
+            }
+
+            size_t ChunkCount = DataSize / __ChunkSize;
+            while (ChunkCount) {
+                size_t RoundChunks = ChunkCount < _MaxChunksPerRound ? ChunkCount : _MaxChunksPerRound;
+
+                _LeafDigests.resize(RoundChunks * DigestSizeValue);
+                _HashChunks(_pPool, pBytes, RoundChunks, _LeafDigests.data());
+                for (size_t i = 0; i < RoundChunks; ++i)
+                    _Stack.Push(_LeafDigests.data() + i * DigestSizeValue);
+
+                pBytes += RoundChunks * __ChunkSize;
+                DataSize -= RoundChunks * __ChunkSize;
+                ChunkCount -= RoundChunks;
+            }
+
+            if (DataSize) {
+                _ChunkBuffer.resize(__ChunkSize);
+                memcpy(_ChunkBuffer.data(), pBytes, DataSize);
+                _ChunkLength = DataSize;
+            }
+        }
+
+        //
+        //  Write the DigestSizeValue-byte root to `pbRoot`. More data may follow.
+        //
+        void DigestTo(void* pbRoot) const ACCEL_NOEXCEPT {
+            _NodeStack Stack = _Stack;
+
+            if (_ChunkLength || _ProcessedBytes == 0) {
+                uint8_t LeafDigest[DigestSizeValue];
+                _HashWhole(_ChunkBuffer.data(), _ChunkLength, LeafDigest);
+                Stack.Push(LeafDigest);
+            }
+
+            _HashRoot(Stack.Top(), _ProcessedBytes, reinterpret_cast<uint8_t*>(pbRoot));
+        }
+
+        //
+        //  Write the LeafCount(cbData) leaf digests of a whole input to `pbLeafDigests`, e.g. to keep them for
+        //  BuildProof. `pPool` may be null.
+        //
+        static void HashLeaves(const void* pbData, size_t cbData, void* pbLeafDigests, ThreadPool* pPool = nullptr) ACCEL_NOEXCEPT {
+            auto pbBytes = reinterpret_cast<const uint8_t*>(pbData);
+            auto pbDigests = reinterpret_cast<uint8_t*>(pbLeafDigests);
+            size_t WholeChunks = cbData / __ChunkSize;
+
+            _HashChunks(pPool, pbBytes, WholeChunks, pbDigests);
+            if (cbData % __ChunkSize || cbData == 0)
+                _HashWhole(pbBytes + WholeChunks * __ChunkSize, cbData % __ChunkSize, pbDigests + WholeChunks * DigestSizeValue);
+        }
+
+        //
+        //  The root of an input of `TotalLength` bytes from its LeafCount(TotalLength) leaf digests.
+        //
+        static void RootFromLeaves(const void* pbLeafDigests, uint64_t TotalLength, void* pbRoot) ACCEL_NOEXCEPT {
+            _HashRoot(_SubtreeTop(reinterpret_cast<const uint8_t*>(pbLeafDigests), LeafCount(TotalLength)),
+                      TotalLength,
+                      reinterpret_cast<uint8_t*>(pbRoot));
+        }
+
+        //
+        //  Size in bytes of the audit path of chunk `ChunkIndex`, a multiple of DigestSizeValue.
+        //
+        static size_t ProofSize(uint64_t ChunkIndex, uint64_t TotalLength) ACCEL_NOEXCEPT {
+            uint64_t n = LeafCount(TotalLength);
+            size_t Levels = 0;
+
+            if (ChunkIndex >= n)
+                return 0;
+
+            while (n > 1) {
+                uint64_t k = _LargestPowerOf2Below(n);
+
+                if (ChunkIndex < k) {
+                    n = k;
+                } else {
+                    ChunkIndex -= k;
+                    n -= k;
+                }
+
+                ++Levels;
+            }
+
+            return Levels * DigestSizeValue;
+        }
+
+        //
+        //  Write the audit path of chunk `ChunkIndex`, ProofSize(ChunkIndex, TotalLength) bytes, to `pbProof`,
+        //  from the LeafCount(TotalLength) leaf digests. Returns false if the chunk does not exist.
+        //
+        ACCEL_NODISCARD
+        static bool BuildProof(const void* pbLeafDigests, uint64_t TotalLength, uint64_t ChunkIndex, void* pbProof) ACCEL_NOEXCEPT {
+            auto pbLeaves = reinterpret_cast<const uint8_t*>(pbLeafDigests);
+            uint64_t n = LeafCount(TotalLength);
+            size_t Levels = ProofSize(ChunkIndex, TotalLength) / DigestSizeValue;
+
+            if (ChunkIndex >= n)
+                return false;
+
+            //
+            //  Walk down from the top; the sibling met at depth d is entry Levels - 1 - d of the bottom-up path.
+            //
+            for (size_t d = 0; n > 1; ++d) {
+                uint64_t k = _LargestPowerOf2Below(n);
+                _Digest Sibling;
+
+                if (ChunkIndex < k) {
+                    Sibling = _SubtreeTop(pbLeaves + k * DigestSizeValue, n - k);
+                    n = k;
+                } else {
+                    Sibling = _SubtreeTop(pbLeaves, k);
+                    pbLeaves += k * DigestSizeValue;
+                    ChunkIndex -= k;
+                    n -= k;
+                }
+
+                Sibling.StoreTo(reinterpret_cast<uint8_t*>(pbProof) + (Levels - 1 - d) * DigestSizeValue);
+            }
+
+            return true;
+        }
+
+        //
+        //  Check chunk `ChunkIndex` of an input of `TotalLength` bytes against its root, with the chunk's audit path.
+        //  Returns false if the chunk, its size, the path or the root do not match.
+        //
+        ACCEL_NODISCARD
+        static bool VerifyChunk(const void* pbChunk, size_t cbChunk, uint64_t ChunkIndex, uint64_t TotalLength,
+                                const void* pbProof, size_t cbProof, const void* pbRoot) ACCEL_NOEXCEPT {
+            uint64_t n = LeafCount(TotalLength);
+
+            if (ChunkIndex >= n || cbProof != ProofSize(ChunkIndex, TotalLength))
+                return false;
+            if (cbChunk != (ChunkIndex + 1 < n ? __ChunkSize : TotalLength - ChunkIndex * __ChunkSize))
+                return false;
+
+            //
+            //  RFC 9162, section 2.1.3.2.
+            //
+            auto pbPath = reinterpret_cast<const uint8_t*>(pbProof);
+            uint64_t fn = ChunkIndex;
+            uint64_t sn = n - 1;
+            uint8_t Node[DigestSizeValue];
+            uint8_t Root[DigestSizeValue];
+
+            _HashWhole(reinterpret_cast<const uint8_t*>(pbChunk), cbChunk, Node);
+
+            for (size_t i = 0; i < cbProof / DigestSizeValue; ++i) {
+                const uint8_t* pbSibling = pbPath + i * DigestSizeValue;
+
+                if (sn == 0)
+                    return false;
+
+                if ((fn & 1) || fn == sn) {
+                    _HashNode(pbSibling, Node, Node);
+                    while ((fn & 1) == 0 && fn != 0) {
+                        fn >>= 1;
+                        sn >>= 1;
+                    }
+                } else {
+                    _HashNode(Node, pbSibling, Node);
+                }
+
+                fn >>= 1;
+                sn >>= 1;
+            }
+
+            if (sn != 0)
+                return false;
+
+            _Digest Top;
+            Top.LoadFrom(Node);
+            _HashRoot(Top, TotalLength, Root);
+            return memcmp(Root, pbRoot, DigestSizeValue) == 0;
+        }
+    };
+
+}
+
@@ -11,6 +11,8 @@ namespace accel::Hash {
     public:
         static constexpr size_t BlockSizeValue = 64;
         static constexpr size_t DigestSizeValue = 64;
+        static constexpr size_t StateSizeValue = 64;
+        static constexpr size_t StateWordSizeValue = 1;
     private:
         static inline uint8_t SBox[256] = {
             0x18, 0x23, 0xc6, 0xE8, 0x87, 0xB8, 0x01, 0x4F, 0x36, 0xA6, 0xd2, 0xF5, 0x79, 0x6F, 0x91, 0x52,
@@ -677,14 +679,14 @@ namespace accel::Hash {
             r[2] = _mm_xor_si128(m1[2], m2[2]);
             r[3] = _mm_xor_si128(m1[3], m2[3]);
 #else
-            r.AsCArray<uint64_t[8]>()[0] = m1.AsCArray<uint64_t[8]>()[0] ^ m2.AsCArray<uint64_t[8]>()[0];
-            r.AsCArray<uint64_t[8]>()[1] = m1.AsCArray<uint64_t[8]>()[1] ^ m2.AsCArray<uint64_t[8]>()[1];
-            r.AsCArray<uint64_t[8]>()[2] = m1.AsCArray<uint64_t[8]>()[2] ^ m2.AsCArray<uint64_t[8]>()[2];
-            r.AsCArray<uint64_t[8]>()[3] = m1.AsCArray<uint64_t[8]>()[3] ^ m2.AsCArray<uint64_t[8]>()[3];
-            r.AsCArray<uint64_t[8]>()[4] = m1.AsCArray<uint64_t[8]>()[4] ^ m2.AsCArray<uint64_t[8]>()[4];
-            r.AsCArray<uint64_t[8]>()[5] = m1.AsCArray<uint64_t[8]>()[5] ^ m2.AsCArray<uint64_t[8]>()[5];
-            r.AsCArray<uint64_t[8]>()[6] = m1.AsCArray<uint64_t[8]>()[6] ^ m2.AsCArray<uint64_t[8]>()[6];
-            r.AsCArray<uint64_t[8]>()[7] = m1.AsCArray<uint64_t[8]>()[7] ^ m2.AsCArray<uint64_t[8]>()[7];
+            r.AsCArrayOf<uint64_t[8]>()[0] = m1.AsCArrayOf<uint64_t[8]>()[0] ^ m2.AsCArrayOf<uint64_t[8]>()[0];
+            r.AsCArrayOf<uint64_t[8]>()[1] = m1.AsCArrayOf<uint64_t[8]>()[1] ^ m2.AsCArrayOf<uint64_t[8]>()[1];
+            r.AsCArrayOf<uint64_t[8]>()[2] = m1.AsCArrayOf<uint64_t[8]>()[2] ^ m2.AsCArrayOf<uint64_t[8]>()[2];
+            r.AsCArrayOf<uint64_t[8]>()[3] = m1.AsCArrayOf<uint64_t[8]>()[3] ^ m2.AsCArrayOf<uint64_t[8]>()[3];
+            r.AsCArrayOf<uint64_t[8]>()[4] = m1.AsCArrayOf<uint64_t[8]>()[4] ^ m2.AsCArrayOf<uint64_t[8]>()[4];
+            r.AsCArrayOf<uint64_t[8]>()[5] = m1.AsCArrayOf<uint64_t[8]>()[5] ^ m2.AsCArrayOf<uint64_t[8]>()[5];
+            r.AsCArrayOf<uint64_t[8]>()[6] = m1.AsCArrayOf<uint64_t[8]>()[6] ^ m2.AsCArrayOf<uint64_t[8]>()[6];
+            r.AsCArrayOf<uint64_t[8]>()[7] = m1.AsCArrayOf<uint64_t[8]>()[7] ^ m2.AsCArrayOf<uint64_t[8]>()[7];
 #endif
             return r;
         }
@@ -700,14 +702,14 @@ namespace accel::Hash {
             m1[2] = _mm_xor_si128(m1[2], m2[2]);
             m1[3] = _mm_xor_si128(m1[3], m2[3]);
 #else
-            m1.AsCArray<uint64_t[8]>()[0] ^= m2.AsCArray<uint64_t[8]>()[0];
-            m1.AsCArray<uint64_t[8]>()[1] ^= m2.AsCArray<uint64_t[8]>()[1];
-            m1.AsCArray<uint64_t[8]>()[2] ^= m2.AsCArray<uint64_t[8]>()[2];
-            m1.AsCArray<uint64_t[8]>()[3] ^= m2.AsCArray<uint64_t[8]>()[3];
-            m1.AsCArray<uint64_t[8]>()[4] ^= m2.AsCArray<uint64_t[8]>()[4];
-            m1.AsCArray<uint64_t[8]>()[5] ^= m2.AsCArray<uint64_t[8]>()[5];
-            m1.AsCArray<uint64_t[8]>()[6] ^= m2.AsCArray<uint64_t[8]>()[6];
-            m1.AsCArray<uint64_t[8]>()[7] ^= m2.AsCArray<uint64_t[8]>()[7];
+            m1.AsCArrayOf<uint64_t[8]>()[0] ^= m2.AsCArrayOf<uint64_t[8]>()[0];
+            m1.AsCArrayOf<uint64_t[8]>()[1] ^= m2.AsCArrayOf<uint64_t[8]>()[1];
+            m1.AsCArrayOf<uint64_t[8]>()[2] ^= m2.AsCArrayOf<uint64_t[8]>()[2];
+            m1.AsCArrayOf<uint64_t[8]>()[3] ^= m2.AsCArrayOf<uint64_t[8]>()[3];
+            m1.AsCArrayOf<uint64_t[8]>()[4] ^= m2.AsCArrayOf<uint64_t[8]>()[4];
+            m1.AsCArrayOf<uint64_t[8]>()[5] ^= m2.AsCArrayOf<uint64_t[8]>()[5];
+            m1.AsCArrayOf<uint64_t[8]>()[6] ^= m2.AsCArrayOf<uint64_t[8]>()[6];
+            m1.AsCArrayOf<uint64_t[8]>()[7] ^= m2.AsCArrayOf<uint64_t[8]>()[7];
 #endif
         }
 
@@ -753,8 +755,8 @@ namespace accel::Hash {
             t1 = _mm256_permutevar8x32_epi32(t1, _mm256_set_epi32(7, 7, 7, 7, 6, 4, 2, 0));
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_castsi256_si128(t1);
-            temp[0] = _mm256_i32gather_epi64(C[0], vindex0, 8);
-            temp[1] = _mm256_i32gather_epi64(C[0], vindex1, 8);
+            temp[0] = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[0]), vindex0, 8);
+            temp[1] = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[0]), vindex1, 8);
 
             /*
              *              x[0] = <[00][01][02][03][04][05][06][07]><[10][11][12][13][14][15][16][17]><[20][21][22][23][24][25][26][27]><[30][31][32][33][34][35][36][37]>
@@ -805,8 +807,8 @@ namespace accel::Hash {
             t0 = _mm256_bsrli_epi128(t0, 1);
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[1], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[1], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[1]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[1]), vindex1, 8));
 
             t0 = _mm256_and_si256(x[0], _mm256_set1_epi64x(0x0000000000FF0000));
             t1 = _mm256_and_si256(x[1], _mm256_set1_epi64x(0x0000000000FF0000));
@@ -817,8 +819,8 @@ namespace accel::Hash {
             t0 = _mm256_bsrli_epi128(t0, 2);
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[2], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[2], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[2]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[2]), vindex1, 8));
 
             t0 = _mm256_and_si256(x[0], _mm256_set1_epi64x(0x00000000FF000000));
             t1 = _mm256_and_si256(x[1], _mm256_set1_epi64x(0x00000000FF000000));
@@ -829,8 +831,8 @@ namespace accel::Hash {
             t0 = _mm256_bsrli_epi128(t0, 3);
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[3], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[3], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[3]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[3]), vindex1, 8));
 
             t0 = _mm256_and_si256(x[0], _mm256_set1_epi64x(0x000000FF00000000));
             t1 = _mm256_and_si256(x[1], _mm256_set1_epi64x(0x000000FF00000000));
@@ -840,8 +842,8 @@ namespace accel::Hash {
             t0 = _mm256_permutevar8x32_epi32(t0, _mm256_set_epi32(3, 2, 1, 0, 7, 6, 5, 4));
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[4], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[4], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[4]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[4]), vindex1, 8));
 
             t0 = _mm256_and_si256(x[0], _mm256_set1_epi64x(0x0000FF0000000000));
             t1 = _mm256_and_si256(x[1], _mm256_set1_epi64x(0x0000FF0000000000));
@@ -852,8 +854,8 @@ namespace accel::Hash {
             t0 = _mm256_bsrli_epi128(t0, 1);
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[5], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[5], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[5]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[5]), vindex1, 8));
 
             t0 = _mm256_and_si256(x[0], _mm256_set1_epi64x(0x00FF000000000000));
             t1 = _mm256_and_si256(x[1], _mm256_set1_epi64x(0x00FF000000000000));
@@ -864,8 +866,8 @@ namespace accel::Hash {
             t0 = _mm256_bsrli_epi128(t0, 2);
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[6], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[6], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[6]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[6]), vindex1, 8));
 
             t0 = _mm256_and_si256(x[0], _mm256_set1_epi64x(0xFF00000000000000));
             t1 = _mm256_and_si256(x[1], _mm256_set1_epi64x(0xFF00000000000000));
@@ -876,81 +878,81 @@ namespace accel::Hash {
             t0 = _mm256_bsrli_epi128(t0, 3);
             vindex0 = _mm256_castsi256_si128(t0);
             vindex1 = _mm256_extracti128_si256(t0, 1);
-            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(C[7], vindex0, 8));
-            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(C[7], vindex1, 8));
+            temp[0] = _mm256_xor_si256(temp[0], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[7]), vindex0, 8));
+            temp[1] = _mm256_xor_si256(temp[1], _mm256_i32gather_epi64(reinterpret_cast<const long long*>(C[7]), vindex1, 8));
 #else
             temp.AsArrayOf<uint64_t, 8>()[0] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[0][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[7][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[6][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[5][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[4][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[3][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[2][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[1][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[0][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[7][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[6][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[5][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[4][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[3][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[2][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[1][7]];
             temp.AsArrayOf<uint64_t, 8>()[1] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[1][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[0][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[7][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[6][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[5][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[4][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[3][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[2][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[1][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[0][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[7][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[6][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[5][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[4][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[3][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[2][7]];
             temp.AsArrayOf<uint64_t, 8>()[2] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[2][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[1][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[0][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[7][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[6][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[5][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[4][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[3][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[2][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[1][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[0][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[7][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[6][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[5][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[4][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[3][7]];
             temp.AsArrayOf<uint64_t, 8>()[3] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[3][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[2][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[1][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[0][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[7][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[6][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[5][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[4][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[3][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[2][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[1][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[0][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[7][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[6][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[5][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[4][7]];
             temp.AsArrayOf<uint64_t, 8>()[4] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[4][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[3][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[2][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[1][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[0][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[7][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[6][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[5][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[4][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[3][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[2][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[1][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[0][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[7][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[6][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[5][7]];
             temp.AsArrayOf<uint64_t, 8>()[5] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[5][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[4][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[3][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[2][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[1][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[0][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[7][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[6][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[5][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[4][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[3][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[2][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[1][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[0][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[7][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[6][7]];
             temp.AsArrayOf<uint64_t, 8>()[6] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[6][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[5][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[4][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[3][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[2][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[1][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[0][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[7][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[6][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[5][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[4][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[3][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[2][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[1][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[0][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[7][7]];
             temp.AsArrayOf<uint64_t, 8>()[7] =
-                C[0][x.AsCArray<uint8_t[8][8]>()[7][0]] ^
-                C[1][x.AsCArray<uint8_t[8][8]>()[6][1]] ^
-                C[2][x.AsCArray<uint8_t[8][8]>()[5][2]] ^
-                C[3][x.AsCArray<uint8_t[8][8]>()[4][3]] ^
-                C[4][x.AsCArray<uint8_t[8][8]>()[3][4]] ^
-                C[5][x.AsCArray<uint8_t[8][8]>()[2][5]] ^
-                C[6][x.AsCArray<uint8_t[8][8]>()[1][6]] ^
-                C[7][x.AsCArray<uint8_t[8][8]>()[0][7]];
+                C[0][x.AsCArrayOf<uint8_t[8][8]>()[7][0]] ^
+                C[1][x.AsCArrayOf<uint8_t[8][8]>()[6][1]] ^
+                C[2][x.AsCArrayOf<uint8_t[8][8]>()[5][2]] ^
+                C[3][x.AsCArrayOf<uint8_t[8][8]>()[4][3]] ^
+                C[4][x.AsCArrayOf<uint8_t[8][8]>()[3][4]] ^
+                C[5][x.AsCArrayOf<uint8_t[8][8]>()[2][5]] ^
+                C[6][x.AsCArrayOf<uint8_t[8][8]>()[1][6]] ^
+                C[7][x.AsCArrayOf<uint8_t[8][8]>()[0][7]];
 #endif
             x = temp;
         }
@@ -990,12 +992,10 @@ namespace accel::Hash {
             }
         }
 
-        SecureWiper<MatrixType> _StateWiper;
         MatrixType _State;
     public:
 
         WHIRLPOOL_ALG() noexcept :
-            _StateWiper(_State),
             _State{} {}
 
         constexpr size_t BlockSize() const noexcept {
@@ -1052,8 +1052,30 @@ namespace accel::Hash {
             SecureWipe(FormattedTail, sizeof(FormattedTail));
         }
 
+        void DigestTo(void* pbDigest) const noexcept {
+            memcpy(pbDigest, _State.AsCArray(), DigestSizeValue);
+        }
+
         Array<uint8_t, DigestSizeValue> Digest() const noexcept {
-            return _State.AsArrayOf<uint8_t, 64>();
+            Array<uint8_t, DigestSizeValue> Result;
+            DigestTo(Result.AsCArray());
+            return Result;
+        }
+
+        //
+        //  Chaining state in host byte order: the 8x8 byte matrix, row by row, the same layout on every backend.
+        //  Valid between Cycle calls only, not after Finish.
+        //
+        void ExportState(void* pbState) const noexcept {
+            memcpy(pbState, _State.AsCArray(), StateSizeValue);
+        }
+
+        void ImportState(const void* pbState) noexcept {
+            memcpy(_State.AsCArray(), pbState, StateSizeValue);
+        }
+
+        ~WHIRLPOOL_ALG() noexcept {
+            _State.SecureZero();
         }
     };
 
@@ -238,33 +238,39 @@ namespace accel {
         static_assert(std::is_integral<__IntegerType>::value,
                       "RepeatSaveTo failure! Not a integer type.");
 
+        //
+        //  REP STOS advances rdi and counts rcx down to zero, so both are in-out operands,
+        //  and it writes memory the compiler cannot see.
+        //
+        void* pDestination = p;
+
         if constexpr (sizeof(__IntegerType) == 1) {
             asm volatile("rep stosb;"
-                         :
-                         : "D"(p), "a"(v), "c"(times)
-                         :);
+                         : "+D"(pDestination), "+c"(times)
+                         : "a"(v)
+                         : "memory");
         }
 
         if constexpr (sizeof(__IntegerType) == 2) {
             asm volatile("rep stosw;"
-                         :
-                         : "D"(p), "a"(v), "c"(times)
-                         :);
+                         : "+D"(pDestination), "+c"(times)
+                         : "a"(v)
+                         : "memory");
         }
 
         if constexpr (sizeof(__IntegerType) == 4) {
             asm volatile("rep stosd;"
-                         :
-                         : "D"(p), "a"(v), "c"(times)
-                         :);
+                         : "+D"(pDestination), "+c"(times)
+                         : "a"(v)
+                         : "memory");
         }
 
 #if defined(_M_X64) || defined(__x86_64__)
         if constexpr (sizeof(__IntegerType) == 8) {
             asm volatile("rep stosq;"
-                         :
-                         : "D"(p), "a"(v), "c"(times)
-                         :);
+                         : "+D"(pDestination), "+c"(times)
+                         : "a"(v)
+                         : "memory");
         }
 
         static_assert(sizeof(__IntegerType) == 1 || sizeof(__IntegerType) == 2 || sizeof(__IntegerType) == 4 || sizeof(__IntegerType) == 8,
@@ -0,0 +1,341 @@
+#pragma once
+#include "../../Config.hpp"
+#include "../../Array.hpp"
+#include "../../Block.hpp"
+#include "../../Intrinsic.hpp"
+#include "../../MemoryAccess.hpp"
+#include "../common.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+namespace accel::Modes::Internal {
+
+    //
+    //  GHASH with 4-bit tables (Shoup's method), for hosts without PCLMULQDQ.
+    //  The table lookups are indexed by secret data, so this backend is not constant-time.
+    //
+    class GHASH_PORTABLE {
+    public:
+        static constexpr size_t BlockSizeValue = 16;
+    private:
+        static constexpr uint16_t _Last4[16] = {
+            0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+            0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+        };
+
+        Array<uint64_t, 16> _HL;    // low 64 bits of i * H, in GHASH's bit order
+        Array<uint64_t, 16> _HH;    // high 64 bits of i * H
+        uint64_t _YH;
+        uint64_t _YL;
+
+        ACCEL_FORCEINLINE
+        void _MultiplyH() ACCEL_NOEXCEPT {
+            uint8_t X[16];
+            uint64_t ZH, ZL;
+
+            MemoryWriteAs<uint64_t>(X, ByteSwap(_YH));
+            MemoryWriteAs<uint64_t>(X + 8, ByteSwap(_YL));
+
+            ZH = _HH[X[15] & 0x0f];
+            ZL = _HL[X[15] & 0x0f];
+
+            for (size_t i = 16; i > 0; --i) {
+                uint8_t Lo = X[i - 1] & 0x0f;
+                uint8_t Hi = X[i - 1] >> 4;
+                uint8_t Rem;
+
+                if (i != 16) {
+                    Rem = static_cast<uint8_t>(ZL & 0x0f);
+                    ZL = (ZH << 60) | (ZL >> 4);
+                    ZH = (ZH >> 4) ^ (static_cast<uint64_t>(_Last4[Rem]) << 48);
+                    ZH ^= _HH[Lo];
+                    ZL ^= _HL[Lo];
+                }
+
+                Rem = static_cast<uint8_t>(ZL & 0x0f);
+                ZL = (ZH << 60) | (ZL >> 4);
+                ZH = (ZH >> 4) ^ (static_cast<uint64_t>(_Last4[Rem]) << 48);
+                ZH ^= _HH[Hi];
+                ZL ^= _HL[Hi];
+            }
+
+            _YH = ZH;
+            _YL = ZL;
+        }
+
+    public:
+
+        GHASH_PORTABLE() ACCEL_NOEXCEPT :
+            _YH(0),
+            _YL(0) {}
+
+        void SetH(const void* pbH) ACCEL_NOEXCEPT {
+            uint64_t VH = ByteSwap(MemoryReadAs<uint64_t>(pbH));
+            uint64_t VL = ByteSwap(MemoryReadAs<uint64_t>(reinterpret_cast<const uint8_t*>(pbH) + 8));
+
+            _HH[0] = 0;
+            _HL[0] = 0;
+            _HH[8] = VH;
+            _HL[8] = VL;
+
+            for (size_t i = 4; i > 0; i >>= 1) {
+                uint64_t T = (VL & 1) * 0xe1000000u;
+                VL = (VH << 63) | (VL >> 1);
+                VH = (VH >> 1) ^ (T << 32);
+                _HH[i] = VH;
+                _HL[i] = VL;
+            }
+
+            for (size_t i = 2; i <= 8; i *= 2) {
+                for (size_t j = 1; j < i; ++j) {
+                    _HH[i + j] = _HH[i] ^ _HH[j];
+                    _HL[i + j] = _HL[i] ^ _HL[j];
+                }
+            }
+
+            Reset();
+        }
+
+        void Reset() ACCEL_NOEXCEPT {
+            _YH = 0;
+            _YL = 0;
+        }
+
+        void Update(const void* pbBlocks, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pb = reinterpret_cast<const uint8_t*>(pbBlocks);
+            for (size_t i = 0; i < BlockCount; ++i, pb += BlockSizeValue) {
+                _YH ^= ByteSwap(MemoryReadAs<uint64_t>(pb));
+                _YL ^= ByteSwap(MemoryReadAs<uint64_t>(pb + 8));
+                _MultiplyH();
+            }
+        }
+
+        void Digest(void* pbDigest) const ACCEL_NOEXCEPT {
+            MemoryWriteAs<uint64_t>(pbDigest, ByteSwap(_YH));
+            MemoryWriteAs<uint64_t>(reinterpret_cast<uint8_t*>(pbDigest) + 8, ByteSwap(_YL));
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _HL.SecureZero();
+            _HH.SecureZero();
+            SecureWipe(&_YH, sizeof(_YH));
+            SecureWipe(&_YL, sizeof(_YL));
+        }
+
+        ~GHASH_PORTABLE() ACCEL_NOEXCEPT {
+            ClearKey();
+        }
+    };
+
+    //
+    //  GHASH on PCLMULQDQ, following Intel's "Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode".
+    //  Operands are kept byte-reflected, and every 128 x 128-bit product takes 3 multiplications (Karatsuba).
+    //  H^1 ... H^8 are precomputed so that up to 8 blocks share one reduction:
+    //      Y' = (Y ^ X[0]) * H^n ^ X[1] * H^(n-1) ^ ... ^ X[n-1] * H
+    //
+    //  Every member is compiled with ACCEL_TARGET("pclmul,ssse3"); check RuntimeCpuFeatures() before use.
+    //
+    class GHASH_PCLMUL {
+    public:
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t AggregatedBlocksValue = 8;
+    private:
+        using BlockType = Block<__m128i, 1>;
+
+        Array<BlockType, AggregatedBlocksValue> _HPowers;   // _HPowers[i] = H^(i + 1)
+        Array<BlockType, AggregatedBlocksValue> _HFolded;   // high ^ low 64 bits of _HPowers[i], for Karatsuba
+        BlockType _Y;
+
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        static __m128i _Fold(__m128i x) ACCEL_NOEXCEPT {
+            return _mm_xor_si128(x, _mm_shuffle_epi32(x, 0x4e));
+        }
+
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        static __m128i _Multiply(__m128i a, __m128i b) ACCEL_NOEXCEPT {
+            __m128i Lo = _mm_setzero_si128();
+            __m128i Mid = _mm_setzero_si128();
+            __m128i Hi = _mm_setzero_si128();
+            MultiplyAccumulate(a, b, _Fold(b), Lo, Mid, Hi);
+            return Reduce(Lo, Mid, Hi);
+        }
+
+    public:
+
+        GHASH_PCLMUL() ACCEL_NOEXCEPT = default;
+
+        ACCEL_TARGET("pclmul,ssse3")
+        void SetH(const void* pbH) ACCEL_NOEXCEPT {
+            __m128i H = Reflect(MemoryReadAs<__m128i>(pbH));
+            __m128i HPower = H;
+
+            _HPowers[0] = H;
+            _HFolded[0] = _Fold(H);
+            for (size_t i = 1; i < AggregatedBlocksValue; ++i) {
+                HPower = _Multiply(HPower, H);
+                _HPowers[i] = HPower;
+                _HFolded[i] = _Fold(HPower);
+            }
+
+            Reset();
+        }
+
+        ACCEL_TARGET("pclmul,ssse3")
+        void Reset() ACCEL_NOEXCEPT {
+            _Y = _mm_setzero_si128();
+        }
+
+        ACCEL_TARGET("pclmul,ssse3")
+        void Update(const void* pbBlocks, size_t BlockCount) ACCEL_NOEXCEPT {
+            auto pb = reinterpret_cast<const uint8_t*>(pbBlocks);
+            __m128i Y = _Y;
+
+            for (; BlockCount >= 8; BlockCount -= 8, pb += 8 * BlockSizeValue)
+                Y = Aggregate(Y, pb, std::make_index_sequence<8>{});
+
+            if (BlockCount >= 4) {
+                Y = Aggregate(Y, pb, std::make_index_sequence<4>{});
+                BlockCount -= 4;
+                pb += 4 * BlockSizeValue;
+            }
+
+            for (; BlockCount; --BlockCount, pb += BlockSizeValue)
+                Y = Aggregate(Y, pb, std::make_index_sequence<1>{});
+
+            _Y = Y;
+        }
+
+        ACCEL_TARGET("pclmul,ssse3")
+        void Digest(void* pbDigest) const ACCEL_NOEXCEPT {
+            MemoryWriteAs<__m128i>(pbDigest, Reflect(_Y));
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _HPowers.SecureZero();
+            _HFolded.SecureZero();
+            SecureWipe(&_Y, sizeof(_Y));
+        }
+
+        //
+        //  The steps of an aggregation, for a mode that interleaves them with its own work
+        //  (GCM stitches them into the AES-NI rounds). Blocks and the running hash are byte-reflected.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        static __m128i Reflect(__m128i x) ACCEL_NOEXCEPT {
+            return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+        }
+
+        //
+        //  Accumulate the unreduced 256-bit product a * b into (Lo, Mid, Hi) with Karatsuba's trick.
+        //  `bFolded` is b with its two halves XORed, see HPowerFolded; Mid is only fixed up in Reduce, once per aggregation.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        static void MultiplyAccumulate(__m128i a, __m128i b, __m128i bFolded, __m128i& Lo, __m128i& Mid, __m128i& Hi) ACCEL_NOEXCEPT {
+            Lo = _mm_xor_si128(Lo, _mm_clmulepi64_si128(a, b, 0x00));
+            Hi = _mm_xor_si128(Hi, _mm_clmulepi64_si128(a, b, 0x11));
+            Mid = _mm_xor_si128(Mid, _mm_clmulepi64_si128(_Fold(a), bFolded, 0x00));
+        }
+
+        //
+        //  Shift the reflected 256-bit product left by one bit and reduce it modulo x^128 + x^7 + x^2 + x + 1.
+        //
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        static __m128i Reduce(__m128i Lo, __m128i Mid, __m128i Hi) ACCEL_NOEXCEPT {
+            __m128i t0, t1, t2;
+
+            Mid = _mm_xor_si128(Mid, _mm_xor_si128(Lo, Hi));
+            Lo = _mm_xor_si128(Lo, _mm_slli_si128(Mid, 8));
+            Hi = _mm_xor_si128(Hi, _mm_srli_si128(Mid, 8));
+
+            t0 = _mm_srli_epi32(Lo, 31);
+            t1 = _mm_srli_epi32(Hi, 31);
+            Lo = _mm_slli_epi32(Lo, 1);
+            Hi = _mm_slli_epi32(Hi, 1);
+            t2 = _mm_srli_si128(t0, 12);
+            t1 = _mm_slli_si128(t1, 4);
+            t0 = _mm_slli_si128(t0, 4);
+            Lo = _mm_or_si128(Lo, t0);
+            Hi = _mm_or_si128(Hi, t1);
+            Hi = _mm_or_si128(Hi, t2);
+
+            t0 = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(Lo, 31), _mm_slli_epi32(Lo, 30)), _mm_slli_epi32(Lo, 25));
+            t1 = _mm_srli_si128(t0, 4);
+            t0 = _mm_slli_si128(t0, 12);
+            Lo = _mm_xor_si128(Lo, t0);
+
+            t2 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(Lo, 1), _mm_srli_epi32(Lo, 2)), _mm_srli_epi32(Lo, 7));
+            t2 = _mm_xor_si128(t2, t1);
+            Lo = _mm_xor_si128(Lo, t2);
+
+            return _mm_xor_si128(Hi, Lo);
+        }
+
+        //
+        //  Load the `__Index`-th block of an aggregation; the running hash is folded into the first one.
+        //
+        template<size_t __Index>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        static __m128i LoadBlock(const uint8_t* pbBlocks, __m128i Y, std::integral_constant<size_t, __Index>) ACCEL_NOEXCEPT {
+            __m128i X = Reflect(MemoryReadAs<__m128i>(pbBlocks, BlockSizeValue, __Index));
+            if constexpr (__Index == 0) {
+                return _mm_xor_si128(X, Y);
+            } else {
+                return X;
+            }
+        }
+
+        template<size_t... __Indexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("pclmul,ssse3")
+        __m128i Aggregate(__m128i Y, const uint8_t* pbBlocks, std::index_sequence<__Indexes...>) const ACCEL_NOEXCEPT {
+            constexpr size_t n = sizeof...(__Indexes);
+            __m128i Lo = _mm_setzero_si128();
+            __m128i Mid = _mm_setzero_si128();
+            __m128i Hi = _mm_setzero_si128();
+
+            //
+            //  Go from the last block to the first: only the first one depends on Y,
+            //  so the other products do not have to wait for the previous reduction.
+            //
+            (MultiplyAccumulate(LoadBlock(pbBlocks, Y, std::integral_constant<size_t, n - 1 - __Indexes>{}),
+                                _HPowers[__Indexes], _HFolded[__Indexes], Lo, Mid, Hi), ...);
+
+            return Reduce(Lo, Mid, Hi);
+        }
+
+        //
+        //  H^(i + 1) and its folded halves, for MultiplyAccumulate.
+        //
+        __m128i HPower(size_t i) const ACCEL_NOEXCEPT {
+            return _HPowers[i];
+        }
+
+        __m128i HPowerFolded(size_t i) const ACCEL_NOEXCEPT {
+            return _HFolded[i];
+        }
+
+        //
+        //  The running hash, reflected.
+        //
+        __m128i State() const ACCEL_NOEXCEPT {
+            return _Y;
+        }
+
+        void SetState(__m128i Y) ACCEL_NOEXCEPT {
+            _Y = Y;
+        }
+
+        ~GHASH_PCLMUL() ACCEL_NOEXCEPT {
+            ClearKey();
+        }
+    };
+
+}
+
@@ -0,0 +1,169 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "common.hpp"
+
+namespace accel::Modes {
+
+    //
+    //  Cipher block chaining.
+    //  Encryption is inherently serial. Decryption of a batch of blocks only depends on ciphertext,
+    //  so it is handed to the cipher's multi-block kernel when there is one.
+    //  Data that does not fill a whole block is kept until the next Update; no padding is applied.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class CBC {
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+        static constexpr size_t IVSizeValue = __CipherType::BlockSizeValue;
+    private:
+        static constexpr size_t _BatchBlocks = Internal::BatchBlocksValue;
+
+        __CipherType _Cipher;
+        Array<uint8_t, BlockSizeValue> _IV;
+        Array<uint8_t, BlockSizeValue> _Buffer;
+        size_t _BufferedLength;
+
+        ACCEL_FORCEINLINE
+        void _EncryptBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < BlockCount; ++i) {
+                Internal::XorBytes(_IV.AsCArray(), _IV.AsCArray(), pbIn + i * BlockSizeValue, BlockSizeValue);
+                _Cipher.EncryptBlock(_IV.AsCArray());
+                memcpy(pbOut + i * BlockSizeValue, _IV.AsCArray(), BlockSizeValue);
+            }
+        }
+
+        ACCEL_FORCEINLINE
+        void _DecryptBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            uint8_t Ciphertext[_BatchBlocks * BlockSizeValue];
+            uint8_t Plaintext[_BatchBlocks * BlockSizeValue];
+
+            while (BlockCount) {
+                size_t n = BlockCount < _BatchBlocks ? BlockCount : _BatchBlocks;
+
+                //
+                //  Keep a copy of the ciphertext: pbOut may be the same as pbIn.
+                //
+                memcpy(Ciphertext, pbIn, n * BlockSizeValue);
+                memcpy(Plaintext, pbIn, n * BlockSizeValue);
+                Internal::DecryptBlocks(_Cipher, Plaintext, n);
+
+                Internal::XorBytes(pbOut, Plaintext, _IV.AsCArray(), BlockSizeValue);
+                Internal::XorBytes(pbOut + BlockSizeValue, Plaintext + BlockSizeValue, Ciphertext, (n - 1) * BlockSizeValue);
+                memcpy(_IV.AsCArray(), Ciphertext + (n - 1) * BlockSizeValue, BlockSizeValue);
+
+                pbIn += n * BlockSizeValue;
+                pbOut += n * BlockSizeValue;
+                BlockCount -= n;
+            }
+
+            SecureWipe(Plaintext, sizeof(Plaintext));
+        }
+
+        ACCEL_FORCEINLINE
+        void _ProcessBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (__Direction == Direction::Encryption) {
+                _EncryptBlocks(pbIn, pbOut, BlockCount);
+            } else {
+                _DecryptBlocks(pbIn, pbOut, BlockCount);
+            }
+        }
+
+    public:
+
+        CBC() ACCEL_NOEXCEPT :
+            _BufferedLength(0) {}
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t IVSize() const ACCEL_NOEXCEPT {
+            return IVSizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            return _Cipher.SetKey(pbUserKey, cbUserKey);
+        }
+
+        //
+        //  Start a new message.
+        //
+        ACCEL_NODISCARD
+        bool SetIV(const void* pbIV, size_t cbIV) ACCEL_NOEXCEPT {
+            if (cbIV != IVSizeValue) {
+                return false;
+            } else {
+                _IV.LoadFrom(pbIV);
+                _BufferedLength = 0;
+                return true;
+            }
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write the result to `pbOut`.
+        //  Returns the number of bytes written, which is always a multiple of BlockSizeValue.
+        //  `pbOut` must have room for `cbIn + BlockSizeValue - 1` bytes.
+        //  In-place operation (pbIn == pbOut) is allowed as long as no partial block is pending.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbOut = 0;
+
+            if (_BufferedLength) {
+                size_t cbCopy = BlockSizeValue - _BufferedLength < cbIn ? BlockSizeValue - _BufferedLength : cbIn;
+
+                memcpy(_Buffer.AsCArray() + _BufferedLength, pbInBytes, cbCopy);
+                _BufferedLength += cbCopy;
+                pbInBytes += cbCopy;
+                cbIn -= cbCopy;
+
+                if (_BufferedLength < BlockSizeValue)
+                    return 0;
+
+                _ProcessBlocks(_Buffer.AsCArray(), pbOutBytes, 1);
+                _BufferedLength = 0;
+                pbOutBytes += BlockSizeValue;
+                cbOut += BlockSizeValue;
+            }
+
+            size_t BlockCount = cbIn / BlockSizeValue;
+            if (BlockCount) {
+                _ProcessBlocks(pbInBytes, pbOutBytes, BlockCount);
+                pbInBytes += BlockCount * BlockSizeValue;
+                cbIn -= BlockCount * BlockSizeValue;
+                cbOut += BlockCount * BlockSizeValue;
+            }
+
+            if (cbIn) {
+                memcpy(_Buffer.AsCArray(), pbInBytes, cbIn);
+                _BufferedLength = cbIn;
+            }
+
+            return cbOut;
+        }
+
+        //
+        //  Returns false if the data passed to Update was not a multiple of BlockSizeValue.
+        //  The pending partial block, if any, is discarded. Call SetIV before the next message.
+        //
+        ACCEL_NODISCARD
+        bool Final() ACCEL_NOEXCEPT {
+            bool Aligned = _BufferedLength == 0;
+            _Buffer.SecureZero();
+            _IV.SecureZero();
+            _BufferedLength = 0;
+            return Aligned;
+        }
+
+        ~CBC() ACCEL_NOEXCEPT {
+            _Buffer.SecureZero();
+            _IV.SecureZero();
+        }
+    };
+
+}
+
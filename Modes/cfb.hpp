@@ -0,0 +1,163 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "common.hpp"
+
+namespace accel::Modes {
+
+    //
+    //  Cipher feedback with a full-block segment size (e.g. CFB-128 for AES).
+    //  Works on any number of bytes; the keystream of a partially used block is carried over to the next Update.
+    //  Decryption of whole blocks only depends on ciphertext, so it goes through the cipher's multi-block kernel.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class CFB {
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+        static constexpr size_t IVSizeValue = __CipherType::BlockSizeValue;
+    private:
+        static constexpr size_t _BatchBlocks = Internal::BatchBlocksValue;
+
+        __CipherType _Cipher;
+        Array<uint8_t, BlockSizeValue> _Register;       // the previous ciphertext block (or IV)
+        Array<uint8_t, BlockSizeValue> _Keystream;
+        size_t _KeystreamOffset;
+
+        ACCEL_FORCEINLINE
+        void _EncryptBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < BlockCount; ++i) {
+                _Cipher.EncryptBlock(_Register.AsCArray());
+                Internal::XorBytes(_Register.AsCArray(), _Register.AsCArray(), pbIn + i * BlockSizeValue, BlockSizeValue);
+                memcpy(pbOut + i * BlockSizeValue, _Register.AsCArray(), BlockSizeValue);
+            }
+        }
+
+        ACCEL_FORCEINLINE
+        void _DecryptBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            uint8_t Keystream[_BatchBlocks * BlockSizeValue];
+            uint8_t Ciphertext[BlockSizeValue];
+
+            while (BlockCount) {
+                size_t n = BlockCount < _BatchBlocks ? BlockCount : _BatchBlocks;
+
+                memcpy(Keystream, _Register.AsCArray(), BlockSizeValue);
+                memcpy(Keystream + BlockSizeValue, pbIn, (n - 1) * BlockSizeValue);
+                memcpy(Ciphertext, pbIn + (n - 1) * BlockSizeValue, BlockSizeValue);   // pbOut may be the same as pbIn
+                Internal::EncryptBlocks(_Cipher, Keystream, n);
+                Internal::XorBytes(pbOut, pbIn, Keystream, n * BlockSizeValue);
+                memcpy(_Register.AsCArray(), Ciphertext, BlockSizeValue);
+
+                pbIn += n * BlockSizeValue;
+                pbOut += n * BlockSizeValue;
+                BlockCount -= n;
+            }
+
+            SecureWipe(Keystream, sizeof(Keystream));
+        }
+
+        ACCEL_FORCEINLINE
+        void _ProcessBytes(const uint8_t* pbIn, uint8_t* pbOut, size_t cb) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < cb; ++i, ++_KeystreamOffset) {
+                uint8_t In = pbIn[i];
+                uint8_t Out = In ^ _Keystream[_KeystreamOffset];
+
+                pbOut[i] = Out;
+                if constexpr (__Direction == Direction::Encryption) {
+                    _Register[_KeystreamOffset] = Out;
+                } else {
+                    _Register[_KeystreamOffset] = In;
+                }
+            }
+        }
+
+    public:
+
+        CFB() ACCEL_NOEXCEPT :
+            _KeystreamOffset(BlockSizeValue) {}
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t IVSize() const ACCEL_NOEXCEPT {
+            return IVSizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            return _Cipher.SetKey(pbUserKey, cbUserKey);
+        }
+
+        //
+        //  Start a new message.
+        //
+        ACCEL_NODISCARD
+        bool SetIV(const void* pbIV, size_t cbIV) ACCEL_NOEXCEPT {
+            if (cbIV != IVSizeValue) {
+                return false;
+            } else {
+                _Register.LoadFrom(pbIV);
+                _KeystreamOffset = BlockSizeValue;
+                return true;
+            }
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write exactly `cbIn` bytes to `pbOut`.
+        //  pbIn == pbOut is allowed.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbLeft = cbIn;
+
+            if (_KeystreamOffset < BlockSizeValue) {
+                size_t cb = BlockSizeValue - _KeystreamOffset < cbLeft ? BlockSizeValue - _KeystreamOffset : cbLeft;
+                _ProcessBytes(pbInBytes, pbOutBytes, cb);
+                pbInBytes += cb;
+                pbOutBytes += cb;
+                cbLeft -= cb;
+            }
+
+            size_t BlockCount = cbLeft / BlockSizeValue;
+            if (BlockCount) {
+                if constexpr (__Direction == Direction::Encryption) {
+                    _EncryptBlocks(pbInBytes, pbOutBytes, BlockCount);
+                } else {
+                    _DecryptBlocks(pbInBytes, pbOutBytes, BlockCount);
+                }
+                pbInBytes += BlockCount * BlockSizeValue;
+                pbOutBytes += BlockCount * BlockSizeValue;
+                cbLeft -= BlockCount * BlockSizeValue;
+            }
+
+            if (cbLeft) {
+                _Keystream = _Register;
+                _Cipher.EncryptBlock(_Keystream.AsCArray());
+                _KeystreamOffset = 0;
+                _ProcessBytes(pbInBytes, pbOutBytes, cbLeft);
+            }
+
+            return cbIn;
+        }
+
+        //
+        //  Always succeeds; CFB needs no padding. Call SetIV before the next message.
+        //
+        ACCEL_NODISCARD
+        bool Final() ACCEL_NOEXCEPT {
+            _Register.SecureZero();
+            _Keystream.SecureZero();
+            _KeystreamOffset = BlockSizeValue;
+            return true;
+        }
+
+        ~CFB() ACCEL_NOEXCEPT {
+            _Register.SecureZero();
+            _Keystream.SecureZero();
+        }
+    };
+
+}
+
@@ -0,0 +1,135 @@
+#pragma once
+#include "../Config.hpp"
+#include "../SecureWiper.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <memory.h>
+#include <type_traits>
+#include <utility>
+
+namespace accel::CipherTraits {
+
+    template<size_t __KeyBits>
+    class AES_AESNI_ALG;
+
+}
+
+namespace accel::Modes {
+
+    enum class Direction {
+        Encryption,
+        Decryption
+    };
+
+    namespace Internal {
+
+        //
+        //  Detect whether a CipherTraits class offers a multi-block kernel,
+        //  i.e. `size_t EncryptBlocks(void*, size_t)` / `size_t DecryptBlocks(void*, size_t)`.
+        //
+        template<typename __CipherType, typename = void>
+        struct HasEncryptBlocks : std::false_type {};
+
+        template<typename __CipherType>
+        struct HasEncryptBlocks<__CipherType,
+                                std::void_t<decltype(std::declval<__CipherType&>().EncryptBlocks(std::declval<void*>(), size_t{}))>> : std::true_type {};
+
+        template<typename __CipherType, typename = void>
+        struct HasDecryptBlocks : std::false_type {};
+
+        template<typename __CipherType>
+        struct HasDecryptBlocks<__CipherType,
+                                std::void_t<decltype(std::declval<__CipherType&>().DecryptBlocks(std::declval<void*>(), size_t{}))>> : std::true_type {};
+
+        //
+        //  Modes with a fused AES-NI kernel (GCM, XTS) use it when the cipher is AES_AESNI_ALG.
+        //  They read the round keys through AES_AESNI_ALG::EncryptionRoundKey and DecryptionRoundKey.
+        //
+        template<typename __CipherType>
+        struct IsAesNiCipher : std::false_type {};
+
+        template<size_t __KeyBits>
+        struct IsAesNiCipher<CipherTraits::AES_AESNI_ALG<__KeyBits>> : std::true_type {};
+
+        //
+        //  How many blocks the parallelizable modes hand to the cipher at once.
+        //  16 blocks fill the widest kernel we have (4 zmm registers of VAES) and stay small enough for the stack.
+        //
+        constexpr size_t BatchBlocksValue = 16;
+
+        template<typename __CipherType>
+        ACCEL_FORCEINLINE
+        void EncryptBlocks(__CipherType& Cipher, void* pbBlocks, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (HasEncryptBlocks<__CipherType>::value) {
+                Cipher.EncryptBlocks(pbBlocks, BlockCount);
+            } else {
+                auto pb = reinterpret_cast<uint8_t*>(pbBlocks);
+                for (size_t i = 0; i < BlockCount; ++i)
+                    Cipher.EncryptBlock(pb + i * __CipherType::BlockSizeValue);
+            }
+        }
+
+        template<typename __CipherType>
+        ACCEL_FORCEINLINE
+        void DecryptBlocks(__CipherType& Cipher, void* pbBlocks, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (HasDecryptBlocks<__CipherType>::value) {
+                Cipher.DecryptBlocks(pbBlocks, BlockCount);
+            } else {
+                auto pb = reinterpret_cast<uint8_t*>(pbBlocks);
+                for (size_t i = 0; i < BlockCount; ++i)
+                    Cipher.DecryptBlock(pb + i * __CipherType::BlockSizeValue);
+            }
+        }
+
+        //
+        //  pbResult[i] = pbA[i] ^ pbB[i], for i in [0, cb)
+        //  pbResult may be the same as pbA or pbB.
+        //
+        ACCEL_FORCEINLINE
+        void XorBytes(void* pbResult, const void* pbA, const void* pbB, size_t cb) ACCEL_NOEXCEPT {
+            auto r = reinterpret_cast<uint8_t*>(pbResult);
+            auto a = reinterpret_cast<const uint8_t*>(pbA);
+            auto b = reinterpret_cast<const uint8_t*>(pbB);
+            size_t i = 0;
+
+            for (; i + sizeof(uint64_t) <= cb; i += sizeof(uint64_t)) {
+                uint64_t x, y;
+                memcpy(&x, a + i, sizeof(uint64_t));
+                memcpy(&y, b + i, sizeof(uint64_t));
+                x ^= y;
+                memcpy(r + i, &x, sizeof(uint64_t));
+            }
+
+            for (; i < cb; ++i)
+                r[i] = a[i] ^ b[i];
+        }
+
+        //
+        //  Treat the block as one big-endian integer and add 1 to it.
+        //
+        template<size_t __BlockSize>
+        ACCEL_FORCEINLINE
+        void IncreaseCounter(uint8_t (&Counter)[__BlockSize]) ACCEL_NOEXCEPT {
+            for (size_t i = __BlockSize; i > 0; --i) {
+                if (++Counter[i - 1] != 0)
+                    break;
+            }
+        }
+
+        //
+        //  Treat the block as one big-endian integer and add `n` to it.
+        //
+        template<size_t __BlockSize>
+        ACCEL_FORCEINLINE
+        void AdvanceCounter(uint8_t (&Counter)[__BlockSize], uint64_t n) ACCEL_NOEXCEPT {
+            for (size_t i = __BlockSize; i > 0 && n; --i) {
+                n += Counter[i - 1];
+                Counter[i - 1] = static_cast<uint8_t>(n);
+                n >>= 8;
+            }
+        }
+
+    }
+
+}
+
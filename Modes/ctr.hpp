@@ -0,0 +1,170 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Intrinsic.hpp"
+#include "../MemoryAccess.hpp"
+#include "../Array.hpp"
+#include "common.hpp"
+
+namespace accel::Modes::Internal {
+
+    //
+    //  pbOut = pbIn ^ E(Counter), E(Counter + 1), ... for `BlockCount` blocks; Counter is left just past the last one.
+    //  Only reads the cipher, so threads may share one cipher object as long as each has its own counter.
+    //
+    template<typename __CipherType>
+    ACCEL_FORCEINLINE
+    void CounterBlocks(__CipherType& Cipher, uint8_t (&Counter)[__CipherType::BlockSizeValue],
+                       const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+        constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+        uint8_t Keystream[BatchBlocksValue * BlockSizeValue];
+
+        while (BlockCount) {
+            size_t n = BlockCount < BatchBlocksValue ? BlockCount : BatchBlocksValue;
+
+            if constexpr (BlockSizeValue >= sizeof(uint64_t)) {
+                //
+                //  Keep the low 64 bits of the counter in a register while the batch is built.
+                //  Bumping the counter byte by byte and reading it back as a whole block stalls store forwarding on every block.
+                //
+                constexpr size_t LowOffset = BlockSizeValue - sizeof(uint64_t);
+                uint64_t Low = ByteSwap(MemoryReadAs<uint64_t>(Counter + LowOffset));
+
+                for (size_t i = 0; i < n; ++i) {
+                    memcpy(Keystream + i * BlockSizeValue, Counter, LowOffset);
+                    MemoryWriteAs<uint64_t>(Keystream + i * BlockSizeValue + LowOffset, ByteSwap(Low));
+                    if (++Low == 0) {
+                        for (size_t j = LowOffset; j > 0; --j) {
+                            if (++Counter[j - 1] != 0)
+                                break;
+                        }
+                    }
+                }
+
+                MemoryWriteAs<uint64_t>(Counter + LowOffset, ByteSwap(Low));
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    memcpy(Keystream + i * BlockSizeValue, Counter, BlockSizeValue);
+                    IncreaseCounter(Counter);
+                }
+            }
+
+            EncryptBlocks(Cipher, Keystream, n);
+            XorBytes(pbOut, pbIn, Keystream, n * BlockSizeValue);
+
+            pbIn += n * BlockSizeValue;
+            pbOut += n * BlockSizeValue;
+            BlockCount -= n;
+        }
+
+        SecureWipe(Keystream, sizeof(Keystream));
+    }
+
+}
+
+namespace accel::Modes {
+
+    //
+    //  Counter mode. The counter is the whole IV block, incremented as one big-endian integer.
+    //  Counter blocks are independent, so whole blocks are encrypted in batches through the cipher's multi-block kernel.
+    //  Encryption and decryption are the same operation.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class CTR {
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+        static constexpr size_t IVSizeValue = __CipherType::BlockSizeValue;
+    private:
+        __CipherType _Cipher;
+        Array<uint8_t, BlockSizeValue> _Counter;        // the next counter block to encrypt
+        Array<uint8_t, BlockSizeValue> _Keystream;
+        size_t _KeystreamOffset;
+
+    public:
+
+        CTR() ACCEL_NOEXCEPT :
+            _KeystreamOffset(BlockSizeValue) {}
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t IVSize() const ACCEL_NOEXCEPT {
+            return IVSizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            return _Cipher.SetKey(pbUserKey, cbUserKey);
+        }
+
+        //
+        //  Start a new message. `pbIV` is the initial counter block.
+        //
+        ACCEL_NODISCARD
+        bool SetIV(const void* pbIV, size_t cbIV) ACCEL_NOEXCEPT {
+            if (cbIV != IVSizeValue) {
+                return false;
+            } else {
+                _Counter.LoadFrom(pbIV);
+                _KeystreamOffset = BlockSizeValue;
+                return true;
+            }
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write exactly `cbIn` bytes to `pbOut`.
+        //  pbIn == pbOut is allowed.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbLeft = cbIn;
+
+            if (_KeystreamOffset < BlockSizeValue) {
+                size_t cb = BlockSizeValue - _KeystreamOffset < cbLeft ? BlockSizeValue - _KeystreamOffset : cbLeft;
+                Internal::XorBytes(pbOutBytes, pbInBytes, _Keystream.AsCArray() + _KeystreamOffset, cb);
+                _KeystreamOffset += cb;
+                pbInBytes += cb;
+                pbOutBytes += cb;
+                cbLeft -= cb;
+            }
+
+            size_t BlockCount = cbLeft / BlockSizeValue;
+            if (BlockCount) {
+                Internal::CounterBlocks(_Cipher, _Counter.AsCArray(), pbInBytes, pbOutBytes, BlockCount);
+                pbInBytes += BlockCount * BlockSizeValue;
+                pbOutBytes += BlockCount * BlockSizeValue;
+                cbLeft -= BlockCount * BlockSizeValue;
+            }
+
+            if (cbLeft) {
+                _Keystream = _Counter;
+                Internal::IncreaseCounter(_Counter.AsCArray());
+                _Cipher.EncryptBlock(_Keystream.AsCArray());
+                Internal::XorBytes(pbOutBytes, pbInBytes, _Keystream.AsCArray(), cbLeft);
+                _KeystreamOffset = cbLeft;
+            }
+
+            return cbIn;
+        }
+
+        //
+        //  Always succeeds; CTR needs no padding. Call SetIV before the next message.
+        //
+        ACCEL_NODISCARD
+        bool Final() ACCEL_NOEXCEPT {
+            _Counter.SecureZero();
+            _Keystream.SecureZero();
+            _KeystreamOffset = BlockSizeValue;
+            return true;
+        }
+
+        ~CTR() ACCEL_NOEXCEPT {
+            _Counter.SecureZero();
+            _Keystream.SecureZero();
+        }
+    };
+
+}
+
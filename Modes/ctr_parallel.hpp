@@ -0,0 +1,175 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../ThreadPool.hpp"
+#include "common.hpp"
+#include "ctr.hpp"
+#include <memory>
+
+namespace accel::Modes {
+
+    //
+    //  Counter mode that spreads large updates over a thread pool.
+    //  The whole blocks of an update longer than ParallelThresholdValue are cut into chunks, and each chunk starts
+    //  from its own copy of the counter, advanced to the chunk's first block. The output is byte-identical to CTR.
+    //  Shorter updates take the same single-threaded path as CTR.
+    //
+    //  The workers share one cipher object, so the cipher's EncryptBlock/EncryptBlocks must not modify it.
+    //  This holds for every CipherTraits class.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class CTR_PARALLEL {
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+        static constexpr size_t IVSizeValue = __CipherType::BlockSizeValue;
+        static constexpr size_t ParallelThresholdValue = 1024 * 1024;
+    private:
+        //
+        //  A chunk is at least 64 KiB, which keeps the scheduling cost to a fraction of a percent.
+        //  Above that, an update is cut into about 4 chunks per thread so that a slow thread does not hold up the others.
+        //
+        static constexpr size_t _MinChunkBlocks = 64 * 1024 / BlockSizeValue;
+        static constexpr size_t _ChunksPerThread = 4;
+
+        std::unique_ptr<ThreadPool> _OwnedPool;
+        ThreadPool* _Pool;
+
+        __CipherType _Cipher;
+        Array<uint8_t, BlockSizeValue> _Counter;        // the next counter block to encrypt
+        Array<uint8_t, BlockSizeValue> _Keystream;
+        size_t _KeystreamOffset;
+
+        void _ProcessBlocksParallel(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            size_t ChunkBlocks = BlockCount / (_Pool->ThreadCount() * _ChunksPerThread);
+            if (ChunkBlocks < _MinChunkBlocks)
+                ChunkBlocks = _MinChunkBlocks;
+            ChunkBlocks = (ChunkBlocks + Internal::BatchBlocksValue - 1) / Internal::BatchBlocksValue * Internal::BatchBlocksValue;
+
+            size_t ChunkCount = (BlockCount + ChunkBlocks - 1) / ChunkBlocks;
+
+            _Pool->Run(ChunkCount, [this, pbIn, pbOut, BlockCount, ChunkBlocks](size_t ChunkIndex) {
+                size_t FirstBlock = ChunkIndex * ChunkBlocks;
+                size_t n = BlockCount - FirstBlock < ChunkBlocks ? BlockCount - FirstBlock : ChunkBlocks;
+                Array<uint8_t, BlockSizeValue> Counter = _Counter;
+
+                Internal::AdvanceCounter(Counter.AsCArray(), FirstBlock);
+                Internal::CounterBlocks(_Cipher, Counter.AsCArray(), pbIn + FirstBlock * BlockSizeValue, pbOut + FirstBlock * BlockSizeValue, n);
+                Counter.SecureZero();
+            });
+
+            Internal::AdvanceCounter(_Counter.AsCArray(), BlockCount);
+        }
+
+    public:
+
+        //
+        //  Use a pool of its own with `ThreadCount` threads, the calling thread included.
+        //  0 means std::thread::hardware_concurrency(). Throws std::system_error if a thread cannot be started.
+        //
+        explicit CTR_PARALLEL(size_t ThreadCount = 0) :
+            _OwnedPool(new ThreadPool(ThreadCount)),
+            _Pool(_OwnedPool.get()),
+            _KeystreamOffset(BlockSizeValue) {}
+
+        //
+        //  Share `Pool` with other users. The pool must outlive this object, and only one of its users may run at a time.
+        //
+        explicit CTR_PARALLEL(ThreadPool& Pool) ACCEL_NOEXCEPT :
+            _Pool(&Pool),
+            _KeystreamOffset(BlockSizeValue) {}
+
+        CTR_PARALLEL(const CTR_PARALLEL&) = delete;
+        CTR_PARALLEL& operator=(const CTR_PARALLEL&) = delete;
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t IVSize() const ACCEL_NOEXCEPT {
+            return IVSizeValue;
+        }
+
+        size_t ThreadCount() const ACCEL_NOEXCEPT {
+            return _Pool->ThreadCount();
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            return _Cipher.SetKey(pbUserKey, cbUserKey);
+        }
+
+        //
+        //  Start a new message. `pbIV` is the initial counter block.
+        //
+        ACCEL_NODISCARD
+        bool SetIV(const void* pbIV, size_t cbIV) ACCEL_NOEXCEPT {
+            if (cbIV != IVSizeValue) {
+                return false;
+            } else {
+                _Counter.LoadFrom(pbIV);
+                _KeystreamOffset = BlockSizeValue;
+                return true;
+            }
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write exactly `cbIn` bytes to `pbOut`.
+        //  pbIn == pbOut is allowed; other overlaps are not.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbLeft = cbIn;
+
+            if (_KeystreamOffset < BlockSizeValue) {
+                size_t cb = BlockSizeValue - _KeystreamOffset < cbLeft ? BlockSizeValue - _KeystreamOffset : cbLeft;
+                Internal::XorBytes(pbOutBytes, pbInBytes, _Keystream.AsCArray() + _KeystreamOffset, cb);
+                _KeystreamOffset += cb;
+                pbInBytes += cb;
+                pbOutBytes += cb;
+                cbLeft -= cb;
+            }
+
+            size_t BlockCount = cbLeft / BlockSizeValue;
+            if (BlockCount) {
+                if (BlockCount * BlockSizeValue > ParallelThresholdValue && _Pool->ThreadCount() > 1) {
+                    _ProcessBlocksParallel(pbInBytes, pbOutBytes, BlockCount);
+                } else {
+                    Internal::CounterBlocks(_Cipher, _Counter.AsCArray(), pbInBytes, pbOutBytes, BlockCount);
+                }
+
+                pbInBytes += BlockCount * BlockSizeValue;
+                pbOutBytes += BlockCount * BlockSizeValue;
+                cbLeft -= BlockCount * BlockSizeValue;
+            }
+
+            if (cbLeft) {
+                _Keystream = _Counter;
+                Internal::IncreaseCounter(_Counter.AsCArray());
+                _Cipher.EncryptBlock(_Keystream.AsCArray());
+                Internal::XorBytes(pbOutBytes, pbInBytes, _Keystream.AsCArray(), cbLeft);
+                _KeystreamOffset = cbLeft;
+            }
+
+            return cbIn;
+        }
+
+        //
+        //  Always succeeds; CTR needs no padding. Call SetIV before the next message.
+        //
+        ACCEL_NODISCARD
+        bool Final() ACCEL_NOEXCEPT {
+            _Counter.SecureZero();
+            _Keystream.SecureZero();
+            _KeystreamOffset = BlockSizeValue;
+            return true;
+        }
+
+        ~CTR_PARALLEL() ACCEL_NOEXCEPT {
+            _Counter.SecureZero();
+            _Keystream.SecureZero();
+        }
+    };
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "common.hpp"
+
+namespace accel::Modes {
+
+    //
+    //  Electronic codebook.
+    //  Data that does not fill a whole block is kept until the next Update; no padding is applied.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class ECB {
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+    private:
+        __CipherType _Cipher;
+        Array<uint8_t, BlockSizeValue> _Buffer;
+        size_t _BufferedLength;
+
+        ACCEL_FORCEINLINE
+        void _ProcessBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            if (pbIn != pbOut)
+                memmove(pbOut, pbIn, BlockCount * BlockSizeValue);
+
+            if constexpr (__Direction == Direction::Encryption) {
+                Internal::EncryptBlocks(_Cipher, pbOut, BlockCount);
+            } else {
+                Internal::DecryptBlocks(_Cipher, pbOut, BlockCount);
+            }
+        }
+
+    public:
+
+        ECB() ACCEL_NOEXCEPT :
+            _BufferedLength(0) {}
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            _BufferedLength = 0;
+            return _Cipher.SetKey(pbUserKey, cbUserKey);
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write the result to `pbOut`.
+        //  Returns the number of bytes written, which is always a multiple of BlockSizeValue.
+        //  `pbOut` must have room for `cbIn + BlockSizeValue - 1` bytes.
+        //  In-place operation (pbIn == pbOut) is allowed as long as no partial block is pending.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbOut = 0;
+
+            if (_BufferedLength) {
+                size_t cbCopy = BlockSizeValue - _BufferedLength < cbIn ? BlockSizeValue - _BufferedLength : cbIn;
+
+                memcpy(_Buffer.AsCArray() + _BufferedLength, pbInBytes, cbCopy);
+                _BufferedLength += cbCopy;
+                pbInBytes += cbCopy;
+                cbIn -= cbCopy;
+
+                if (_BufferedLength < BlockSizeValue)
+                    return 0;
+
+                _ProcessBlocks(_Buffer.AsCArray(), pbOutBytes, 1);
+                _BufferedLength = 0;
+                pbOutBytes += BlockSizeValue;
+                cbOut += BlockSizeValue;
+            }
+
+            size_t BlockCount = cbIn / BlockSizeValue;
+            if (BlockCount) {
+                _ProcessBlocks(pbInBytes, pbOutBytes, BlockCount);
+                pbInBytes += BlockCount * BlockSizeValue;
+                cbIn -= BlockCount * BlockSizeValue;
+                cbOut += BlockCount * BlockSizeValue;
+            }
+
+            if (cbIn) {
+                memcpy(_Buffer.AsCArray(), pbInBytes, cbIn);
+                _BufferedLength = cbIn;
+            }
+
+            return cbOut;
+        }
+
+        //
+        //  Returns false if the data passed to Update was not a multiple of BlockSizeValue.
+        //  The pending partial block, if any, is discarded.
+        //
+        ACCEL_NODISCARD
+        bool Final() ACCEL_NOEXCEPT {
+            bool Aligned = _BufferedLength == 0;
+            _Buffer.SecureZero();
+            _BufferedLength = 0;
+            return Aligned;
+        }
+
+        ~ECB() ACCEL_NOEXCEPT {
+            _Buffer.SecureZero();
+        }
+    };
+
+}
+
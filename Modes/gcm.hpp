@@ -0,0 +1,488 @@
+#pragma once
+#include "../Config.hpp"
+#include "../CpuFeatures.hpp"
+#include "../Array.hpp"
+#include "../Intrinsic.hpp"
+#include "../MemoryAccess.hpp"
+#include "../CipherTraits/aes_aesni.hpp"
+#include "common.hpp"
+#include "Internal/ghash.hpp"
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace accel::Modes {
+
+    //
+    //  Galois/Counter Mode (NIST SP 800-38D) over any cipher with a 128-bit block.
+    //
+    //  GHASH runs on PCLMULQDQ when the host has it, otherwise on 4-bit tables.
+    //  With AES_AESNI_ALG and PCLMULQDQ, AES-CTR and GHASH are stitched into one loop over 8 blocks,
+    //  so the AES rounds of one batch hide the latency of the carry-less multiplications of another.
+    //
+    //  Usage: SetKey, then for every message SetIV, UpdateAAD (optional, any number of times), Update, Final.
+    //  On decryption, Update releases plaintext before the tag is checked; discard it if Final fails.
+    //  A message holds at most 2^36 - 32 bytes of text and 2^61 - 1 bytes of AAD (SP 800-38D, 5.2.1.1).
+    //  Past that the 32-bit counter would wrap back to J0, so Update and UpdateAAD refuse such input.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class GCM {
+        static_assert(__CipherType::BlockSizeValue == 16, "GCM failure! Block size must be 128 bits.");
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t TagSizeValue = 16;
+        static constexpr uint64_t MaxTextLengthValue = (uint64_t{ 1 } << 36) - 32;
+        static constexpr uint64_t MaxAadLengthValue = (uint64_t{ 1 } << 61) - 1;
+    private:
+        static constexpr size_t _BatchBlocks = Internal::BatchBlocksValue;
+        static constexpr bool _CanStitch = Internal::IsAesNiCipher<__CipherType>::value;
+
+        __CipherType _Cipher;
+        std::variant<Internal::GHASH_PORTABLE, Internal::GHASH_PCLMUL> _Ghash;
+        Array<uint8_t, BlockSizeValue> _Counter;        // the next counter block to encrypt
+        Array<uint8_t, BlockSizeValue> _TagMask;        // E(K, J0)
+        Array<uint8_t, BlockSizeValue> _Keystream;
+        Array<uint8_t, BlockSizeValue> _Block;          // the partial AAD or ciphertext block not hashed yet
+        size_t _KeystreamOffset;
+        size_t _AadBufferedLength;
+        uint64_t _AadLength;
+        uint64_t _TextLength;
+        bool _AadFinished;
+
+        ACCEL_FORCEINLINE
+        void _GhashUpdate(const void* pbBlocks, size_t BlockCount) ACCEL_NOEXCEPT {
+            std::visit([pbBlocks, BlockCount](auto& Ghash) { Ghash.Update(pbBlocks, BlockCount); }, _Ghash);
+        }
+
+        ACCEL_FORCEINLINE
+        void _FinishAad() ACCEL_NOEXCEPT {
+            if (_AadFinished == false) {
+                if (_AadBufferedLength) {
+                    memset(_Block.AsCArray() + _AadBufferedLength, 0, BlockSizeValue - _AadBufferedLength);
+                    _GhashUpdate(_Block.AsCArray(), 1);
+                    _AadBufferedLength = 0;
+                }
+                _AadFinished = true;
+            }
+        }
+
+        //
+        //  inc32: only the last 32 bits of the counter block are incremented, modulo 2^32.
+        //
+        ACCEL_FORCEINLINE
+        void _NextCounterBlock(uint8_t* pbBlock) ACCEL_NOEXCEPT {
+            uint32_t Count = ByteSwap(MemoryReadAs<uint32_t>(_Counter.AsCArray() + 12));
+            memcpy(pbBlock, _Counter.AsCArray(), BlockSizeValue);
+            MemoryWriteAs<uint32_t>(_Counter.AsCArray() + 12, ByteSwap(Count + 1));
+        }
+
+        ACCEL_FORCEINLINE
+        void _ProcessBlocksGeneric(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            uint8_t Keystream[_BatchBlocks * BlockSizeValue];
+            uint32_t Count = ByteSwap(MemoryReadAs<uint32_t>(_Counter.AsCArray() + 12));
+
+            while (BlockCount) {
+                size_t n = BlockCount < _BatchBlocks ? BlockCount : _BatchBlocks;
+
+                for (size_t i = 0; i < n; ++i) {
+                    memcpy(Keystream + i * BlockSizeValue, _Counter.AsCArray(), 12);
+                    MemoryWriteAs<uint32_t>(Keystream + i * BlockSizeValue + 12, ByteSwap(Count++));
+                }
+
+                Internal::EncryptBlocks(_Cipher, Keystream, n);
+
+                if constexpr (__Direction == Direction::Encryption) {
+                    Internal::XorBytes(pbOut, pbIn, Keystream, n * BlockSizeValue);
+                    _GhashUpdate(pbOut, n);
+                } else {
+                    _GhashUpdate(pbIn, n);
+                    Internal::XorBytes(pbOut, pbIn, Keystream, n * BlockSizeValue);
+                }
+
+                pbIn += n * BlockSizeValue;
+                pbOut += n * BlockSizeValue;
+                BlockCount -= n;
+            }
+
+            MemoryWriteAs<uint32_t>(_Counter.AsCArray() + 12, ByteSwap(Count));
+            SecureWipe(Keystream, sizeof(Keystream));
+        }
+
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
+        static void _AesRound(__m128i (&Lanes)[sizeof...(__LaneIndexes)], __m128i RoundKey, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            ((Lanes[__LaneIndexes] = _mm_aesenc_si128(Lanes[__LaneIndexes], RoundKey)), ...);
+        }
+
+        //
+        //  Encrypt `sizeof...(__LaneIndexes)` counter blocks and XOR them into pbIn -> pbOut.
+        //  If __WithGhash, the same number of blocks at pbGhash are folded into Y between the AES rounds.
+        //  This function is for internal use only.
+        //
+        template<bool __WithGhash, size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes,pclmul,ssse3")
+        void _StitchedLanes(const uint8_t* pbIn, uint8_t* pbOut, const uint8_t* pbGhash,
+                            __m128i& Counter, __m128i& Y, std::index_sequence<__LaneIndexes...>) ACCEL_NOEXCEPT {
+            using GhashType = Internal::GHASH_PCLMUL;
+            constexpr size_t n = sizeof...(__LaneIndexes);
+            constexpr size_t Nr = __CipherType::RoundsValue;
+            static_assert(n <= Nr - 1);
+
+            const GhashType& Ghash = *std::get_if<GhashType>(&_Ghash);
+            __m128i Lanes[n];
+
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(GhashType::Reflect(_mm_add_epi32(Counter, _mm_set_epi32(0, 0, 0, __LaneIndexes))), _Cipher.EncryptionRoundKey(0))), ...);
+            Counter = _mm_add_epi32(Counter, _mm_set_epi32(0, 0, 0, n));
+
+            if constexpr (__WithGhash) {
+                __m128i Lo = _mm_setzero_si128();
+                __m128i Mid = _mm_setzero_si128();
+                __m128i Hi = _mm_setzero_si128();
+
+                //
+                //  Round i + 1 of every lane, interleaved with the multiplication of GHASH block n - 1 - i.
+                //  The block that depends on Y goes last, to give the previous reduction time to finish.
+                //
+                ((_AesRound(Lanes, _Cipher.EncryptionRoundKey(__LaneIndexes + 1), std::index_sequence<__LaneIndexes...>{}),
+                  GhashType::MultiplyAccumulate(GhashType::LoadBlock(pbGhash, Y, std::integral_constant<size_t, n - 1 - __LaneIndexes>{}),
+                                                Ghash.HPower(__LaneIndexes), Ghash.HPowerFolded(__LaneIndexes), Lo, Mid, Hi)), ...);
+
+                for (size_t i = n + 1; i < Nr; ++i)
+                    _AesRound(Lanes, _Cipher.EncryptionRoundKey(i), std::index_sequence<__LaneIndexes...>{});
+
+                Y = GhashType::Reduce(Lo, Mid, Hi);
+            } else {
+                for (size_t i = 1; i < Nr; ++i)
+                    _AesRound(Lanes, _Cipher.EncryptionRoundKey(i), std::index_sequence<__LaneIndexes...>{});
+            }
+
+            ((Lanes[__LaneIndexes] = _mm_aesenclast_si128(Lanes[__LaneIndexes], _Cipher.EncryptionRoundKey(Nr))), ...);
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(Lanes[__LaneIndexes], MemoryReadAs<__m128i>(pbIn, BlockSizeValue, __LaneIndexes))), ...);
+            (MemoryWriteAs<__m128i>(pbOut, BlockSizeValue, __LaneIndexes, Lanes[__LaneIndexes]), ...);
+        }
+
+        //
+        //  Decryption hashes the ciphertext of the batch it is decrypting.
+        //  Encryption hashes the ciphertext of the previous batch, which is why it lags one batch behind.
+        //
+        ACCEL_TARGET("aes,pclmul,ssse3")
+        void _ProcessBlocksStitched(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            using GhashType = Internal::GHASH_PCLMUL;
+            GhashType& Ghash = *std::get_if<GhashType>(&_Ghash);
+            __m128i Counter = GhashType::Reflect(MemoryReadAs<__m128i>(_Counter.AsCArray()));
+            __m128i Y = Ghash.State();
+
+            if constexpr (__Direction == Direction::Encryption) {
+                if (BlockCount >= 8) {
+                    _StitchedLanes<false>(pbIn, pbOut, nullptr, Counter, Y, std::make_index_sequence<8>{});
+                    pbIn += 8 * BlockSizeValue;
+                    pbOut += 8 * BlockSizeValue;
+                    BlockCount -= 8;
+
+                    for (; BlockCount >= 8; BlockCount -= 8, pbIn += 8 * BlockSizeValue, pbOut += 8 * BlockSizeValue)
+                        _StitchedLanes<true>(pbIn, pbOut, pbOut - 8 * BlockSizeValue, Counter, Y, std::make_index_sequence<8>{});
+
+                    Y = Ghash.Aggregate(Y, pbOut - 8 * BlockSizeValue, std::make_index_sequence<8>{});
+                }
+
+                if (BlockCount >= 4) {
+                    _StitchedLanes<false>(pbIn, pbOut, nullptr, Counter, Y, std::make_index_sequence<4>{});
+                    Y = Ghash.Aggregate(Y, pbOut, std::make_index_sequence<4>{});
+                    pbIn += 4 * BlockSizeValue;
+                    pbOut += 4 * BlockSizeValue;
+                    BlockCount -= 4;
+                }
+
+                for (; BlockCount; --BlockCount, pbIn += BlockSizeValue, pbOut += BlockSizeValue) {
+                    _StitchedLanes<false>(pbIn, pbOut, nullptr, Counter, Y, std::make_index_sequence<1>{});
+                    Y = Ghash.Aggregate(Y, pbOut, std::make_index_sequence<1>{});
+                }
+            } else {
+                for (; BlockCount >= 8; BlockCount -= 8, pbIn += 8 * BlockSizeValue, pbOut += 8 * BlockSizeValue)
+                    _StitchedLanes<true>(pbIn, pbOut, pbIn, Counter, Y, std::make_index_sequence<8>{});
+
+                if (BlockCount >= 4) {
+                    _StitchedLanes<true>(pbIn, pbOut, pbIn, Counter, Y, std::make_index_sequence<4>{});
+                    pbIn += 4 * BlockSizeValue;
+                    pbOut += 4 * BlockSizeValue;
+                    BlockCount -= 4;
+                }
+
+                for (; BlockCount; --BlockCount, pbIn += BlockSizeValue, pbOut += BlockSizeValue)
+                    _StitchedLanes<true>(pbIn, pbOut, pbIn, Counter, Y, std::make_index_sequence<1>{});
+            }
+
+            MemoryWriteAs<__m128i>(_Counter.AsCArray(), GhashType::Reflect(Counter));
+            Ghash.SetState(Y);
+        }
+
+        ACCEL_FORCEINLINE
+        void _ProcessBlocks(const uint8_t* pbIn, uint8_t* pbOut, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (_CanStitch) {
+                if (std::holds_alternative<Internal::GHASH_PCLMUL>(_Ghash)) {
+                    _ProcessBlocksStitched(pbIn, pbOut, BlockCount);
+                    return;
+                }
+            }
+            _ProcessBlocksGeneric(pbIn, pbOut, BlockCount);
+        }
+
+        ACCEL_FORCEINLINE
+        void _ProcessBytes(const uint8_t* pbIn, uint8_t* pbOut, size_t cb) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < cb; ++i, ++_KeystreamOffset) {
+                uint8_t In = pbIn[i];
+                uint8_t Out = In ^ _Keystream[_KeystreamOffset];
+
+                pbOut[i] = Out;
+                if constexpr (__Direction == Direction::Encryption) {
+                    _Block[_KeystreamOffset] = Out;
+                } else {
+                    _Block[_KeystreamOffset] = In;
+                }
+            }
+
+            if (_KeystreamOffset == BlockSizeValue) {
+                _GhashUpdate(_Block.AsCArray(), 1);
+            }
+        }
+
+        ACCEL_FORCEINLINE
+        void _ComputeTag(uint8_t (&Tag)[TagSizeValue]) ACCEL_NOEXCEPT {
+            _FinishAad();
+
+            if (_KeystreamOffset < BlockSizeValue) {
+                memset(_Block.AsCArray() + _KeystreamOffset, 0, BlockSizeValue - _KeystreamOffset);
+                _GhashUpdate(_Block.AsCArray(), 1);
+                _KeystreamOffset = BlockSizeValue;
+            }
+
+            MemoryWriteAs<uint64_t>(_Block.AsCArray(), ByteSwap(_AadLength * 8));
+            MemoryWriteAs<uint64_t>(_Block.AsCArray() + 8, ByteSwap(_TextLength * 8));
+            _GhashUpdate(_Block.AsCArray(), 1);
+
+            std::visit([&Tag](auto& Ghash) { Ghash.Digest(Tag); }, _Ghash);
+            Internal::XorBytes(Tag, Tag, _TagMask.AsCArray(), TagSizeValue);
+        }
+
+        ACCEL_FORCEINLINE
+        void _Wipe() ACCEL_NOEXCEPT {
+            _Counter.SecureZero();
+            _TagMask.SecureZero();
+            _Keystream.SecureZero();
+            _Block.SecureZero();
+            std::visit([](auto& Ghash) { Ghash.Reset(); }, _Ghash);
+        }
+
+    public:
+
+        GCM() ACCEL_NOEXCEPT :
+            _KeystreamOffset(BlockSizeValue),
+            _AadBufferedLength(0),
+            _AadLength(0),
+            _TextLength(0),
+            _AadFinished(false)
+        {
+            const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+            if (Features.PCLMULQDQ && Features.SSSE3) {
+                _Ghash.template emplace<Internal::GHASH_PCLMUL>();
+            }
+        }
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t TagSize() const ACCEL_NOEXCEPT {
+            return TagSizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            if (_Cipher.SetKey(pbUserKey, cbUserKey)) {
+                uint8_t H[BlockSizeValue] = {};
+                _Cipher.EncryptBlock(H);
+                std::visit([&H](auto& Ghash) { Ghash.SetH(H); }, _Ghash);
+                SecureWipe(H, sizeof(H));
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        //
+        //  Start a new message. A 96-bit IV is used directly; any other non-zero length is hashed into J0.
+        //
+        ACCEL_NODISCARD
+        bool SetIV(const void* pbIV, size_t cbIV) ACCEL_NOEXCEPT {
+            if (cbIV == 0) {
+                return false;
+            }
+
+            std::visit([](auto& Ghash) { Ghash.Reset(); }, _Ghash);
+
+            if (cbIV == 12) {
+                memcpy(_Counter.AsCArray(), pbIV, 12);
+                MemoryWriteAs<uint32_t>(_Counter.AsCArray() + 12, ByteSwap<uint32_t>(1));
+            } else {
+                size_t FullBlocks = cbIV / BlockSizeValue;
+                size_t cbLeft = cbIV % BlockSizeValue;
+
+                _GhashUpdate(pbIV, FullBlocks);
+                if (cbLeft) {
+                    _Block.SecureZero();
+                    memcpy(_Block.AsCArray(), reinterpret_cast<const uint8_t*>(pbIV) + FullBlocks * BlockSizeValue, cbLeft);
+                    _GhashUpdate(_Block.AsCArray(), 1);
+                }
+
+                MemoryWriteAs<uint64_t>(_Block.AsCArray(), 0);
+                MemoryWriteAs<uint64_t>(_Block.AsCArray() + 8, ByteSwap<uint64_t>(cbIV * 8));
+                _GhashUpdate(_Block.AsCArray(), 1);
+
+                std::visit([this](auto& Ghash) { Ghash.Digest(_Counter.AsCArray()); Ghash.Reset(); }, _Ghash);
+            }
+
+            _TagMask = _Counter;
+            _Cipher.EncryptBlock(_TagMask.AsCArray());
+            MemoryWriteAs<uint32_t>(_Counter.AsCArray() + 12, ByteSwap(ByteSwap(MemoryReadAs<uint32_t>(_Counter.AsCArray() + 12)) + 1));
+
+            _KeystreamOffset = BlockSizeValue;
+            _AadBufferedLength = 0;
+            _AadLength = 0;
+            _TextLength = 0;
+            _AadFinished = false;
+            return true;
+        }
+
+        //
+        //  Authenticate additional data. Must come before the first Update of the message.
+        //  Returns false, and changes nothing, if the AAD of the message would exceed MaxAadLengthValue bytes.
+        //
+        ACCEL_NODISCARD
+        bool UpdateAAD(const void* pbAAD, size_t cbAAD) ACCEL_NOEXCEPT {
+            if (_AadFinished || cbAAD > MaxAadLengthValue - _AadLength) {
+                return false;
+            }
+
+            auto pbBytes = reinterpret_cast<const uint8_t*>(pbAAD);
+            _AadLength += cbAAD;
+
+            if (_AadBufferedLength) {
+                size_t cb = BlockSizeValue - _AadBufferedLength < cbAAD ? BlockSizeValue - _AadBufferedLength : cbAAD;
+                memcpy(_Block.AsCArray() + _AadBufferedLength, pbBytes, cb);
+                _AadBufferedLength += cb;
+                pbBytes += cb;
+                cbAAD -= cb;
+
+                if (_AadBufferedLength == BlockSizeValue) {
+                    _GhashUpdate(_Block.AsCArray(), 1);
+                    _AadBufferedLength = 0;
+                }
+            }
+
+            _GhashUpdate(pbBytes, cbAAD / BlockSizeValue);
+            pbBytes += cbAAD / BlockSizeValue * BlockSizeValue;
+            cbAAD %= BlockSizeValue;
+
+            if (cbAAD) {
+                memcpy(_Block.AsCArray(), pbBytes, cbAAD);
+                _AadBufferedLength = cbAAD;
+            }
+
+            return true;
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write exactly `cbIn` bytes to `pbOut`.
+        //  pbIn == pbOut is allowed.
+        //  Returns 0, and processes nothing, if the text of the message would exceed MaxTextLengthValue bytes.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbLeft = cbIn;
+
+            if (cbIn > MaxTextLengthValue - _TextLength) {
+                return 0;
+            }
+
+            _FinishAad();
+            _TextLength += cbIn;
+
+            if (_KeystreamOffset < BlockSizeValue) {
+                size_t cb = BlockSizeValue - _KeystreamOffset < cbLeft ? BlockSizeValue - _KeystreamOffset : cbLeft;
+                _ProcessBytes(pbInBytes, pbOutBytes, cb);
+                pbInBytes += cb;
+                pbOutBytes += cb;
+                cbLeft -= cb;
+            }
+
+            size_t BlockCount = cbLeft / BlockSizeValue;
+            if (BlockCount) {
+                _ProcessBlocks(pbInBytes, pbOutBytes, BlockCount);
+                pbInBytes += BlockCount * BlockSizeValue;
+                pbOutBytes += BlockCount * BlockSizeValue;
+                cbLeft -= BlockCount * BlockSizeValue;
+            }
+
+            if (cbLeft) {
+                _NextCounterBlock(_Keystream.AsCArray());
+                _Cipher.EncryptBlock(_Keystream.AsCArray());
+                _KeystreamOffset = 0;
+                _ProcessBytes(pbInBytes, pbOutBytes, cbLeft);
+            }
+
+            return cbIn;
+        }
+
+        //
+        //  Write the first `cbTag` bytes of the tag. 4, 8 and 12 ... 16 bytes are allowed.
+        //
+        template<Direction __D = __Direction, typename = typename std::enable_if<__D == Direction::Encryption>::type>
+        ACCEL_NODISCARD
+        bool Final(void* pbTag, size_t cbTag) ACCEL_NOEXCEPT {
+            if (cbTag != 4 && cbTag != 8 && (cbTag < 12 || cbTag > TagSizeValue)) {
+                return false;
+            }
+
+            uint8_t Tag[TagSizeValue];
+            _ComputeTag(Tag);
+            memcpy(pbTag, Tag, cbTag);
+
+            SecureWipe(Tag, sizeof(Tag));
+            _Wipe();
+            return true;
+        }
+
+        //
+        //  Check the tag in constant time. Returns false if it does not match.
+        //
+        template<Direction __D = __Direction, typename = typename std::enable_if<__D == Direction::Decryption>::type>
+        ACCEL_NODISCARD
+        bool Final(const void* pbTag, size_t cbTag) ACCEL_NOEXCEPT {
+            if (cbTag != 4 && cbTag != 8 && (cbTag < 12 || cbTag > TagSizeValue)) {
+                return false;
+            }
+
+            uint8_t Tag[TagSizeValue];
+            uint8_t Difference = 0;
+
+            _ComputeTag(Tag);
+            for (size_t i = 0; i < cbTag; ++i)
+                Difference |= Tag[i] ^ reinterpret_cast<const uint8_t*>(pbTag)[i];
+
+            SecureWipe(Tag, sizeof(Tag));
+            _Wipe();
+            return Difference == 0;
+        }
+
+        ~GCM() ACCEL_NOEXCEPT {
+            _Wipe();
+        }
+    };
+
+}
+
@@ -0,0 +1,98 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "common.hpp"
+
+namespace accel::Modes {
+
+    //
+    //  Output feedback.
+    //  The keystream is a chain of block encryptions, so there is nothing to parallelize;
+    //  encryption and decryption are the same operation.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class OFB {
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = __CipherType::BlockSizeValue;
+        static constexpr size_t IVSizeValue = __CipherType::BlockSizeValue;
+    private:
+        __CipherType _Cipher;
+        Array<uint8_t, BlockSizeValue> _Register;       // the current keystream block (or IV)
+        size_t _KeystreamOffset;
+
+    public:
+
+        OFB() ACCEL_NOEXCEPT :
+            _KeystreamOffset(BlockSizeValue) {}
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t IVSize() const ACCEL_NOEXCEPT {
+            return IVSizeValue;
+        }
+
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            return _Cipher.SetKey(pbUserKey, cbUserKey);
+        }
+
+        //
+        //  Start a new message.
+        //
+        ACCEL_NODISCARD
+        bool SetIV(const void* pbIV, size_t cbIV) ACCEL_NOEXCEPT {
+            if (cbIV != IVSizeValue) {
+                return false;
+            } else {
+                _Register.LoadFrom(pbIV);
+                _KeystreamOffset = BlockSizeValue;
+                return true;
+            }
+        }
+
+        //
+        //  Process `cbIn` bytes from `pbIn` and write exactly `cbIn` bytes to `pbOut`.
+        //  pbIn == pbOut is allowed.
+        //
+        size_t Update(const void* pbIn, size_t cbIn, void* pbOut) ACCEL_NOEXCEPT {
+            auto pbInBytes = reinterpret_cast<const uint8_t*>(pbIn);
+            auto pbOutBytes = reinterpret_cast<uint8_t*>(pbOut);
+            size_t cbLeft = cbIn;
+
+            while (cbLeft) {
+                if (_KeystreamOffset == BlockSizeValue) {
+                    _Cipher.EncryptBlock(_Register.AsCArray());
+                    _KeystreamOffset = 0;
+                }
+
+                size_t cb = BlockSizeValue - _KeystreamOffset < cbLeft ? BlockSizeValue - _KeystreamOffset : cbLeft;
+                Internal::XorBytes(pbOutBytes, pbInBytes, _Register.AsCArray() + _KeystreamOffset, cb);
+                _KeystreamOffset += cb;
+                pbInBytes += cb;
+                pbOutBytes += cb;
+                cbLeft -= cb;
+            }
+
+            return cbIn;
+        }
+
+        //
+        //  Always succeeds; OFB needs no padding. Call SetIV before the next message.
+        //
+        ACCEL_NODISCARD
+        bool Final() ACCEL_NOEXCEPT {
+            _Register.SecureZero();
+            _KeystreamOffset = BlockSizeValue;
+            return true;
+        }
+
+        ~OFB() ACCEL_NOEXCEPT {
+            _Register.SecureZero();
+        }
+    };
+
+}
+
@@ -0,0 +1,368 @@
+#pragma once
+#include "../Config.hpp"
+#include "../Array.hpp"
+#include "../Intrinsic.hpp"
+#include "../MemoryAccess.hpp"
+#include "../CipherTraits/aes_aesni.hpp"
+#include "common.hpp"
+#include <utility>
+
+namespace accel::Modes {
+
+    //
+    //  One data unit (sector) of an XTS batch. pbIn == pbOut is allowed.
+    //
+    struct XTSSector {
+        uint64_t Number;
+        const void* pbIn;
+        void* pbOut;
+        size_t cbData;
+    };
+
+    //
+    //  XTS-AES (IEEE 1619 / NIST SP 800-38E) over any cipher with a 128-bit block.
+    //
+    //  Sectors are submitted in batches. The initial tweaks of a batch are encrypted together,
+    //  and data blocks are staged into one stream that may cross sector boundaries before they go to the
+    //  cipher's multi-block kernel, so short sectors still keep the pipeline full.
+    //  Tweaks are doubled in GF(2^128) inside SSE2 registers.
+    //  Sectors whose length is not a multiple of 16 bytes are finished with ciphertext stealing.
+    //
+    template<typename __CipherType, Direction __Direction>
+    class XTS {
+        static_assert(__CipherType::BlockSizeValue == 16, "XTS failure! Block size must be 128 bits.");
+    public:
+        using CipherType = __CipherType;
+        static constexpr size_t BlockSizeValue = 16;
+        static constexpr size_t KeySizeValue = 2 * __CipherType::KeySizeValue;
+    private:
+        static constexpr size_t _BatchBlocks = Internal::BatchBlocksValue;
+
+        __CipherType _DataCipher;
+        __CipherType _TweakCipher;
+
+        static constexpr bool _CanFuse = Internal::IsAesNiCipher<__CipherType>::value;
+
+        //
+        //  Blocks waiting for the cipher: where they come from, their tweaks and where the results go.
+        //
+        struct _StagingArea {
+            const uint8_t* Sources[_BatchBlocks];
+            uint8_t* Targets[_BatchBlocks];
+            __m128i Tweaks[_BatchBlocks];
+            size_t Count;
+        };
+
+        //
+        //  T * alpha in GF(2^128), little-endian convention of IEEE 1619.
+        //
+        ACCEL_FORCEINLINE
+        static __m128i _DoubleTweak(__m128i Tweak) ACCEL_NOEXCEPT {
+            __m128i Carry = _mm_shuffle_epi32(_mm_srai_epi32(Tweak, 31), 0x93);
+            Carry = _mm_and_si128(Carry, _mm_set_epi32(1, 1, 1, 0x87));
+            return _mm_xor_si128(_mm_slli_epi32(Tweak, 1), Carry);
+        }
+
+        ACCEL_FORCEINLINE
+        void _CipherBlocks(void* pbBlocks, size_t BlockCount) ACCEL_NOEXCEPT {
+            if constexpr (__Direction == Direction::Encryption) {
+                Internal::EncryptBlocks(_DataCipher, pbBlocks, BlockCount);
+            } else {
+                Internal::DecryptBlocks(_DataCipher, pbBlocks, BlockCount);
+            }
+        }
+
+        //
+        //  Lanes = AES(Lanes) or AES^-1(Lanes) with the round keys of _DataCipher.
+        //  This function is for internal use only.
+        //
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
+        void _FusedRounds(__m128i (&Lanes)[sizeof...(__LaneIndexes)], std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            constexpr size_t Nr = __CipherType::RoundsValue;
+            auto RoundKey = [this](size_t i) -> __m128i {
+                if constexpr (__Direction == Direction::Encryption) {
+                    return _DataCipher.EncryptionRoundKey(i);
+                } else {
+                    return _DataCipher.DecryptionRoundKey(i);
+                }
+            };
+
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(Lanes[__LaneIndexes], RoundKey(0))), ...);
+
+            for (size_t i = 1; i < Nr; ++i) {
+                __m128i Key = RoundKey(i);
+                if constexpr (__Direction == Direction::Encryption) {
+                    ((Lanes[__LaneIndexes] = _mm_aesenc_si128(Lanes[__LaneIndexes], Key)), ...);
+                } else {
+                    ((Lanes[__LaneIndexes] = _mm_aesdec_si128(Lanes[__LaneIndexes], Key)), ...);
+                }
+            }
+
+            if constexpr (__Direction == Direction::Encryption) {
+                ((Lanes[__LaneIndexes] = _mm_aesenclast_si128(Lanes[__LaneIndexes], RoundKey(Nr))), ...);
+            } else {
+                ((Lanes[__LaneIndexes] = _mm_aesdeclast_si128(Lanes[__LaneIndexes], RoundKey(Nr))), ...);
+            }
+        }
+
+        //
+        //  With AES_AESNI_ALG the tweak whitening stays in registers: every staged block is loaded once,
+        //  goes through all rounds and is stored once, whichever sector it belongs to.
+        //  This function is for internal use only.
+        //
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
+        void _FusedLanes(const _StagingArea& Staging, size_t Offset, std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            __m128i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(Staging.Sources[Offset + __LaneIndexes]), Staging.Tweaks[Offset + __LaneIndexes])), ...);
+            _FusedRounds(Lanes, std::index_sequence<__LaneIndexes...>{});
+            (MemoryWriteAs<__m128i>(Staging.Targets[Offset + __LaneIndexes], _mm_xor_si128(Lanes[__LaneIndexes], Staging.Tweaks[Offset + __LaneIndexes])), ...);
+        }
+
+        //
+        //  8 consecutive blocks of one sector, with their tweaks derived in registers from `Tweak`,
+        //  which is advanced past them. The doubling chain of the next call overlaps the AES rounds of this one.
+        //  This function is for internal use only.
+        //
+        template<size_t... __LaneIndexes>
+        ACCEL_FORCEINLINE
+        ACCEL_TARGET("aes")
+        void _FusedRun(const uint8_t* pbIn, uint8_t* pbOut, __m128i& Tweak, std::index_sequence<__LaneIndexes...>) const ACCEL_NOEXCEPT {
+            __m128i Tweaks[sizeof...(__LaneIndexes)];
+            __m128i Lanes[sizeof...(__LaneIndexes)];
+
+            ((Tweaks[__LaneIndexes] = Tweak, Tweak = _DoubleTweak(Tweak)), ...);
+            ((Lanes[__LaneIndexes] = _mm_xor_si128(MemoryReadAs<__m128i>(pbIn, BlockSizeValue, __LaneIndexes), Tweaks[__LaneIndexes])), ...);
+            _FusedRounds(Lanes, std::index_sequence<__LaneIndexes...>{});
+            (MemoryWriteAs<__m128i>(pbOut, BlockSizeValue, __LaneIndexes, _mm_xor_si128(Lanes[__LaneIndexes], Tweaks[__LaneIndexes])), ...);
+        }
+
+        ACCEL_TARGET("aes")
+        void _FusedRuns(const uint8_t* pbIn, uint8_t* pbOut, size_t RunCount, __m128i& Tweak) const ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < RunCount; ++i, pbIn += 8 * BlockSizeValue, pbOut += 8 * BlockSizeValue)
+                _FusedRun(pbIn, pbOut, Tweak, std::make_index_sequence<8>{});
+        }
+
+        ACCEL_TARGET("aes")
+        void _FlushFused(_StagingArea& Staging) const ACCEL_NOEXCEPT {
+            size_t i = 0;
+
+            for (; i + 8 <= Staging.Count; i += 8)
+                _FusedLanes(Staging, i, std::make_index_sequence<8>{});
+
+            if (i + 4 <= Staging.Count) {
+                _FusedLanes(Staging, i, std::make_index_sequence<4>{});
+                i += 4;
+            }
+
+            for (; i < Staging.Count; ++i)
+                _FusedLanes(Staging, i, std::make_index_sequence<1>{});
+
+            Staging.Count = 0;
+        }
+
+        ACCEL_FORCEINLINE
+        void _FlushGeneric(_StagingArea& Staging) ACCEL_NOEXCEPT {
+            uint8_t Blocks[_BatchBlocks * BlockSizeValue];
+
+            for (size_t i = 0; i < Staging.Count; ++i)
+                MemoryWriteAs<__m128i>(Blocks, BlockSizeValue, i, _mm_xor_si128(MemoryReadAs<__m128i>(Staging.Sources[i]), Staging.Tweaks[i]));
+
+            _CipherBlocks(Blocks, Staging.Count);
+
+            for (size_t i = 0; i < Staging.Count; ++i)
+                MemoryWriteAs<__m128i>(Staging.Targets[i], _mm_xor_si128(MemoryReadAs<__m128i>(Blocks, BlockSizeValue, i), Staging.Tweaks[i]));
+
+            SecureWipe(Blocks, sizeof(Blocks));
+            Staging.Count = 0;
+        }
+
+        ACCEL_FORCEINLINE
+        void _Flush(_StagingArea& Staging) ACCEL_NOEXCEPT {
+            if constexpr (_CanFuse) {
+                _FlushFused(Staging);
+            } else {
+                _FlushGeneric(Staging);
+            }
+        }
+
+        ACCEL_FORCEINLINE
+        void _Stage(_StagingArea& Staging, const uint8_t* pbIn, uint8_t* pbOut, __m128i Tweak) ACCEL_NOEXCEPT {
+            Staging.Sources[Staging.Count] = pbIn;
+            Staging.Targets[Staging.Count] = pbOut;
+            Staging.Tweaks[Staging.Count] = Tweak;
+            if (++Staging.Count == _BatchBlocks) {
+                _Flush(Staging);
+            }
+        }
+
+        //
+        //  pbBlock = C(pbBlock ^ Tweak) ^ Tweak, for a single block.
+        //
+        ACCEL_FORCEINLINE
+        void _CipherBlock(uint8_t* pbBlock, __m128i Tweak) ACCEL_NOEXCEPT {
+            MemoryWriteAs<__m128i>(pbBlock, _mm_xor_si128(MemoryReadAs<__m128i>(pbBlock), Tweak));
+            _CipherBlocks(pbBlock, 1);
+            MemoryWriteAs<__m128i>(pbBlock, _mm_xor_si128(MemoryReadAs<__m128i>(pbBlock), Tweak));
+        }
+
+        //
+        //  Ciphertext stealing over the last full block and the `cbTail`-byte partial block that follows it.
+        //  `Tweak` is the tweak of the last full block.
+        //
+        ACCEL_FORCEINLINE
+        void _StealCiphertext(const uint8_t* pbIn, uint8_t* pbOut, size_t cbTail, __m128i Tweak) ACCEL_NOEXCEPT {
+            __m128i NextTweak = _DoubleTweak(Tweak);
+            uint8_t Buffer[BlockSizeValue];
+            uint8_t Tail[BlockSizeValue];
+
+            //
+            //  Decryption needs the two tweaks the other way around.
+            //
+            if constexpr (__Direction == Direction::Decryption) {
+                std::swap(Tweak, NextTweak);
+            }
+
+            memcpy(Tail, pbIn + BlockSizeValue, cbTail);
+            memcpy(Buffer, pbIn, BlockSizeValue);
+            _CipherBlock(Buffer, Tweak);
+
+            memcpy(pbOut + BlockSizeValue, Buffer, cbTail);
+            memcpy(Buffer, Tail, cbTail);
+            _CipherBlock(Buffer, NextTweak);
+            memcpy(pbOut, Buffer, BlockSizeValue);
+
+            SecureWipe(Buffer, sizeof(Buffer));
+            SecureWipe(Tail, sizeof(Tail));
+        }
+
+        ACCEL_FORCEINLINE
+        void _ProcessSector(_StagingArea& Staging, const XTSSector& Sector, __m128i Tweak) ACCEL_NOEXCEPT {
+            auto pbIn = reinterpret_cast<const uint8_t*>(Sector.pbIn);
+            auto pbOut = reinterpret_cast<uint8_t*>(Sector.pbOut);
+            size_t cbTail = Sector.cbData % BlockSizeValue;
+            size_t BlockCount = Sector.cbData / BlockSizeValue;
+
+            //
+            //  With ciphertext stealing, the last full block is left to _StealCiphertext.
+            //
+            if (cbTail) {
+                --BlockCount;
+            }
+
+            size_t i = 0;
+
+            //
+            //  Long runs inside the sector go straight through the fused kernel;
+            //  only what is left is staged, to be interleaved with the blocks of other sectors.
+            //
+            if constexpr (_CanFuse) {
+                _FusedRuns(pbIn, pbOut, BlockCount / 8, Tweak);
+                i = BlockCount / 8 * 8;
+            }
+
+            for (; i < BlockCount; ++i) {
+                _Stage(Staging, pbIn + i * BlockSizeValue, pbOut + i * BlockSizeValue, Tweak);
+                Tweak = _DoubleTweak(Tweak);
+            }
+
+            if (cbTail) {
+                _StealCiphertext(pbIn + BlockCount * BlockSizeValue, pbOut + BlockCount * BlockSizeValue, cbTail, Tweak);
+            }
+        }
+
+    public:
+
+        constexpr size_t BlockSize() const ACCEL_NOEXCEPT {
+            return BlockSizeValue;
+        }
+
+        constexpr size_t KeySize() const ACCEL_NOEXCEPT {
+            return KeySizeValue;
+        }
+
+        //
+        //  `pbUserKey` is the data key followed by the tweak key.
+        //  Like FIPS 140 requires, the two halves must differ.
+        //
+        ACCEL_NODISCARD
+        bool SetKey(const void* pbUserKey, size_t cbUserKey) ACCEL_NOEXCEPT {
+            constexpr size_t cbHalf = __CipherType::KeySizeValue;
+            auto pbKey = reinterpret_cast<const uint8_t*>(pbUserKey);
+
+            if (cbUserKey != KeySizeValue) {
+                return false;
+            }
+
+            uint8_t Difference = 0;
+            for (size_t i = 0; i < cbHalf; ++i)
+                Difference |= pbKey[i] ^ pbKey[cbHalf + i];
+
+            if (Difference == 0) {
+                return false;
+            }
+
+            return _DataCipher.SetKey(pbKey, cbHalf) && _TweakCipher.SetKey(pbKey + cbHalf, cbHalf);
+        }
+
+        //
+        //  Process a batch of sectors. Every sector must be at least 16 bytes long;
+        //  if one is not, nothing is processed and false is returned.
+        //
+        ACCEL_NODISCARD
+        bool ProcessSectors(const XTSSector* pSectors, size_t SectorCount) ACCEL_NOEXCEPT {
+            for (size_t i = 0; i < SectorCount; ++i) {
+                if (pSectors[i].cbData < BlockSizeValue) {
+                    return false;
+                }
+            }
+
+            _StagingArea Staging;
+            uint8_t Tweaks[_BatchBlocks * BlockSizeValue];
+
+            Staging.Count = 0;
+
+            for (size_t i = 0; i < SectorCount; i += _BatchBlocks) {
+                size_t n = SectorCount - i < _BatchBlocks ? SectorCount - i : _BatchBlocks;
+
+                //
+                //  The initial tweak is the sector number as a 128-bit little-endian integer, encrypted with the tweak key.
+                //
+                for (size_t j = 0; j < n; ++j) {
+                    MemoryWriteAs<uint64_t>(Tweaks + j * BlockSizeValue, pSectors[i + j].Number);
+                    MemoryWriteAs<uint64_t>(Tweaks + j * BlockSizeValue + 8, 0);
+                }
+
+                Internal::EncryptBlocks(_TweakCipher, Tweaks, n);
+
+                for (size_t j = 0; j < n; ++j)
+                    _ProcessSector(Staging, pSectors[i + j], MemoryReadAs<__m128i>(Tweaks, BlockSizeValue, j));
+            }
+
+            if (Staging.Count) {
+                _Flush(Staging);
+            }
+
+            SecureWipe(&Staging, sizeof(Staging));
+            SecureWipe(Tweaks, sizeof(Tweaks));
+            return true;
+        }
+
+        ACCEL_NODISCARD
+        bool ProcessSector(uint64_t SectorNumber, const void* pbIn, size_t cbData, void* pbOut) ACCEL_NOEXCEPT {
+            XTSSector Sector = { SectorNumber, pbIn, pbOut, cbData };
+            return ProcessSectors(&Sector, 1);
+        }
+
+        void ClearKey() ACCEL_NOEXCEPT {
+            _DataCipher.ClearKey();
+            _TweakCipher.ClearKey();
+        }
+    };
+
+}
+
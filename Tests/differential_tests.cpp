@@ -0,0 +1,667 @@
+//
+//  Differential tests: every optimized path against the scalar code it replaces, on pseudo-random inputs.
+//  A new SIMD kernel is covered by one more CompareCiphers<Scalar, Kernel> line, gated on its CPU features.
+//
+#include "test_common.hpp"
+#include "../CpuFeatures.hpp"
+#include "../Intrinsic.hpp"
+#include "../CipherTraits/aes.hpp"
+#include "../CipherTraits/aes_aesni.hpp"
+#include "../CipherTraits/aes_vaes.hpp"
+#include "../CipherTraits/aes_bitsliced.hpp"
+#include "../CipherTraits/aria.hpp"
+#include "../CipherTraits/blowfish.hpp"
+#include "../CipherTraits/camellia.hpp"
+#include "../CipherTraits/cast128.hpp"
+#include "../CipherTraits/cast256.hpp"
+#include "../CipherTraits/des.hpp"
+#include "../CipherTraits/gost.hpp"
+#include "../CipherTraits/idea.hpp"
+#include "../CipherTraits/rc2.hpp"
+#include "../CipherTraits/rc5.hpp"
+#include "../CipherTraits/rc6.hpp"
+#include "../CipherTraits/rijndael.hpp"
+#include "../CipherTraits/rijndael256_aesni.hpp"
+#include "../CipherTraits/seed.hpp"
+#include "../CipherTraits/serpent.hpp"
+#include "../CipherTraits/skipjack.hpp"
+#include "../CipherTraits/sm4.hpp"
+#include "../CipherTraits/tea.hpp"
+#include "../CipherTraits/twofish.hpp"
+#include "../CipherTraits/xtea.hpp"
+#include "../CipherTraits/xxtea.hpp"
+#include "../Hash/hasher.hpp"
+#include "../Hash/haval.hpp"
+#include "../Hash/hmac.hpp"
+#include "../Hash/md2.hpp"
+#include "../Hash/md4.hpp"
+#include "../Hash/md5.hpp"
+#include "../Hash/md5_batch.hpp"
+#include "../Hash/pbkdf2.hpp"
+#include "../Hash/ripemd.hpp"
+#include "../Hash/sha1.hpp"
+#include "../Hash/sha1_batch.hpp"
+#include "../Hash/sha224.hpp"
+#include "../Hash/sha256.hpp"
+#include "../Hash/sha256_batch.hpp"
+#include "../Hash/sha384.hpp"
+#include "../Hash/sha512.hpp"
+#include "../Hash/sm3.hpp"
+#include "../Hash/tiger.hpp"
+#include "../Hash/tree_hasher.hpp"
+#include "../Hash/whirlpool.hpp"
+#include "../Modes/common.hpp"
+#include "../Modes/ctr.hpp"
+#include "../Modes/ctr_parallel.hpp"
+#include "../Modes/gcm.hpp"
+#include "../Modes/xts.hpp"
+#include <type_traits>
+
+using namespace accel;
+using accel::Test::RandomBytes;
+
+namespace {
+
+    template<typename __CipherType, typename = void>
+    struct KeySizeOf {
+        static constexpr size_t Value = __CipherType::MaxKeySizeValue;
+    };
+
+    template<typename __CipherType>
+    struct KeySizeOf<__CipherType, std::void_t<decltype(__CipherType::KeySizeValue)>> {
+        static constexpr size_t Value = __CipherType::KeySizeValue;
+    };
+
+    //
+    //  Random key bytes with odd parity, which DES_ALG insists on and the other ciphers ignore.
+    //
+    std::vector<uint8_t> RandomKey(RandomBytes& Rng, size_t cbKey) {
+        auto Key = Rng.Bytes(cbKey);
+        for (auto& Byte : Key) {
+            if (PopulationCount<uint8_t>(Byte) % 2 == 0)
+                Byte ^= 1;
+        }
+        return Key;
+    }
+
+    //
+    //  __CandidateType must encrypt exactly like __ReferenceType, one block at a time.
+    //  The candidate goes through Modes::Internal::EncryptBlocks/DecryptBlocks, i.e. through its multi-block kernel
+    //  if it has one, with every block count from 1 to 40 so that each tail length of an 8-, 16- or 32-wide kernel is hit.
+    //  CompareCiphers<C, C> checks a cipher's own multi-block path and its round trip.
+    //
+    template<typename __ReferenceType, typename __CandidateType>
+    void CompareCiphers(uint64_t Seed, size_t cbKey = KeySizeOf<__ReferenceType>::Value) {
+        static_assert(__ReferenceType::BlockSizeValue == __CandidateType::BlockSizeValue);
+        constexpr size_t BlockSize = __ReferenceType::BlockSizeValue;
+        RandomBytes Rng(Seed);
+
+        for (int Trial = 0; Trial < 4; ++Trial) {
+            auto Key = RandomKey(Rng, cbKey);
+            __ReferenceType Reference;
+            __CandidateType Candidate;
+
+            if (ACCEL_CHECK(Reference.SetKey(Key.data(), Key.size()) && Candidate.SetKey(Key.data(), Key.size())) == false)
+                return;
+
+            for (size_t BlockCount = 1; BlockCount <= 40; ++BlockCount) {
+                auto Plain = Rng.Bytes(BlockCount * BlockSize);
+                auto Expected = Plain;
+                auto Actual = Plain;
+
+                for (size_t i = 0; i < BlockCount; ++i)
+                    Reference.EncryptBlock(Expected.data() + i * BlockSize);
+
+                Modes::Internal::EncryptBlocks(Candidate, Actual.data(), BlockCount);
+                if (ACCEL_CHECK_BYTES(Actual.data(), Actual.size(), Expected.data()) == false)
+                    return;
+
+                Modes::Internal::DecryptBlocks(Candidate, Actual.data(), BlockCount);
+                if (ACCEL_CHECK_BYTES(Actual.data(), Actual.size(), Plain.data()) == false)
+                    return;
+            }
+        }
+    }
+
+    template<typename __CipherType>
+    void CheckCipher(uint64_t Seed) {
+        CompareCiphers<__CipherType, __CipherType>(Seed);
+    }
+
+    //
+    //  Hash `Message` in pieces of random length, with a round trip through ExportState/ImportState halfway,
+    //  and compare with a single Update.
+    //
+    template<typename __AlgType>
+    void CheckHasherSplits(uint64_t Seed) {
+        RandomBytes Rng(Seed);
+
+        for (size_t Length : { size_t{ 0 }, size_t{ 1 }, size_t{ 55 }, size_t{ 64 }, size_t{ 111 }, size_t{ 128 }, size_t{ 1000 }, size_t{ 4099 } }) {
+            auto Message = Rng.Bytes(Length);
+            Hash::UnkeyedHasher<__AlgType> Whole;
+            Hash::UnkeyedHasher<__AlgType> Pieces;
+            uint8_t Expected[__AlgType::DigestSizeValue];
+            uint8_t Actual[__AlgType::DigestSizeValue];
+
+            Whole.Update(Message.data(), Message.size());
+            Whole.DigestTo(Expected);
+
+            for (size_t Offset = 0; Offset < Length;) {
+                size_t cb = 1 + Rng.Below(Length - Offset < 200 ? Length - Offset : 200);
+
+                Pieces.Update(Message.data() + Offset, cb);
+                Offset += cb;
+
+                if (Offset >= Length / 2 && Offset - cb < Length / 2) {
+                    uint8_t State[Hash::UnkeyedHasher<__AlgType>::SerializedStateSizeValue];
+                    Hash::UnkeyedHasher<__AlgType> Resumed;
+
+                    Pieces.ExportState(State);
+                    ACCEL_CHECK(Resumed.ImportState(State, sizeof(State)));
+                    Pieces = Resumed;
+                }
+            }
+
+            Pieces.DigestTo(Actual);
+            ACCEL_CHECK_BYTES(Actual, sizeof(Actual), Expected);
+        }
+    }
+
+    template<typename __AlgType>
+    void HashOne(const std::vector<uint8_t>& Message, uint8_t* pbDigest) {
+        Hash::UnkeyedHasher<__AlgType> Hasher;
+        Hasher.Update(Message.data(), Message.size());
+        Hasher.DigestTo(pbDigest);
+    }
+
+    //
+    //  `Run(Messages, Count)` must give, for every message, the digest of __AlgType.
+    //  Batches of 1 to 40 messages of mixed lengths, so lanes are refilled and the single-stream tail is taken.
+    //
+    template<typename __AlgType, typename __RunType>
+    void CheckBatch(uint64_t Seed, __RunType&& Run) {
+        constexpr size_t DigestSize = __AlgType::DigestSizeValue;
+        RandomBytes Rng(Seed);
+
+        for (size_t MessageCount = 1; MessageCount <= 40; ++MessageCount) {
+            std::vector<std::vector<uint8_t>> Data(MessageCount);
+            std::vector<Hash::HashMessage> Messages(MessageCount);
+            std::vector<uint8_t> Digests(MessageCount * DigestSize);
+
+            for (size_t i = 0; i < MessageCount; ++i) {
+                Data[i] = Rng.Bytes(Rng.Below(4) == 0 ? Rng.Below(2000) : Rng.Below(130));
+                Messages[i] = Hash::HashMessage{ Data[i].data(), Data[i].size(), Digests.data() + i * DigestSize };
+            }
+
+            Run(Messages.data(), MessageCount);
+
+            for (size_t i = 0; i < MessageCount; ++i) {
+                uint8_t Expected[DigestSize];
+                HashOne<__AlgType>(Data[i], Expected);
+                if (ACCEL_CHECK_BYTES(Digests.data() + i * DigestSize, DigestSize, Expected) == false)
+                    return;
+            }
+        }
+    }
+
+    template<typename __AlgType, typename __KernelType, typename __BatchType>
+    void CheckBatchBackends(uint64_t Seed) {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+        CheckBatch<__AlgType>(Seed, [](const Hash::HashMessage* Messages, size_t Count) {
+            Hash::Internal::MultiBufferScheduler<__KernelType, Hash::Internal::LaneVectorSSE2>{}.Run(Messages, Count);
+        });
+        if (Features.AVX2) {
+            CheckBatch<__AlgType>(Seed + 1, [](const Hash::HashMessage* Messages, size_t Count) {
+                Hash::Internal::MultiBufferScheduler<__KernelType, Hash::Internal::LaneVectorAVX2>{}.Run(Messages, Count);
+            });
+        }
+        if (Features.AVX512F && Features.AVX512BW) {
+            CheckBatch<__AlgType>(Seed + 2, [](const Hash::HashMessage* Messages, size_t Count) {
+                Hash::Internal::MultiBufferScheduler<__KernelType, Hash::Internal::LaneVectorAVX512>{}.Run(Messages, Count);
+            });
+        }
+        CheckBatch<__AlgType>(Seed + 3, [](const Hash::HashMessage* Messages, size_t Count) {
+            __BatchType::HashMessages(Messages, Count);
+        });
+    }
+
+    //
+    //  PBKDF2 written out from RFC 8018 with HMAC<__AlgType>::Compute, as the reference for the lane schedulers.
+    //
+    template<typename __AlgType>
+    std::vector<uint8_t> ReferencePbkdf2(const std::vector<uint8_t>& Password, const std::vector<uint8_t>& Salt, size_t Iterations, size_t cbKey) {
+        constexpr size_t DigestSize = __AlgType::DigestSizeValue;
+        std::vector<uint8_t> Key;
+        Hash::HMAC<__AlgType> Hmac;
+
+        (void)Hmac.SetKey(Password.data(), Password.size());
+
+        for (uint32_t BlockIndex = 1; Key.size() < cbKey; ++BlockIndex) {
+            auto Input = Salt;
+            uint8_t U[DigestSize];
+            uint8_t T[DigestSize];
+
+            for (int Shift = 24; Shift >= 0; Shift -= 8)
+                Input.push_back(static_cast<uint8_t>(BlockIndex >> Shift));
+
+            Hmac.Compute(Input.data(), Input.size(), U);
+            memcpy(T, U, DigestSize);
+            for (size_t j = 1; j < Iterations; ++j) {
+                Hmac.Compute(U, DigestSize, U);
+                for (size_t i = 0; i < DigestSize; ++i)
+                    T[i] ^= U[i];
+            }
+
+            Key.insert(Key.end(), T, T + (cbKey - Key.size() < DigestSize ? cbKey - Key.size() : DigestSize));
+        }
+
+        return Key;
+    }
+
+    template<typename __AlgType, typename __RunType>
+    void CheckPbkdf2Jobs(uint64_t Seed, __RunType&& Run) {
+        RandomBytes Rng(Seed);
+
+        for (size_t JobCount : { size_t{ 1 }, size_t{ 3 }, size_t{ 17 }, size_t{ 40 } }) {
+            std::vector<std::vector<uint8_t>> Passwords(JobCount), Salts(JobCount), Keys(JobCount);
+            std::vector<Hash::PBKDF2Job> Jobs(JobCount);
+
+            for (size_t i = 0; i < JobCount; ++i) {
+                Passwords[i] = Rng.Bytes(Rng.Below(150));
+                Salts[i] = Rng.Bytes(Rng.Below(40));
+                Keys[i].resize(1 + Rng.Below(3 * __AlgType::DigestSizeValue));
+                Jobs[i] = Hash::PBKDF2Job{ Passwords[i].data(), Passwords[i].size(), Salts[i].data(), Salts[i].size(),
+                                           1 + Rng.Below(40), Keys[i].data(), Keys[i].size() };
+            }
+
+            Run(Jobs.data(), JobCount);
+
+            for (size_t i = 0; i < JobCount; ++i) {
+                auto Expected = ReferencePbkdf2<__AlgType>(Passwords[i], Salts[i], Jobs[i].Iterations, Keys[i].size());
+                if (ACCEL_CHECK_BYTES(Keys[i].data(), Keys[i].size(), Expected.data()) == false)
+                    return;
+            }
+        }
+    }
+
+    //
+    //  SHA-512 runs on the 64-bit lane policies, which have no SSE2 member, and on the portable kernel in place of SHA-NI.
+    //
+    template<typename __AlgType>
+    void CheckPbkdf2Backends(uint64_t Seed) {
+        using Kernel = typename Hash::Internal::PBKDF2LanesOf<__AlgType>::Type;
+        constexpr bool Wide = sizeof(typename Kernel::WordType) == sizeof(uint64_t);
+        using AVX2 = std::conditional_t<Wide, Hash::Internal::LaneVector64AVX2, Hash::Internal::LaneVectorAVX2>;
+        using AVX512 = std::conditional_t<Wide, Hash::Internal::LaneVector64AVX512, Hash::Internal::LaneVectorAVX512>;
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+        if constexpr (Wide == false) {
+            CheckPbkdf2Jobs<__AlgType>(Seed, [](const Hash::PBKDF2Job* Jobs, size_t Count) {
+                Hash::Internal::PBKDF2Scheduler<__AlgType, Kernel, Hash::Internal::LaneVectorSSE2>{}.Run(Jobs, Count);
+            });
+        }
+        if (Features.AVX2) {
+            CheckPbkdf2Jobs<__AlgType>(Seed + 1, [](const Hash::PBKDF2Job* Jobs, size_t Count) {
+                Hash::Internal::PBKDF2Scheduler<__AlgType, Kernel, AVX2>{}.Run(Jobs, Count);
+            });
+        }
+        if (Features.AVX512F && Features.AVX512BW) {
+            CheckPbkdf2Jobs<__AlgType>(Seed + 2, [](const Hash::PBKDF2Job* Jobs, size_t Count) {
+                Hash::Internal::PBKDF2Scheduler<__AlgType, Kernel, AVX512>{}.Run(Jobs, Count);
+            });
+        }
+        if (Wide || (Features.SHA && Features.SSE41)) {
+            CheckPbkdf2Jobs<__AlgType>(Seed + 3, [](const Hash::PBKDF2Job* Jobs, size_t Count) {
+                Hash::Internal::PBKDF2Scheduler<__AlgType, Kernel, void>{}.Run(Jobs, Count);
+            });
+        }
+        CheckPbkdf2Jobs<__AlgType>(Seed + 4, [](const Hash::PBKDF2Job* Jobs, size_t Count) {
+            ACCEL_CHECK(Hash::PBKDF2<__AlgType>::DeriveKeys(Jobs, Count));
+        });
+    }
+
+    //
+    //  GCM over __CandidateType (which may take the stitched AES-NI path) against GCM over RIJNDAEL_ALG,
+    //  fed in pieces of random length.
+    //
+    template<typename __CandidateType>
+    void CheckGcm(uint64_t Seed) {
+        using Reference = CipherTraits::RIJNDAEL_ALG<__CandidateType::KeySizeValue * 8, 128>;
+        RandomBytes Rng(Seed);
+
+        for (int Trial = 0; Trial < 16; ++Trial) {
+            auto Key = Rng.Bytes(__CandidateType::KeySizeValue);
+            auto IV = Rng.Bytes(Trial % 4 == 0 ? 1 + Rng.Below(40) : 12);
+            auto Aad = Rng.Bytes(Rng.Below(70));
+            auto Plain = Rng.Bytes(Rng.Below(2000));
+            std::vector<uint8_t> Expected(Plain.size()), Actual(Plain.size());
+            uint8_t ExpectedTag[16], ActualTag[16];
+
+            Modes::GCM<Reference, Modes::Direction::Encryption> Slow;
+            Modes::GCM<__CandidateType, Modes::Direction::Encryption> Fast;
+
+            if (ACCEL_CHECK(Slow.SetKey(Key.data(), Key.size()) && Slow.SetIV(IV.data(), IV.size())) == false)
+                return;
+            if (ACCEL_CHECK(Fast.SetKey(Key.data(), Key.size()) && Fast.SetIV(IV.data(), IV.size())) == false)
+                return;
+
+            ACCEL_CHECK(Slow.UpdateAAD(Aad.data(), Aad.size()));
+            ACCEL_CHECK(Fast.UpdateAAD(Aad.data(), Aad.size()));
+            (void)Slow.Update(Plain.data(), Plain.size(), Expected.data());
+
+            for (size_t Offset = 0; Offset < Plain.size();) {
+                size_t cb = 1 + Rng.Below(Plain.size() - Offset < 300 ? Plain.size() - Offset : 300);
+                (void)Fast.Update(Plain.data() + Offset, cb, Actual.data() + Offset);
+                Offset += cb;
+            }
+
+            ACCEL_CHECK(Slow.Final(ExpectedTag, sizeof(ExpectedTag)));
+            ACCEL_CHECK(Fast.Final(ActualTag, sizeof(ActualTag)));
+            ACCEL_CHECK_BYTES(Actual.data(), Actual.size(), Expected.data());
+            ACCEL_CHECK_BYTES(ActualTag, sizeof(ActualTag), ExpectedTag);
+
+            Modes::GCM<__CandidateType, Modes::Direction::Decryption> Opener;
+            std::vector<uint8_t> Opened(Plain.size());
+
+            ACCEL_CHECK(Opener.SetKey(Key.data(), Key.size()) && Opener.SetIV(IV.data(), IV.size()));
+            ACCEL_CHECK(Opener.UpdateAAD(Aad.data(), Aad.size()));
+            (void)Opener.Update(Actual.data(), Actual.size(), Opened.data());
+            ACCEL_CHECK(Opener.Final(static_cast<const void*>(ActualTag), sizeof(ActualTag)));
+            ACCEL_CHECK_BYTES(Opened.data(), Opened.size(), Plain.data());
+        }
+    }
+
+    //
+    //  A batch of sectors through ProcessSectors against the same sectors one by one through ProcessSector.
+    //
+    template<typename __CipherType>
+    void CheckXtsBatch(uint64_t Seed) {
+        RandomBytes Rng(Seed);
+
+        for (size_t SectorCount : { size_t{ 1 }, size_t{ 7 }, size_t{ 33 } }) {
+            std::vector<uint8_t> Key;
+            do {
+                Key = Rng.Bytes(2 * __CipherType::KeySizeValue);
+            } while (memcmp(Key.data(), Key.data() + Key.size() / 2, Key.size() / 2) == 0);
+
+            std::vector<std::vector<uint8_t>> Plain(SectorCount), Expected(SectorCount), Actual(SectorCount);
+            std::vector<Modes::XTSSector> Sectors(SectorCount);
+            uint64_t FirstNumber = Rng.Below(1u << 30);
+
+            Modes::XTS<__CipherType, Modes::Direction::Encryption> Single, Batch;
+            if (ACCEL_CHECK(Single.SetKey(Key.data(), Key.size()) && Batch.SetKey(Key.data(), Key.size())) == false)
+                return;
+
+            for (size_t i = 0; i < SectorCount; ++i) {
+                Plain[i] = Rng.Bytes(16 + Rng.Below(600));
+                Expected[i].resize(Plain[i].size());
+                Actual[i].resize(Plain[i].size());
+                Sectors[i] = Modes::XTSSector{ FirstNumber + i, Plain[i].data(), Actual[i].data(), Plain[i].size() };
+                ACCEL_CHECK(Single.ProcessSector(FirstNumber + i, Plain[i].data(), Plain[i].size(), Expected[i].data()));
+            }
+
+            ACCEL_CHECK(Batch.ProcessSectors(Sectors.data(), Sectors.size()));
+            for (size_t i = 0; i < SectorCount; ++i)
+                ACCEL_CHECK_BYTES(Actual[i].data(), Actual[i].size(), Expected[i].data());
+
+            Modes::XTS<__CipherType, Modes::Direction::Decryption> Reverse;
+            ACCEL_CHECK(Reverse.SetKey(Key.data(), Key.size()));
+            for (size_t i = 0; i < SectorCount; ++i)
+                Sectors[i] = Modes::XTSSector{ FirstNumber + i, Actual[i].data(), Actual[i].data(), Actual[i].size() };
+            ACCEL_CHECK(Reverse.ProcessSectors(Sectors.data(), Sectors.size()));
+            for (size_t i = 0; i < SectorCount; ++i)
+                ACCEL_CHECK_BYTES(Actual[i].data(), Actual[i].size(), Plain[i].data());
+        }
+    }
+
+    template<typename __AlgType, size_t __ChunkSize>
+    void CheckTree(uint64_t Seed, ThreadPool* pPool) {
+        using Tree = Hash::TreeHasher<__AlgType, __ChunkSize>;
+        constexpr size_t DigestSize = Tree::DigestSizeValue;
+        RandomBytes Rng(Seed);
+
+        for (size_t Length : { size_t{ 0 }, size_t{ 1 }, __ChunkSize, 3 * __ChunkSize + 5, 13 * __ChunkSize, 37 * __ChunkSize + 100 }) {
+            auto Data = Rng.Bytes(Length);
+            uint64_t Leaves = Tree::LeafCount(Length);
+            std::vector<uint8_t> LeafDigests(Leaves * DigestSize);
+            uint8_t Expected[DigestSize], Actual[DigestSize];
+
+            Tree::HashLeaves(Data.data(), Data.size(), LeafDigests.data());
+            Tree::RootFromLeaves(LeafDigests.data(), Length, Expected);
+
+            Tree Streaming(pPool);
+            for (size_t Offset = 0; Offset < Length;) {
+                size_t cb = 1 + Rng.Below(Length - Offset < 3 * __ChunkSize ? Length - Offset : 3 * __ChunkSize);
+                Streaming.Update(Data.data() + Offset, cb);
+                Offset += cb;
+            }
+            Streaming.DigestTo(Actual);
+            ACCEL_CHECK_BYTES(Actual, DigestSize, Expected);
+
+            for (uint64_t i = 0; i < Leaves; ++i) {
+                std::vector<uint8_t> Proof(Tree::ProofSize(i, Length));
+                size_t cbChunk = i + 1 < Leaves ? __ChunkSize : Length - i * __ChunkSize;
+
+                ACCEL_CHECK(Tree::BuildProof(LeafDigests.data(), Length, i, Proof.data()));
+                ACCEL_CHECK(Tree::VerifyChunk(Data.data() + i * __ChunkSize, cbChunk, i, Length, Proof.data(), Proof.size(), Expected));
+            }
+        }
+    }
+
+    //
+    //  The T-table rounds against the byte-wise ones, for every key and block size including the non-AES blocks.
+    //
+    template<size_t __KeyBits>
+    void CompareRijndaelPolicies(uint64_t Seed) {
+        using CipherTraits::RIJNDAEL_ALG;
+        using CipherTraits::RijndaelPolicy;
+
+        CompareCiphers<RIJNDAEL_ALG<__KeyBits, 128, RijndaelPolicy::ByteWise>, RIJNDAEL_ALG<__KeyBits, 128>>(Seed);
+        CompareCiphers<RIJNDAEL_ALG<__KeyBits, 160, RijndaelPolicy::ByteWise>, RIJNDAEL_ALG<__KeyBits, 160>>(Seed + 1);
+        CompareCiphers<RIJNDAEL_ALG<__KeyBits, 192, RijndaelPolicy::ByteWise>, RIJNDAEL_ALG<__KeyBits, 192>>(Seed + 2);
+        CompareCiphers<RIJNDAEL_ALG<__KeyBits, 224, RijndaelPolicy::ByteWise>, RIJNDAEL_ALG<__KeyBits, 224>>(Seed + 3);
+        CompareCiphers<RIJNDAEL_ALG<__KeyBits, 256, RijndaelPolicy::ByteWise>, RIJNDAEL_ALG<__KeyBits, 256>>(Seed + 4);
+    }
+
+}
+
+ACCEL_TEST(AesBackendsAgainstRijndael) {
+    const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+    CompareCiphers<CipherTraits::RIJNDAEL_ALG<128, 128>, CipherTraits::AES_ALG<128>>(1);
+    CompareCiphers<CipherTraits::RIJNDAEL_ALG<192, 128>, CipherTraits::AES_ALG<192>>(2);
+    CompareCiphers<CipherTraits::RIJNDAEL_ALG<256, 128>, CipherTraits::AES_ALG<256>>(3);
+
+    if (Features.AESNI) {
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<128, 128>, CipherTraits::AES_AESNI_ALG<128>>(4);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<192, 128>, CipherTraits::AES_AESNI_ALG<192>>(5);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<256, 128>, CipherTraits::AES_AESNI_ALG<256>>(6);
+    }
+    if (Features.SSSE3) {
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<128, 128>, CipherTraits::AES_BITSLICED_ALG<128>>(12);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<192, 128>, CipherTraits::AES_BITSLICED_ALG<192>>(13);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<256, 128>, CipherTraits::AES_BITSLICED_ALG<256>>(14);
+    }
+    if (Features.AESNI && Features.VAES && Features.AVX2) {
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<128, 128>, CipherTraits::AES_VAES_ALG<128, 256>>(7);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<256, 128>, CipherTraits::AES_VAES_ALG<256, 256>>(8);
+    }
+    if (Features.AESNI && Features.VAES && Features.AVX512F) {
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<128, 128>, CipherTraits::AES_VAES_ALG<128, 512>>(9);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<192, 128>, CipherTraits::AES_VAES_ALG<192, 512>>(10);
+        CompareCiphers<CipherTraits::RIJNDAEL_ALG<256, 128>, CipherTraits::AES_VAES_ALG<256, 512>>(11);
+    }
+}
+
+ACCEL_TEST(RijndaelTTableAgainstByteWise) {
+    CompareRijndaelPolicies<128>(160);
+    CompareRijndaelPolicies<160>(165);
+    CompareRijndaelPolicies<192>(170);
+    CompareRijndaelPolicies<224>(175);
+    CompareRijndaelPolicies<256>(180);
+}
+
+ACCEL_TEST(Rijndael256AesniAgainstRijndael) {
+    using CipherTraits::RIJNDAEL_ALG;
+    using CipherTraits::RIJNDAEL256_AESNI_ALG;
+
+    const CpuFeatureSet& Features = RuntimeCpuFeatures();
+    if (Features.AESNI == false || Features.SSSE3 == false)
+        return;
+
+    CompareCiphers<RIJNDAEL_ALG<128, 256>, RIJNDAEL256_AESNI_ALG<128>>(185);
+    CompareCiphers<RIJNDAEL_ALG<160, 256>, RIJNDAEL256_AESNI_ALG<160>>(186);
+    CompareCiphers<RIJNDAEL_ALG<192, 256>, RIJNDAEL256_AESNI_ALG<192>>(187);
+    CompareCiphers<RIJNDAEL_ALG<224, 256>, RIJNDAEL256_AESNI_ALG<224>>(188);
+    CompareCiphers<RIJNDAEL_ALG<256, 256>, RIJNDAEL256_AESNI_ALG<256>>(189);
+}
+
+ACCEL_TEST(BlockCiphersRoundTrip) {
+    CheckCipher<CipherTraits::RIJNDAEL_ALG<128, 192>>(20);
+    CheckCipher<CipherTraits::RIJNDAEL_ALG<128, 256>>(21);
+    CheckCipher<CipherTraits::RIJNDAEL_ALG<256, 256>>(22);
+    CheckCipher<CipherTraits::ARIA_ALG<128>>(23);
+    CheckCipher<CipherTraits::ARIA_ALG<256>>(24);
+    CheckCipher<CipherTraits::BLOWFISH_ALG<>>(25);
+    CheckCipher<CipherTraits::CAMELLIA_ALG<128>>(26);
+    CheckCipher<CipherTraits::CAMELLIA_ALG<192>>(195);
+    CheckCipher<CipherTraits::CAMELLIA_ALG<256>>(27);
+    CheckCipher<CipherTraits::CAST128_ALG>(28);
+    CheckCipher<CipherTraits::CAST256_ALG<256>>(29);
+    CheckCipher<CipherTraits::DES_ALG>(30);
+    CheckCipher<CipherTraits::TRIPLE_DES_ALG>(31);
+    CheckCipher<CipherTraits::GOST2814789_ALG>(32);
+    CheckCipher<CipherTraits::IDEA_ALG>(33);
+    CheckCipher<CipherTraits::RC2_ALG>(34);
+    CheckCipher<CipherTraits::RC5_ALG<32, 12, 16>>(35);
+    CheckCipher<CipherTraits::RC6_ALG<32, 20, 16>>(36);
+    CheckCipher<CipherTraits::SEED_ALG>(37);
+    CheckCipher<CipherTraits::SERPENT_ALG<128>>(193);
+    CheckCipher<CipherTraits::SERPENT_ALG<192>>(194);
+    CheckCipher<CipherTraits::SERPENT_ALG<256>>(38);
+    CheckCipher<CipherTraits::SKIPJACK_ALG>(39);
+    CheckCipher<CipherTraits::SM4_ALG>(40);
+    CheckCipher<CipherTraits::TEA_ALG>(41);
+    CheckCipher<CipherTraits::TWOFISH_ALG<128>>(42);
+    CheckCipher<CipherTraits::TWOFISH_ALG<256>>(43);
+    CompareCiphers<CipherTraits::TWOFISH_ALG<128, CipherTraits::TwofishKeying::Zero>, CipherTraits::TWOFISH_ALG<128>>(190);
+    CompareCiphers<CipherTraits::TWOFISH_ALG<192, CipherTraits::TwofishKeying::Zero>, CipherTraits::TWOFISH_ALG<192>>(191);
+    CompareCiphers<CipherTraits::TWOFISH_ALG<256, CipherTraits::TwofishKeying::Zero>, CipherTraits::TWOFISH_ALG<256>>(192);
+    CheckCipher<CipherTraits::XTEA_ALG>(44);
+    CheckCipher<CipherTraits::XXTEA_ALG<4>>(45);
+}
+
+ACCEL_TEST(HasherSplitsAndStateExport) {
+    CheckHasherSplits<Hash::MD2_ALG>(50);
+    CheckHasherSplits<Hash::MD4_ALG>(51);
+    CheckHasherSplits<Hash::MD5_ALG>(52);
+    CheckHasherSplits<Hash::SHA1_ALG>(53);
+    CheckHasherSplits<Hash::SHA224_ALG>(54);
+    CheckHasherSplits<Hash::SHA256_ALG>(55);
+    CheckHasherSplits<Hash::SHA384_ALG>(56);
+    CheckHasherSplits<Hash::SHA512_ALG>(57);
+    CheckHasherSplits<Hash::SM3_ALG>(58);
+    CheckHasherSplits<Hash::RIPEMD_ALG<160>>(59);
+    CheckHasherSplits<Hash::RIPEMD_ALG<320>>(60);
+    CheckHasherSplits<Hash::TIGER_ALG<2, 192>>(61);
+    CheckHasherSplits<Hash::HAVAL_ALG<256, 5>>(62);
+    CheckHasherSplits<Hash::WHIRLPOOL_ALG>(63);
+}
+
+ACCEL_TEST(MultiBufferAgainstSingleStream) {
+    CheckBatchBackends<Hash::MD5_ALG, Hash::Internal::MD5_LANES, Hash::MD5_BATCH>(70);
+    CheckBatchBackends<Hash::SHA1_ALG, Hash::Internal::SHA1_LANES, Hash::SHA1_BATCH>(80);
+    CheckBatchBackends<Hash::SHA256_ALG, Hash::Internal::SHA256_LANES, Hash::SHA256_BATCH>(90);
+}
+
+ACCEL_TEST(HmacStreamingAgainstCompute) {
+    RandomBytes Rng(100);
+
+    for (int Trial = 0; Trial < 32; ++Trial) {
+        auto Key = Rng.Bytes(Rng.Below(200));
+        auto Message = Rng.Bytes(Rng.Below(1000));
+        Hash::HMAC<Hash::SHA256_ALG> Mac;
+        uint8_t Expected[Hash::SHA256_ALG::DigestSizeValue], Actual[Hash::SHA256_ALG::DigestSizeValue];
+
+        if (ACCEL_CHECK(Mac.SetKey(Key.data(), Key.size())) == false)
+            return;
+
+        Mac.Compute(Message.data(), Message.size(), Expected);
+        for (size_t Offset = 0; Offset < Message.size();) {
+            size_t cb = 1 + Rng.Below(Message.size() - Offset < 100 ? Message.size() - Offset : 100);
+            Mac.Update(Message.data() + Offset, cb);
+            Offset += cb;
+        }
+        Mac.Final(Actual);
+        ACCEL_CHECK_BYTES(Actual, sizeof(Actual), Expected);
+    }
+}
+
+ACCEL_TEST(Pbkdf2LanesAgainstHmac) {
+    CheckPbkdf2Backends<Hash::SHA1_ALG>(110);
+    CheckPbkdf2Backends<Hash::SHA256_ALG>(120);
+    CheckPbkdf2Backends<Hash::SHA512_ALG>(125);
+}
+
+ACCEL_TEST(CtrParallelAgainstCtr) {
+    RandomBytes Rng(130);
+    auto Key = Rng.Bytes(16);
+    auto IV = Rng.Bytes(16);
+    auto Plain = Rng.Bytes(3 * 1024 * 1024 + 77);
+    std::vector<uint8_t> Expected(Plain.size()), Actual(Plain.size());
+
+    IV[15] = 0xf0;      // the counter wraps into the upper bytes in the middle of the message
+
+    Modes::CTR<CipherTraits::AES_ALG<128>, Modes::Direction::Encryption> Serial;
+    Modes::CTR_PARALLEL<CipherTraits::AES_ALG<128>, Modes::Direction::Encryption> Parallel(4);
+
+    ACCEL_CHECK(Serial.SetKey(Key.data(), Key.size()) && Serial.SetIV(IV.data(), IV.size()));
+    ACCEL_CHECK(Parallel.SetKey(Key.data(), Key.size()) && Parallel.SetIV(IV.data(), IV.size()));
+
+    (void)Serial.Update(Plain.data(), Plain.size(), Expected.data());
+    size_t Offset = 0;
+    for (size_t cb : { size_t{ 5 }, size_t{ 2 * 1024 * 1024 }, Plain.size() - 5 - 2 * 1024 * 1024 }) {
+        (void)Parallel.Update(Plain.data() + Offset, cb, Actual.data() + Offset);
+        Offset += cb;
+    }
+
+    ACCEL_CHECK(Serial.Final() && Parallel.Final());
+    ACCEL_CHECK_BYTES(Actual.data(), Actual.size(), Expected.data());
+}
+
+ACCEL_TEST(GcmBackendsAgainstRijndael) {
+    CheckGcm<CipherTraits::AES_ALG<128>>(140);
+    CheckGcm<CipherTraits::AES_ALG<256>>(141);
+    if (RuntimeCpuFeatures().SSSE3)
+        CheckGcm<CipherTraits::AES_BITSLICED_ALG<128>>(145);
+    if (RuntimeCpuFeatures().AESNI) {
+        CheckGcm<CipherTraits::AES_AESNI_ALG<128>>(142);
+        CheckGcm<CipherTraits::AES_AESNI_ALG<192>>(143);
+        CheckGcm<CipherTraits::AES_AESNI_ALG<256>>(144);
+    }
+}
+
+ACCEL_TEST(XtsBatchAgainstSingleSector) {
+    CheckXtsBatch<CipherTraits::RIJNDAEL_ALG<128, 128>>(150);
+    CheckXtsBatch<CipherTraits::AES_ALG<256>>(151);
+    if (RuntimeCpuFeatures().SSSE3)
+        CheckXtsBatch<CipherTraits::AES_BITSLICED_ALG<128>>(154);
+    if (RuntimeCpuFeatures().AESNI) {
+        CheckXtsBatch<CipherTraits::AES_AESNI_ALG<128>>(152);
+        CheckXtsBatch<CipherTraits::AES_AESNI_ALG<256>>(153);
+    }
+}
+
+ACCEL_TEST(TreeHasherStreamingAndProofs) {
+    ThreadPool Pool(3);
+
+    CheckTree<Hash::SHA256_ALG, 1024>(160, nullptr);
+    CheckTree<Hash::SHA256_ALG, 1024>(161, &Pool);
+    CheckTree<Hash::MD5_ALG, 64>(162, &Pool);
+    CheckTree<Hash::SHA512_ALG, 256>(163, &Pool);
+}
+
+int main(int argc, char* argv[]) {
+    return accel::Test::RunAll(argc, argv);
+}
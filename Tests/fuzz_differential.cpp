@@ -0,0 +1,324 @@
+//
+//  libFuzzer target: the optimized paths against their scalar references on fuzzer-chosen inputs.
+//  The first input byte picks the comparison, the rest is split into key and data. Any mismatch aborts.
+//
+//  Built with clang and -fsanitize=fuzzer when ACCEL_BUILD_FUZZERS is on. Otherwise it is linked with
+//  fuzz_replay_main.cpp, which replays corpus files given on the command line or runs pseudo-random inputs.
+//
+#include "../CpuFeatures.hpp"
+#include "../CipherTraits/aes.hpp"
+#include "../CipherTraits/aes_aesni.hpp"
+#include "../CipherTraits/aes_vaes.hpp"
+#include "../CipherTraits/aes_bitsliced.hpp"
+#include "../CipherTraits/camellia.hpp"
+#include "../CipherTraits/rijndael.hpp"
+#include "../CipherTraits/rijndael256_aesni.hpp"
+#include "../CipherTraits/serpent.hpp"
+#include "../Hash/hasher.hpp"
+#include "../Hash/md5_batch.hpp"
+#include "../Hash/sha1_batch.hpp"
+#include "../Hash/sha256_batch.hpp"
+#include "../Modes/common.hpp"
+#include "../Modes/gcm.hpp"
+#include "../Modes/xts.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace accel;
+
+namespace {
+
+    void Expect(bool Condition) {
+        if (Condition == false)
+            abort();
+    }
+
+    //
+    //  Consumes the input from the front. Reads past the end give zeros.
+    //
+    class InputReader {
+    private:
+        const uint8_t* _pbData;
+        size_t _cbLeft;
+    public:
+        InputReader(const uint8_t* pbData, size_t cbData) : _pbData(pbData), _cbLeft(cbData) {}
+
+        uint8_t Byte() {
+            if (_cbLeft == 0)
+                return 0;
+            --_cbLeft;
+            return *_pbData++;
+        }
+
+        std::vector<uint8_t> Bytes(size_t cb) {
+            size_t cbTaken = cb < _cbLeft ? cb : _cbLeft;
+            std::vector<uint8_t> Result(_pbData, _pbData + cbTaken);
+
+            Result.resize(cb, 0);
+            _pbData += cbTaken;
+            _cbLeft -= cbTaken;
+            return Result;
+        }
+
+        std::vector<uint8_t> Rest() {
+            std::vector<uint8_t> Result(_pbData, _pbData + _cbLeft);
+            _pbData += _cbLeft;
+            _cbLeft = 0;
+            return Result;
+        }
+    };
+
+    template<typename __CandidateType>
+    void CompareWithRijndael(InputReader& Input) {
+        CipherTraits::RIJNDAEL_ALG<__CandidateType::KeySizeValue * 8, 128> Reference;
+        __CandidateType Candidate;
+        auto Key = Input.Bytes(__CandidateType::KeySizeValue);
+        auto Data = Input.Rest();
+
+        Data.resize(Data.size() / 16 * 16);
+        if (Data.empty())
+            return;
+
+        Expect(Reference.SetKey(Key.data(), Key.size()) && Candidate.SetKey(Key.data(), Key.size()));
+
+        auto Expected = Data;
+        for (size_t i = 0; i < Expected.size(); i += 16)
+            Reference.EncryptBlock(Expected.data() + i);
+
+        auto Actual = Data;
+        Modes::Internal::EncryptBlocks(Candidate, Actual.data(), Actual.size() / 16);
+        Expect(Actual == Expected);
+
+        Modes::Internal::DecryptBlocks(Candidate, Actual.data(), Actual.size() / 16);
+        Expect(Actual == Data);
+    }
+
+    void CompareAes(InputReader& Input) {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+        switch (Input.Byte() % 8) {
+            case 0: CompareWithRijndael<CipherTraits::AES_ALG<128>>(Input); break;
+            case 1: CompareWithRijndael<CipherTraits::AES_ALG<256>>(Input); break;
+            case 2: if (Features.AESNI) CompareWithRijndael<CipherTraits::AES_AESNI_ALG<128>>(Input); break;
+            case 3: if (Features.AESNI) CompareWithRijndael<CipherTraits::AES_AESNI_ALG<256>>(Input); break;
+            case 4: if (Features.AESNI && Features.VAES && Features.AVX2) CompareWithRijndael<CipherTraits::AES_VAES_ALG<128, 256>>(Input); break;
+            case 5: if (Features.AESNI && Features.VAES && Features.AVX512F) CompareWithRijndael<CipherTraits::AES_VAES_ALG<128, 512>>(Input); break;
+            case 6: if (Features.SSSE3) CompareWithRijndael<CipherTraits::AES_BITSLICED_ALG<128>>(Input); break;
+            case 7: if (Features.SSSE3) CompareWithRijndael<CipherTraits::AES_BITSLICED_ALG<256>>(Input); break;
+        }
+    }
+
+    //
+    //  RIJNDAEL256_AESNI_ALG against RIJNDAEL_ALG with the same 256-bit block.
+    //
+    template<size_t __KeyBits>
+    void CompareRijndael256(InputReader& Input) {
+        CipherTraits::RIJNDAEL_ALG<__KeyBits, 256> Reference;
+        CipherTraits::RIJNDAEL256_AESNI_ALG<__KeyBits> Candidate;
+        auto Key = Input.Bytes(__KeyBits / 8);
+        auto Data = Input.Rest();
+
+        Data.resize(Data.size() / 32 * 32);
+        if (Data.empty())
+            return;
+
+        Expect(Reference.SetKey(Key.data(), Key.size()) && Candidate.SetKey(Key.data(), Key.size()));
+
+        auto Expected = Data;
+        for (size_t i = 0; i < Expected.size(); i += 32)
+            Reference.EncryptBlock(Expected.data() + i);
+
+        auto Actual = Data;
+        Candidate.EncryptBlocks(Actual.data(), Actual.size() / 32);
+        Expect(Actual == Expected);
+
+        Candidate.DecryptBlocks(Actual.data(), Actual.size() / 32);
+        Expect(Actual == Data);
+    }
+
+    void CompareRijndael(InputReader& Input) {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+
+        if (Features.AESNI == false || Features.SSSE3 == false)
+            return;
+
+        switch (Input.Byte() % 5) {
+            case 0: CompareRijndael256<128>(Input); break;
+            case 1: CompareRijndael256<160>(Input); break;
+            case 2: CompareRijndael256<192>(Input); break;
+            case 3: CompareRijndael256<224>(Input); break;
+            case 4: CompareRijndael256<256>(Input); break;
+        }
+    }
+
+    //
+    //  A cipher's sliced EncryptBlocks/DecryptBlocks against its own EncryptBlock.
+    //
+    template<typename __CipherType>
+    void CompareWithSingleBlocks(InputReader& Input) {
+        constexpr size_t BlockSize = __CipherType::BlockSizeValue;
+        __CipherType Cipher;
+        auto Key = Input.Bytes(__CipherType::KeySizeValue);
+        auto Data = Input.Rest();
+
+        Data.resize(Data.size() / BlockSize * BlockSize);
+        if (Data.empty())
+            return;
+
+        Expect(Cipher.SetKey(Key.data(), Key.size()));
+
+        auto Expected = Data;
+        for (size_t i = 0; i < Expected.size(); i += BlockSize)
+            Cipher.EncryptBlock(Expected.data() + i);
+
+        auto Actual = Data;
+        Cipher.EncryptBlocks(Actual.data(), Actual.size() / BlockSize);
+        Expect(Actual == Expected);
+
+        Cipher.DecryptBlocks(Actual.data(), Actual.size() / BlockSize);
+        Expect(Actual == Data);
+    }
+
+    void CompareSliced(InputReader& Input) {
+        switch (Input.Byte() % 16) {
+            case 0: CompareWithSingleBlocks<CipherTraits::SERPENT_ALG<128>>(Input); break;
+            case 1: CompareWithSingleBlocks<CipherTraits::SERPENT_ALG<192>>(Input); break;
+            case 2: CompareWithSingleBlocks<CipherTraits::SERPENT_ALG<256>>(Input); break;
+            case 3: CompareWithSingleBlocks<CipherTraits::CAMELLIA_ALG<128>>(Input); break;
+            case 4: CompareWithSingleBlocks<CipherTraits::CAMELLIA_ALG<192>>(Input); break;
+            case 5: CompareWithSingleBlocks<CipherTraits::CAMELLIA_ALG<256>>(Input); break;
+            default: break;
+        }
+    }
+
+    //
+    //  Messages are cut from the input at fuzzer-chosen lengths; each digest must equal the single-stream one.
+    //
+    template<typename __BatchType, typename __AlgType>
+    void CompareBatch(InputReader& Input) {
+        constexpr size_t DigestSize = __AlgType::DigestSizeValue;
+        size_t MessageCount = 1 + Input.Byte() % 40;
+        std::vector<std::vector<uint8_t>> Data(MessageCount);
+        std::vector<Hash::HashMessage> Messages(MessageCount);
+        std::vector<uint8_t> Digests(MessageCount * DigestSize);
+
+        for (size_t i = 0; i < MessageCount; ++i) {
+            size_t cb = Input.Byte();
+            cb = cb * 8 + Input.Byte() % 8;
+            Data[i] = Input.Bytes(cb);
+            Messages[i] = Hash::HashMessage{ Data[i].data(), Data[i].size(), Digests.data() + i * DigestSize };
+        }
+
+        __BatchType::HashMessages(Messages.data(), MessageCount);
+
+        for (size_t i = 0; i < MessageCount; ++i) {
+            Hash::UnkeyedHasher<__AlgType> Hasher;
+            uint8_t Expected[DigestSize];
+
+            Hasher.Update(Data[i].data(), Data[i].size());
+            Hasher.DigestTo(Expected);
+            Expect(memcmp(Digests.data() + i * DigestSize, Expected, DigestSize) == 0);
+        }
+    }
+
+    //
+    //  GCM with the stitched AES-NI kernel against GCM over RIJNDAEL_ALG, then the AES-NI decryptor on the result.
+    //
+    void CompareGcm(InputReader& Input) {
+        using Reference = CipherTraits::RIJNDAEL_ALG<128, 128>;
+        using Candidate = CipherTraits::AES_AESNI_ALG<128>;
+
+        if (RuntimeCpuFeatures().AESNI == false)
+            return;
+
+        auto Key = Input.Bytes(16);
+        auto IV = Input.Bytes(1 + Input.Byte() % 32);
+        auto Aad = Input.Bytes(Input.Byte());
+        size_t Split = Input.Byte() * 4;
+        auto Plain = Input.Rest();
+        std::vector<uint8_t> Expected(Plain.size()), Actual(Plain.size());
+        uint8_t ExpectedTag[16], ActualTag[16];
+
+        if (Split > Plain.size())
+            Split = Plain.size();
+
+        Modes::GCM<Reference, Modes::Direction::Encryption> Slow;
+        Modes::GCM<Candidate, Modes::Direction::Encryption> Fast;
+
+        Expect(Slow.SetKey(Key.data(), Key.size()) && Slow.SetIV(IV.data(), IV.size()) && Slow.UpdateAAD(Aad.data(), Aad.size()));
+        Expect(Fast.SetKey(Key.data(), Key.size()) && Fast.SetIV(IV.data(), IV.size()) && Fast.UpdateAAD(Aad.data(), Aad.size()));
+
+        (void)Slow.Update(Plain.data(), Plain.size(), Expected.data());
+        (void)Fast.Update(Plain.data(), Split, Actual.data());
+        (void)Fast.Update(Plain.data() + Split, Plain.size() - Split, Actual.data() + Split);
+        Expect(Slow.Final(ExpectedTag, sizeof(ExpectedTag)) && Fast.Final(ActualTag, sizeof(ActualTag)));
+        Expect(Actual == Expected && memcmp(ActualTag, ExpectedTag, sizeof(ActualTag)) == 0);
+
+        Modes::GCM<Candidate, Modes::Direction::Decryption> Opener;
+        std::vector<uint8_t> Opened(Plain.size());
+
+        Expect(Opener.SetKey(Key.data(), Key.size()) && Opener.SetIV(IV.data(), IV.size()) && Opener.UpdateAAD(Aad.data(), Aad.size()));
+        (void)Opener.Update(Actual.data(), Actual.size(), Opened.data());
+        Expect(Opener.Final(static_cast<const void*>(ActualTag), sizeof(ActualTag)));
+        Expect(Opened == Plain);
+    }
+
+    //
+    //  XTS sectors of fuzzer-chosen lengths, as one batch and one by one.
+    //
+    void CompareXts(InputReader& Input) {
+        using Cipher = CipherTraits::AES_ALG<128>;
+
+        auto Key = Input.Bytes(32);
+        size_t SectorCount = 1 + Input.Byte() % 16;
+        uint64_t FirstNumber = Input.Byte();
+        std::vector<std::vector<uint8_t>> Plain(SectorCount), Expected(SectorCount), Actual(SectorCount);
+        std::vector<Modes::XTSSector> Sectors(SectorCount);
+
+        Modes::XTS<Cipher, Modes::Direction::Encryption> Single, Batch;
+        if (Single.SetKey(Key.data(), Key.size()) == false) {
+            Expect(memcmp(Key.data(), Key.data() + 16, 16) == 0);
+            return;
+        }
+        Expect(Batch.SetKey(Key.data(), Key.size()));
+
+        for (size_t i = 0; i < SectorCount; ++i) {
+            Plain[i] = Input.Bytes(16 + Input.Byte() * 2);
+            Expected[i].resize(Plain[i].size());
+            Actual[i].resize(Plain[i].size());
+            Sectors[i] = Modes::XTSSector{ FirstNumber + i, Plain[i].data(), Actual[i].data(), Plain[i].size() };
+            Expect(Single.ProcessSector(FirstNumber + i, Plain[i].data(), Plain[i].size(), Expected[i].data()));
+        }
+
+        Expect(Batch.ProcessSectors(Sectors.data(), Sectors.size()));
+        for (size_t i = 0; i < SectorCount; ++i)
+            Expect(Actual[i] == Expected[i]);
+    }
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* pbData, size_t cbData) {
+    InputReader Input(pbData, cbData);
+
+    //
+    //  Selector values keep their meaning so that saved corpus inputs keep testing what they were saved for:
+    //  a new comparison takes the next free value, and free values do nothing. The same holds for the
+    //  selectors inside CompareSliced.
+    //
+    switch (Input.Byte() % 16) {
+        case 0: CompareAes(Input); break;
+        case 1: CompareBatch<Hash::MD5_BATCH, Hash::MD5_ALG>(Input); break;
+        case 2: CompareBatch<Hash::SHA1_BATCH, Hash::SHA1_ALG>(Input); break;
+        case 3: CompareBatch<Hash::SHA256_BATCH, Hash::SHA256_ALG>(Input); break;
+        case 4: CompareGcm(Input); break;
+        case 5: CompareXts(Input); break;
+        case 6: CompareRijndael(Input); break;
+        case 7: CompareSliced(Input); break;
+        default: break;
+    }
+
+    return 0;
+}
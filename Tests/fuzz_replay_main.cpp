@@ -0,0 +1,62 @@
+//
+//  Driver for the fuzz targets where libFuzzer is not available.
+//
+//      accel-fuzz-replay FILE...       run the target once on every file, e.g. a corpus or a crash reproducer
+//      accel-fuzz-replay               run the target on pseudo-random inputs with a fixed seed
+//
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* pbData, size_t cbData);
+
+static bool ReplayFile(const char* Path) {
+    FILE* File = fopen(Path, "rb");
+    if (File == nullptr) {
+        perror(Path);
+        return false;
+    }
+
+    std::vector<uint8_t> Data;
+    uint8_t Buffer[4096];
+    size_t cb;
+    while ((cb = fread(Buffer, 1, sizeof(Buffer), File)) != 0)
+        Data.insert(Data.end(), Buffer, Buffer + cb);
+
+    bool Ok = ferror(File) == 0;
+    fclose(File);
+
+    if (Ok == false) {
+        perror(Path);
+        return false;
+    }
+
+    LLVMFuzzerTestOneInput(Data.data(), Data.size());
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        int Status = 0;
+        for (int i = 1; i < argc; ++i) {
+            if (ReplayFile(argv[i]) == false)
+                Status = 1;
+        }
+        return Status;
+    }
+
+    std::mt19937_64 Engine(0x61636365ull);
+    std::vector<uint8_t> Data;
+
+    for (int Run = 0; Run < 20000; ++Run) {
+        Data.resize(Engine() % 2048);
+        for (auto& b : Data)
+            b = static_cast<uint8_t>(Engine());
+        LLVMFuzzerTestOneInput(Data.data(), Data.size());
+    }
+
+    printf("20000 input(s) ok\n");
+    return 0;
+}
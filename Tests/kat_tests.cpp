@@ -0,0 +1,723 @@
+//
+//  Known-answer tests: the published test vectors of every algorithm that has them.
+//
+#include "test_common.hpp"
+#include "../CipherTraits/aes.hpp"
+#include "../CipherTraits/aes_aesni.hpp"
+#include "../CipherTraits/aes_vaes.hpp"
+#include "../CipherTraits/aes_bitsliced.hpp"
+#include "../CipherTraits/aria.hpp"
+#include "../CipherTraits/blowfish.hpp"
+#include "../CipherTraits/camellia.hpp"
+#include "../CipherTraits/cast128.hpp"
+#include "../CipherTraits/cast256.hpp"
+#include "../CipherTraits/des.hpp"
+#include "../CipherTraits/gost.hpp"
+#include "../CipherTraits/idea.hpp"
+#include "../CipherTraits/rc2.hpp"
+#include "../CipherTraits/rc4.hpp"
+#include "../CipherTraits/rc5.hpp"
+#include "../CipherTraits/rc6.hpp"
+#include "../CipherTraits/rijndael.hpp"
+#include "../CipherTraits/seed.hpp"
+#include "../CipherTraits/serpent.hpp"
+#include "../CipherTraits/skipjack.hpp"
+#include "../CipherTraits/sm4.hpp"
+#include "../CipherTraits/tea.hpp"
+#include "../CipherTraits/threefish.hpp"
+#include "../CipherTraits/twofish.hpp"
+#include "../CipherTraits/xtea.hpp"
+#include "../CipherTraits/xxtea.hpp"
+#include "../Hash/hasher.hpp"
+#include "../Hash/haval.hpp"
+#include "../Hash/hmac.hpp"
+#include "../Hash/md2.hpp"
+#include "../Hash/md4.hpp"
+#include "../Hash/md5.hpp"
+#include "../Hash/pbkdf2.hpp"
+#include "../Hash/ripemd.hpp"
+#include "../Hash/sha1.hpp"
+#include "../Hash/sha224.hpp"
+#include "../Hash/sha256.hpp"
+#include "../Hash/sha384.hpp"
+#include "../Hash/sha512.hpp"
+#include "../Hash/sm3.hpp"
+#include "../Hash/tiger.hpp"
+#include "../Hash/whirlpool.hpp"
+#include "../Modes/gcm.hpp"
+#include "../Modes/xts.hpp"
+
+using namespace accel;
+using accel::Test::FromHex;
+using accel::Test::FromString;
+
+namespace {
+
+    //
+    //  Encrypt `PlainHex` and compare with `CipherHex`, then decrypt it back.
+    //  `cbKeyArgument` overrides the key size passed to SetKey (RC2 packs its effective key bits there).
+    //
+    template<typename __CipherType>
+    void CheckBlockCipher(const char* KeyHex, const char* PlainHex, const char* CipherHex, size_t cbKeyArgument = 0) {
+        auto Key = FromHex(KeyHex);
+        auto Plain = FromHex(PlainHex);
+        auto Expected = FromHex(CipherHex);
+        __CipherType Cipher;
+
+        if (ACCEL_CHECK(Plain.size() == __CipherType::BlockSizeValue && Expected.size() == __CipherType::BlockSizeValue) == false)
+            return;
+        if (ACCEL_CHECK(Cipher.SetKey(Key.data(), cbKeyArgument ? cbKeyArgument : Key.size())) == false)
+            return;
+
+        auto Block = Plain;
+        Cipher.EncryptBlock(Block.data());
+        ACCEL_CHECK_BYTES(Block.data(), Block.size(), Expected.data());
+        Cipher.DecryptBlock(Block.data());
+        ACCEL_CHECK_BYTES(Block.data(), Block.size(), Plain.data());
+    }
+
+    template<size_t __KeyBits>
+    void CheckThreefish(const char* KeyHex, uint64_t Tweak1, uint64_t Tweak2, const char* PlainHex, const char* CipherHex) {
+        auto Key = FromHex(KeyHex);
+        auto Plain = FromHex(PlainHex);
+        auto Expected = FromHex(CipherHex);
+        CipherTraits::THREEFISH_ALG<__KeyBits> Cipher;
+
+        if (ACCEL_CHECK(Cipher.SetKey(Key.data(), Key.size(), Tweak1, Tweak2)) == false)
+            return;
+
+        auto Block = Plain;
+        Cipher.EncryptBlock(Block.data());
+        ACCEL_CHECK_BYTES(Block.data(), Block.size(), Expected.data());
+        Cipher.DecryptBlock(Block.data());
+        ACCEL_CHECK_BYTES(Block.data(), Block.size(), Plain.data());
+    }
+
+    template<typename __AlgType>
+    void CheckHash(const std::vector<uint8_t>& Message, const char* DigestHex) {
+        auto Expected = FromHex(DigestHex);
+        Hash::UnkeyedHasher<__AlgType> Hasher;
+        uint8_t Digest[__AlgType::DigestSizeValue];
+
+        if (ACCEL_CHECK(Expected.size() == __AlgType::DigestSizeValue) == false)
+            return;
+
+        Hasher.Update(Message.data(), Message.size());
+        Hasher.DigestTo(Digest);
+        ACCEL_CHECK_BYTES(Digest, sizeof(Digest), Expected.data());
+    }
+
+    template<typename __AlgType>
+    void CheckHash(const char* Message, const char* DigestHex) {
+        CheckHash<__AlgType>(FromString(Message), DigestHex);
+    }
+
+    template<typename __AlgType>
+    void CheckHashOfRepeated(char Byte, size_t Count, const char* DigestHex) {
+        CheckHash<__AlgType>(std::vector<uint8_t>(Count, static_cast<uint8_t>(Byte)), DigestHex);
+    }
+
+    template<typename __AlgType>
+    void CheckHmac(const std::vector<uint8_t>& Key, const std::vector<uint8_t>& Message, const char* MacHex) {
+        auto Expected = FromHex(MacHex);
+        Hash::HMAC<__AlgType> Mac;
+        uint8_t Tag[__AlgType::DigestSizeValue];
+
+        if (ACCEL_CHECK(Mac.SetKey(Key.data(), Key.size())) == false)
+            return;
+
+        Mac.Compute(Message.data(), Message.size(), Tag);
+        ACCEL_CHECK_BYTES(Tag, Expected.size(), Expected.data());
+        ACCEL_CHECK(Mac.Verify(Message.data(), Message.size(), Expected.data(), Expected.size()));
+    }
+
+    template<typename __AlgType>
+    void CheckPbkdf2(const char* Password, const std::vector<uint8_t>& Salt, uint32_t Iterations, const char* KeyHex) {
+        auto Expected = FromHex(KeyHex);
+        std::vector<uint8_t> Key(Expected.size());
+
+        ACCEL_CHECK(Hash::PBKDF2<__AlgType>::DeriveKey(Password, strlen(Password), Salt.data(), Salt.size(), Iterations, Key.data(), Key.size()));
+        ACCEL_CHECK_BYTES(Key.data(), Key.size(), Expected.data());
+    }
+
+}
+
+//
+//  FIPS 197, appendix C.
+//
+ACCEL_TEST(AesFips197) {
+    const char* Plain = "00112233445566778899aabbccddeeff";
+    const char* Key128 = "000102030405060708090a0b0c0d0e0f";
+    const char* Key192 = "000102030405060708090a0b0c0d0e0f1011121314151617";
+    const char* Key256 = "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f";
+    const char* Cipher128 = "69c4e0d86a7b0430d8cdb78070b4c55a";
+    const char* Cipher192 = "dda97ca4864cdfe06eaf70a0ec0d7191";
+    const char* Cipher256 = "8ea2b7ca516745bfeafc49904b496089";
+
+    CheckBlockCipher<CipherTraits::RIJNDAEL_ALG<128, 128>>(Key128, Plain, Cipher128);
+    CheckBlockCipher<CipherTraits::RIJNDAEL_ALG<192, 128>>(Key192, Plain, Cipher192);
+    CheckBlockCipher<CipherTraits::RIJNDAEL_ALG<256, 128>>(Key256, Plain, Cipher256);
+    CheckBlockCipher<CipherTraits::RIJNDAEL_ALG<128, 128, CipherTraits::RijndaelPolicy::ByteWise>>(Key128, Plain, Cipher128);
+    CheckBlockCipher<CipherTraits::RIJNDAEL_ALG<192, 128, CipherTraits::RijndaelPolicy::ByteWise>>(Key192, Plain, Cipher192);
+    CheckBlockCipher<CipherTraits::RIJNDAEL_ALG<256, 128, CipherTraits::RijndaelPolicy::ByteWise>>(Key256, Plain, Cipher256);
+    CheckBlockCipher<CipherTraits::AES_ALG<128>>(Key128, Plain, Cipher128);
+    CheckBlockCipher<CipherTraits::AES_ALG<192>>(Key192, Plain, Cipher192);
+    CheckBlockCipher<CipherTraits::AES_ALG<256>>(Key256, Plain, Cipher256);
+
+    const CpuFeatureSet& Features = RuntimeCpuFeatures();
+    if (Features.AESNI) {
+        CheckBlockCipher<CipherTraits::AES_AESNI_ALG<128>>(Key128, Plain, Cipher128);
+        CheckBlockCipher<CipherTraits::AES_AESNI_ALG<192>>(Key192, Plain, Cipher192);
+        CheckBlockCipher<CipherTraits::AES_AESNI_ALG<256>>(Key256, Plain, Cipher256);
+    }
+    if (Features.SSSE3) {
+        CheckBlockCipher<CipherTraits::AES_BITSLICED_ALG<128>>(Key128, Plain, Cipher128);
+        CheckBlockCipher<CipherTraits::AES_BITSLICED_ALG<192>>(Key192, Plain, Cipher192);
+        CheckBlockCipher<CipherTraits::AES_BITSLICED_ALG<256>>(Key256, Plain, Cipher256);
+    }
+    if (Features.AESNI && Features.VAES && Features.AVX2) {
+        CheckBlockCipher<CipherTraits::AES_VAES_ALG<128, 256>>(Key128, Plain, Cipher128);
+        CheckBlockCipher<CipherTraits::AES_VAES_ALG<256, 256>>(Key256, Plain, Cipher256);
+    }
+    if (Features.AESNI && Features.VAES && Features.AVX512F) {
+        CheckBlockCipher<CipherTraits::AES_VAES_ALG<128, 512>>(Key128, Plain, Cipher128);
+        CheckBlockCipher<CipherTraits::AES_VAES_ALG<256, 512>>(Key256, Plain, Cipher256);
+    }
+}
+
+//
+//  RFC 5794, appendix A.
+//
+ACCEL_TEST(AriaRfc5794) {
+    const char* Plain = "00112233445566778899aabbccddeeff";
+
+    CheckBlockCipher<CipherTraits::ARIA_ALG<128>>("000102030405060708090a0b0c0d0e0f", Plain, "d718fbd6ab644c739da95f3be6451778");
+    CheckBlockCipher<CipherTraits::ARIA_ALG<192>>("000102030405060708090a0b0c0d0e0f1011121314151617", Plain, "26449c1805dbe7aa25a468ce263a9e79");
+    CheckBlockCipher<CipherTraits::ARIA_ALG<256>>("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", Plain, "f92bd7c79fb72e2f2b8f80c1972d24fc");
+}
+
+//
+//  Eric Young's Blowfish vectors.
+//
+ACCEL_TEST(BlowfishVectors) {
+    CheckBlockCipher<CipherTraits::BLOWFISH_ALG<>>("0000000000000000", "0000000000000000", "4ef997456198dd78");
+    CheckBlockCipher<CipherTraits::BLOWFISH_ALG<>>("ffffffffffffffff", "ffffffffffffffff", "51866fd5b85ecb8a");
+    CheckBlockCipher<CipherTraits::BLOWFISH_ALG<>>("3000000000000000", "1000000000000001", "7d856f9a613063f2");
+}
+
+//
+//  RFC 3713, appendix A.
+//
+ACCEL_TEST(CamelliaRfc3713) {
+    const char* Plain = "0123456789abcdeffedcba9876543210";
+
+    CheckBlockCipher<CipherTraits::CAMELLIA_ALG<128>>("0123456789abcdeffedcba9876543210", Plain, "67673138549669730857065648eabe43");
+    CheckBlockCipher<CipherTraits::CAMELLIA_ALG<192>>("0123456789abcdeffedcba98765432100011223344556677", Plain, "b4993401b3e996f84ee5cee7d79b09b9");
+    CheckBlockCipher<CipherTraits::CAMELLIA_ALG<256>>("0123456789abcdeffedcba987654321000112233445566778899aabbccddeeff", Plain, "9acc237dff16d76c20ef7c919e3a7509");
+}
+
+//
+//  RFC 2144, appendix B.1, and RFC 2612, appendix A.
+//
+ACCEL_TEST(CastRfc2144Rfc2612) {
+    CheckBlockCipher<CipherTraits::CAST128_ALG>("0123456712345678234567893456789a", "0123456789abcdef", "238b4fe5847e44b2");
+    CheckBlockCipher<CipherTraits::CAST128_ALG>("01234567123456782345", "0123456789abcdef", "eb6a711a2c02271b");
+    CheckBlockCipher<CipherTraits::CAST128_ALG>("0123456712", "0123456789abcdef", "7ac816d16e9b302e");
+
+    CheckBlockCipher<CipherTraits::CAST256_ALG<128>>("2342bb9efa38542c0af75647f29f615d",
+                                                     "00000000000000000000000000000000", "c842a08972b43d20836c91d1b7530f6b");
+    CheckBlockCipher<CipherTraits::CAST256_ALG<192>>("2342bb9efa38542cbed0ac83940ac298bac77a7717942863",
+                                                     "00000000000000000000000000000000", "1b386c0210dcadcbdd0e41aa08a7a7e8");
+    CheckBlockCipher<CipherTraits::CAST256_ALG<256>>("2342bb9efa38542cbed0ac83940ac2988d7c47ce264908461cc1b5137ae6b604",
+                                                     "00000000000000000000000000000000", "4f6a2038286897b9c9870136553317fa");
+}
+
+//
+//  The worked example of FIPS 46 (as in Grabbe, "The DES Algorithm Illustrated") and NIST SP 800-67.
+//
+ACCEL_TEST(DesAndTripleDes) {
+    CheckBlockCipher<CipherTraits::DES_ALG>("133457799bbcdff1", "0123456789abcdef", "85e813540f0ab405");
+    CheckBlockCipher<CipherTraits::TRIPLE_DES_ALG>("0123456789abcdef23456789abcdef01456789abcdef0123",
+                                                   "5468652071756663", "a826fd8ce53b855f");
+}
+
+//
+//  The GOST 28147-89 vector of Crypto++ (gostval.dat), with the test S-box of GOST R 34.11-94.
+//
+ACCEL_TEST(GostVectors) {
+    CheckBlockCipher<CipherTraits::GOST2814789_ALG>("be5ec2006cff9dcf52354959f1ff0cbfe95061b5a648c10387069c25997c0672",
+                                                    "0df82802b741a292", "07f9027df7f7df89");
+}
+
+//
+//  The IDEA example of Lai's thesis.
+//
+ACCEL_TEST(IdeaVectors) {
+    CheckBlockCipher<CipherTraits::IDEA_ALG>("00010002000300040005000600070008", "0000000100020003", "11fbed2b01986de5");
+}
+
+//
+//  RFC 2268, section 5.
+//
+ACCEL_TEST(Rc2Rfc2268) {
+    using CipherTraits::RC2_ALG;
+
+    CheckBlockCipher<RC2_ALG>("0000000000000000", "0000000000000000", "ebb773f993278eff", RC2_ALG::MakeUserKeySize(63, 8));
+    CheckBlockCipher<RC2_ALG>("ffffffffffffffff", "ffffffffffffffff", "278b27e42e2f0d49", RC2_ALG::MakeUserKeySize(64, 8));
+    CheckBlockCipher<RC2_ALG>("3000000000000000", "1000000000000001", "30649edf9be7d2c2", RC2_ALG::MakeUserKeySize(64, 8));
+    CheckBlockCipher<RC2_ALG>("88", "0000000000000000", "61a8a244adacccf0", RC2_ALG::MakeUserKeySize(64, 1));
+    CheckBlockCipher<RC2_ALG>("88bca90e90875a", "0000000000000000", "6ccf4308974c267f", RC2_ALG::MakeUserKeySize(64, 7));
+    CheckBlockCipher<RC2_ALG>("88bca90e90875a7f0f79c384627bafb2", "0000000000000000", "1a807d272bbe5db1", RC2_ALG::MakeUserKeySize(64, 16));
+    CheckBlockCipher<RC2_ALG>("88bca90e90875a7f0f79c384627bafb2", "0000000000000000", "2269552ab0f85ca6", RC2_ALG::MakeUserKeySize(128, 16));
+}
+
+//
+//  RFC 6229, 40-bit key, the first 32 bytes of the keystream.
+//
+ACCEL_TEST(Rc4Rfc6229) {
+    auto Key = FromHex("0102030405");
+    auto Expected = FromHex("b2396305f03dc027ccc3524a0a1118a8 6982944f18fc82d589c403a47a0d0919");
+    std::vector<uint8_t> Stream(Expected.size(), 0);
+    CipherTraits::RC4_ALG Cipher;
+
+    if (ACCEL_CHECK(Cipher.SetKey(Key.data(), Key.size()))) {
+        Cipher.EncryptStream(Stream.data(), Stream.size());
+        ACCEL_CHECK_BYTES(Stream.data(), Stream.size(), Expected.data());
+    }
+}
+
+//
+//  Rivest's RC5 paper and the RC6 submission.
+//
+ACCEL_TEST(Rc5Rc6Vectors) {
+    CheckBlockCipher<CipherTraits::RC5_ALG<32, 12, 16>>("00000000000000000000000000000000", "0000000000000000", "21a5dbee154b8f6d");
+    CheckBlockCipher<CipherTraits::RC5_ALG<32, 12, 16>>("915f4619be41b2516355a50110a9ce91", "21a5dbee154b8f6d", "f7c013ac5b2b8952");
+
+    CheckBlockCipher<CipherTraits::RC6_ALG<32, 20, 16>>("00000000000000000000000000000000",
+                                                        "00000000000000000000000000000000", "8fc3a53656b1f778c129df4e9848a41e");
+    CheckBlockCipher<CipherTraits::RC6_ALG<32, 20, 16>>("0123456789abcdef0112233445566778",
+                                                        "02132435465768798a9bacbdcedfe0f1", "524e192f4715c6231f51f6367ea43f18");
+}
+
+//
+//  RFC 4269, appendix B.
+//
+ACCEL_TEST(SeedRfc4269) {
+    CheckBlockCipher<CipherTraits::SEED_ALG>("00000000000000000000000000000000",
+                                             "000102030405060708090a0b0c0d0e0f", "5ebac6e0054e166819aff1cc6d346cdb");
+    CheckBlockCipher<CipherTraits::SEED_ALG>("000102030405060708090a0b0c0d0e0f",
+                                             "00000000000000000000000000000000", "c11f22f20140505084483597e4370f43");
+}
+
+//
+//  NESSIE, set 3, vector 0, for the 128- and 256-bit keys. The 192-bit all-zero result is cross-checked against libgcrypt.
+//
+ACCEL_TEST(SerpentNessie) {
+    CheckBlockCipher<CipherTraits::SERPENT_ALG<128>>("00000000000000000000000000000000",
+                                                     "00000000000000000000000000000000", "3620b17ae6a993d09618b8768266bae9");
+    CheckBlockCipher<CipherTraits::SERPENT_ALG<192>>("000000000000000000000000000000000000000000000000",
+                                                     "00000000000000000000000000000000", "a583ef976a292b406bbd5dc8256b0442");
+    CheckBlockCipher<CipherTraits::SERPENT_ALG<256>>("0000000000000000000000000000000000000000000000000000000000000000",
+                                                     "00000000000000000000000000000000", "49672ba898d98df95019180445491089");
+}
+
+//
+//  The SKIPJACK and KEA specification, NIST.
+//
+ACCEL_TEST(SkipjackVectors) {
+    CheckBlockCipher<CipherTraits::SKIPJACK_ALG>("00998877665544332211", "33221100ddccbbaa", "2587cae27a12d300");
+}
+
+//
+//  GM/T 0002-2012, appendix A.1.
+//
+ACCEL_TEST(Sm4GmT0002) {
+    CheckBlockCipher<CipherTraits::SM4_ALG>("0123456789abcdeffedcba9876543210",
+                                            "0123456789abcdeffedcba9876543210", "681edf34d206965e86b3e94f536e4246");
+}
+
+//
+//  The all-zero vector and the Linux tcrypt vector with its words read big-endian.
+//
+ACCEL_TEST(TeaVectors) {
+    CheckBlockCipher<CipherTraits::TEA_ALG>("00000000000000000000000000000000", "0000000000000000", "41ea3a0a94baa940");
+    CheckBlockCipher<CipherTraits::TEA_ALG>("6805022b76491406260e5d774378286c", "747365742e656d20", "6a2a5d770992cef6");
+}
+
+//
+//  The Skein 1.3 paper, appendix C: the all-zero key, tweak and plaintext.
+//
+ACCEL_TEST(ThreefishSkein) {
+    CheckThreefish<256>("0000000000000000000000000000000000000000000000000000000000000000", 0, 0,
+                        "0000000000000000000000000000000000000000000000000000000000000000",
+                        "84da2a1f8beaee947066ae3e3103f1ad536db1f4a1192495116b9f3ce6133fd8");
+    CheckThreefish<512>("00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000", 0, 0,
+                        "00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000",
+                        "b1a2bbc6ef6025bc40eb3822161f36e375d1bb0aee3186fbd19e47c5d479947b7bc2f8586e35f0cff7e7f03084b0b7b1f1ab3961a580a3e97eb41ea14a6d7bbe");
+}
+
+//
+//  The Twofish paper, section B: the all-zero key and plaintext, and the 192- and 256-bit ascending keys.
+//  Both keying modes must give the same results.
+//
+template<CipherTraits::TwofishKeying __Keying>
+static void CheckTwofishVectors() {
+    using CipherTraits::TWOFISH_ALG;
+
+    CheckBlockCipher<TWOFISH_ALG<128, __Keying>>("00000000000000000000000000000000",
+                                                 "00000000000000000000000000000000", "9f589f5cf6122c32b6bfec2f2ae8c35a");
+    CheckBlockCipher<TWOFISH_ALG<192, __Keying>>("0123456789abcdeffedcba98765432100011223344556677",
+                                                 "00000000000000000000000000000000", "cfd1d2e5a9be9cdf501f13b892bd2248");
+    CheckBlockCipher<TWOFISH_ALG<256, __Keying>>("0000000000000000000000000000000000000000000000000000000000000000",
+                                                 "00000000000000000000000000000000", "57ff739d4dc92c1bd7fc01700cc8216f");
+    CheckBlockCipher<TWOFISH_ALG<256, __Keying>>("0123456789abcdeffedcba987654321000112233445566778899aabbccddeeff",
+                                                 "00000000000000000000000000000000", "37527be0052334b89f0cfccae87cfa20");
+}
+
+ACCEL_TEST(TwofishVectors) {
+    CheckTwofishVectors<CipherTraits::TwofishKeying::Full>();
+    CheckTwofishVectors<CipherTraits::TwofishKeying::Zero>();
+}
+
+//
+//  The all-zero vector, the Linux tcrypt vector with its words read big-endian, and the ascending-key vectors
+//  of Bouncy Castle.
+//
+ACCEL_TEST(XteaVectors) {
+    CheckBlockCipher<CipherTraits::XTEA_ALG>("00000000000000000000000000000000", "0000000000000000", "dee9d4d8f7131ed9");
+    CheckBlockCipher<CipherTraits::XTEA_ALG>("6805022b76491406260e5d774378286c", "747365742e656d20", "96c8eb94a8496a84");
+    CheckBlockCipher<CipherTraits::XTEA_ALG>("000102030405060708090a0b0c0d0e0f", "4142434445464748", "497df3d072612cb5");
+    CheckBlockCipher<CipherTraits::XTEA_ALG>("000102030405060708090a0b0c0d0e0f", "4141414141414141", "e78f2d13744341d8");
+}
+
+//
+//  The widely published two-word XXTEA vectors, with the words read big-endian.
+//
+ACCEL_TEST(XxteaVectors) {
+    CheckBlockCipher<CipherTraits::XXTEA_ALG<2>>("00000000000000000000000000000000", "0000000000000000", "053704ab575d8c80");
+    CheckBlockCipher<CipherTraits::XXTEA_ALG<2>>("0804020180402010f8fcfeff80c0e0f0", "0000000000000000", "e28be7d18a7246c7");
+    CheckBlockCipher<CipherTraits::XXTEA_ALG<2>>("b979379ee973979b9e3779b95651696b", "ffffffffffffffff", "a80eed67c53f97e8");
+    CheckBlockCipher<CipherTraits::XXTEA_ALG<2>>("0804020180402010f8fcfeff80c0e0f0", "f8fcfeff80c0e0f0", "c007378cc4cc7f1c");
+}
+
+//
+//  RFC 1319/1320/1321, appendix A.5.
+//
+ACCEL_TEST(Md2Md4Md5Rfc) {
+    CheckHash<Hash::MD2_ALG>("", "8350e5a3e24c153df2275c9f80692773");
+    CheckHash<Hash::MD2_ALG>("abc", "da853b0d3f88d99b30283a69e6ded6bb");
+    CheckHash<Hash::MD2_ALG>("message digest", "ab4f496bfb2a530b219ff33031fe06b0");
+
+    CheckHash<Hash::MD4_ALG>("", "31d6cfe0d16ae931b73c59d7e0c089c0");
+    CheckHash<Hash::MD4_ALG>("abc", "a448017aaf21d8525fc10ae87aa6729d");
+    CheckHash<Hash::MD4_ALG>("message digest", "d9130a8164549fe818874806e1c7014b");
+
+    CheckHash<Hash::MD5_ALG>("", "d41d8cd98f00b204e9800998ecf8427e");
+    CheckHash<Hash::MD5_ALG>("abc", "900150983cd24fb0d6963f7d28e17f72");
+    CheckHash<Hash::MD5_ALG>("message digest", "f96b697d7cb7938d525a2f31aaf161d0");
+    CheckHash<Hash::MD5_ALG>("12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+                             "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+//
+//  FIPS 180-4 examples (NIST CSVM).
+//
+ACCEL_TEST(ShaFips180) {
+    const char* TwoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const char* TwoBlocks1024 = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+    CheckHash<Hash::SHA1_ALG>("abc", "a9993e364706816aba3e25717850c26c9cd0d89d");
+    CheckHash<Hash::SHA1_ALG>(TwoBlocks, "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    CheckHashOfRepeated<Hash::SHA1_ALG>('a', 1000000, "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+    CheckHash<Hash::SHA224_ALG>("abc", "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7");
+    CheckHash<Hash::SHA224_ALG>(TwoBlocks, "75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525");
+
+    CheckHash<Hash::SHA256_ALG>("abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CheckHash<Hash::SHA256_ALG>(TwoBlocks, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    CheckHashOfRepeated<Hash::SHA256_ALG>('a', 1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    CheckHash<Hash::SHA384_ALG>("abc", "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7");
+    CheckHash<Hash::SHA384_ALG>(TwoBlocks1024, "09330c33f71147e83d192fc782cd1b4753111b173b3b05d22fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039");
+
+    CheckHash<Hash::SHA512_ALG>("abc", "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                                       "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+    CheckHash<Hash::SHA512_ALG>(TwoBlocks1024, "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+                                               "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909");
+}
+
+//
+//  GM/T 0004-2012, appendix A.
+//
+ACCEL_TEST(Sm3GmT0004) {
+    CheckHash<Hash::SM3_ALG>("abc", "66c7f0f462eeedd9d1f2d46bdc10e4e24167c4875cf2f7a2297da02b8f4ba8e0");
+    CheckHash<Hash::SM3_ALG>("abcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcd",
+                             "debe9ff92275b8a138604889c18e5a4d6fdb70e5387e5765293dcba39c0c5732");
+}
+
+//
+//  The RIPEMD page of Bosselaers.
+//
+ACCEL_TEST(RipemdVectors) {
+    CheckHash<Hash::RIPEMD_ALG<128>>("", "cdf26213a150dc3ecb610f18f6b38b46");
+    CheckHash<Hash::RIPEMD_ALG<128>>("abc", "c14a12199c66e4ba84636b0f69144c77");
+    CheckHash<Hash::RIPEMD_ALG<160>>("", "9c1185a5c5e9fc54612808977ee8f548b2258d31");
+    CheckHash<Hash::RIPEMD_ALG<160>>("abc", "8eb208f7e05d987a9b044a8e98c6b087f15a0bfc");
+    CheckHashOfRepeated<Hash::RIPEMD_ALG<160>>('a', 1000000, "52783243c1697bdbe16d37f97f68f08325dc1528");
+    CheckHash<Hash::RIPEMD_ALG<256>>("", "02ba4c4e5f8ecd1877fc52d64d30e37a2d9774fb1e5d026380ae0168e3c5522d");
+    CheckHash<Hash::RIPEMD_ALG<256>>("abc", "afbd6e228b9d8cbbcef5ca2d03e6dba10ac0bc7dcbe4680e1e42d2e975459b65");
+    CheckHash<Hash::RIPEMD_ALG<320>>("", "22d65d5661536cdc75c1fdf5c6de7b41b9f27325ebc61e8557177d705a0ec880151c3a32a00899b8");
+    CheckHash<Hash::RIPEMD_ALG<320>>("abc", "de4c01b3054f8930a79d09ae738e92301e5a17085beffdc1b8d116713e74f82fa942d64cdbc4682d");
+}
+
+//
+//  The Tiger reference page of Anderson and Biham.
+//
+ACCEL_TEST(TigerVectors) {
+    CheckHash<Hash::TIGER_ALG<1, 192>>("", "3293ac630c13f0245f92bbb1766e16167a4e58492dde73f3");
+    CheckHash<Hash::TIGER_ALG<1, 192>>("abc", "2aab1484e8c158f2bfb8c5ff41b57a525129131c957b5f93");
+    CheckHash<Hash::TIGER_ALG<2, 192>>("", "4441be75f6018773c206c22745374b924aa8313fef919f41");
+}
+
+//
+//  The HAVAL reference implementation.
+//
+ACCEL_TEST(HavalVectors) {
+    CheckHash<Hash::HAVAL_ALG<128, 3>>("", "c68f39913f901f3ddf44c707357a7d70");
+    CheckHash<Hash::HAVAL_ALG<256, 5>>("", "be417bb4dd5cfb76c7126f4f8eeb1553a449039307b1a3cd451dbfdc0fbbe330");
+}
+
+//
+//  ISO/IEC 10118-3 (the NESSIE Whirlpool vectors).
+//
+ACCEL_TEST(WhirlpoolIso10118) {
+    CheckHash<Hash::WHIRLPOOL_ALG>("", "19fa61d75522a4669b44e39c1d2e1726c530232130d407f89afee0964997f7a7"
+                                       "3e83be698b288febcf88e3e03c4f0757ea8964e59b63d93708b138cc42a66eb3");
+    CheckHash<Hash::WHIRLPOOL_ALG>("abc", "4e2448a4c6f486bb16b6562c73b4020bf3043e3a731bce721ae1b303d97e6d4c"
+                                          "7181eebdb6c57e277d0e34957114cbd6c797fc9d95d8b582d225292076d4eef5");
+}
+
+//
+//  RFC 2202 and RFC 4231.
+//
+ACCEL_TEST(HmacRfc2202Rfc4231) {
+    CheckHmac<Hash::MD5_ALG>(std::vector<uint8_t>(16, 0x0b), FromString("Hi There"), "9294727a3638bb1c13f48ef8158bfc9d");
+    CheckHmac<Hash::MD5_ALG>(FromString("Jefe"), FromString("what do ya want for nothing?"), "750c783e6ab0b503eaa86e310a5db738");
+    CheckHmac<Hash::SHA1_ALG>(std::vector<uint8_t>(20, 0x0b), FromString("Hi There"), "b617318655057264e28bc0b6fb378c8ef146be00");
+    CheckHmac<Hash::SHA1_ALG>(std::vector<uint8_t>(80, 0xaa), FromString("Test Using Larger Than Block-Size Key - Hash Key First"),
+                              "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+
+    CheckHmac<Hash::SHA256_ALG>(std::vector<uint8_t>(20, 0x0b), FromString("Hi There"),
+                                "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+    CheckHmac<Hash::SHA256_ALG>(FromString("Jefe"), FromString("what do ya want for nothing?"),
+                                "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    CheckHmac<Hash::SHA256_ALG>(std::vector<uint8_t>(131, 0xaa), FromString("Test Using Larger Than Block-Size Key - Hash Key First"),
+                                "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+    CheckHmac<Hash::SHA256_ALG>(FromHex("0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c0c"), FromString("Test With Truncation"),
+                                "a3b6167473100ee06e0c796c2955552b");
+    CheckHmac<Hash::SHA512_ALG>(std::vector<uint8_t>(20, 0x0b), FromString("Hi There"),
+                                "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+                                "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854");
+}
+
+//
+//  Truncated MACs shorter than RFC 2104 allows are rejected even when they match.
+//
+ACCEL_TEST(HmacRejectsShortTags) {
+    auto Message = FromString("what do ya want for nothing?");
+    auto Md5Mac = FromHex("750c783e6ab0b503eaa86e310a5db738");
+    auto Sha256Mac = FromHex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    Hash::HMAC<Hash::MD5_ALG> Md5;
+    Hash::HMAC<Hash::SHA256_ALG> Sha256;
+
+    if (ACCEL_CHECK(Md5.SetKey("Jefe", 4)) == false || ACCEL_CHECK(Sha256.SetKey("Jefe", 4)) == false)
+        return;
+
+    ACCEL_CHECK(Md5.Verify(Message.data(), Message.size(), Md5Mac.data(), 1) == false);
+    ACCEL_CHECK(Md5.Verify(Message.data(), Message.size(), Md5Mac.data(), 9) == false);
+    ACCEL_CHECK(Md5.Verify(Message.data(), Message.size(), Md5Mac.data(), 10));
+    ACCEL_CHECK(Sha256.Verify(Message.data(), Message.size(), Sha256Mac.data(), 1) == false);
+    ACCEL_CHECK(Sha256.Verify(Message.data(), Message.size(), Sha256Mac.data(), 15) == false);
+    ACCEL_CHECK(Sha256.Verify(Message.data(), Message.size(), Sha256Mac.data(), 16));
+}
+
+//
+//  RFC 6070 (PBKDF2-HMAC-SHA1) and the PBKDF2-HMAC-SHA256 vectors of RFC 7914, section 11.
+//
+ACCEL_TEST(Pbkdf2Rfc6070Rfc7914) {
+    CheckPbkdf2<Hash::SHA1_ALG>("password", FromString("salt"), 1, "0c60c80f961f0e71f3a9b524af6012062fe037a6");
+    CheckPbkdf2<Hash::SHA1_ALG>("password", FromString("salt"), 2, "ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957");
+    CheckPbkdf2<Hash::SHA1_ALG>("password", FromString("salt"), 4096, "4b007901b765489abead49d926f721d065a429c1");
+    CheckPbkdf2<Hash::SHA1_ALG>("passwordPASSWORDpassword", FromString("saltSALTsaltSALTsaltSALTsaltSALTsalt"), 4096,
+                                "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038");
+    CheckPbkdf2<Hash::SHA256_ALG>("passwd", FromString("salt"), 1,
+                                  "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+                                  "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783");
+}
+
+//
+//  The RFC 6070 inputs under PBKDF2-HMAC-SHA512, as published alongside them and cross-checked with Python's hashlib.
+//
+ACCEL_TEST(Pbkdf2Sha512) {
+    CheckPbkdf2<Hash::SHA512_ALG>("password", FromString("salt"), 1,
+                                  "867f70cf1ade02cff3752599a3a53dc4af34c7a669815ae5d513554e1c8cf252"
+                                  "c02d470a285a0501bad999bfe943c08f050235d7d68b1da55e63f73b60a57fce");
+    CheckPbkdf2<Hash::SHA512_ALG>("password", FromString("salt"), 2,
+                                  "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c"
+                                  "f76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e");
+    CheckPbkdf2<Hash::SHA512_ALG>("password", FromString("salt"), 4096,
+                                  "d197b1b33db0143e018b12f3d1d1479e6cdebdcc97c5c0f87f6902e072f457b5"
+                                  "143f30602641b3d55cd335988cb36b84376060ecd532e039b742a239434af2d5");
+    CheckPbkdf2<Hash::SHA512_ALG>("passwordPASSWORDpassword", FromString("saltSALTsaltSALTsaltSALTsaltSALTsalt"), 4096,
+                                  "8c0511f4c6e597c6ac6315d8f0362e225f3c501495ba23b868c005174dc4ee71"
+                                  "115b59f9e60cd9532fa33e0f75aefe30225c583a186cd82bd4daea9724a3d3b8");
+}
+
+//
+//  The GCM specification (McGrew and Viega), test cases 2 and 4, on every AES backend.
+//
+template<typename __CipherType>
+static void CheckGcmCase(const char* KeyHex, const char* IVHex, const char* PlainHex, const char* AadHex,
+                         const char* CipherHex, const char* TagHex) {
+    auto Key = FromHex(KeyHex);
+    auto IV = FromHex(IVHex);
+    auto Plain = FromHex(PlainHex);
+    auto Aad = FromHex(AadHex);
+    auto Expected = FromHex(CipherHex);
+    auto ExpectedTag = FromHex(TagHex);
+    std::vector<uint8_t> Output(Plain.size() + 16);
+    uint8_t Tag[16];
+
+    Modes::GCM<__CipherType, Modes::Direction::Encryption> Encryptor;
+    if (ACCEL_CHECK(Encryptor.SetKey(Key.data(), Key.size()) && Encryptor.SetIV(IV.data(), IV.size())) == false)
+        return;
+    ACCEL_CHECK(Encryptor.UpdateAAD(Aad.data(), Aad.size()));
+    size_t cbOut = Encryptor.Update(Plain.data(), Plain.size(), Output.data());
+    ACCEL_CHECK(Encryptor.Final(Tag, sizeof(Tag)));
+    ACCEL_CHECK(cbOut == Expected.size());
+    ACCEL_CHECK_BYTES(Output.data(), Expected.size(), Expected.data());
+    ACCEL_CHECK_BYTES(Tag, sizeof(Tag), ExpectedTag.data());
+
+    Modes::GCM<__CipherType, Modes::Direction::Decryption> Decryptor;
+    if (ACCEL_CHECK(Decryptor.SetKey(Key.data(), Key.size()) && Decryptor.SetIV(IV.data(), IV.size())) == false)
+        return;
+    ACCEL_CHECK(Decryptor.UpdateAAD(Aad.data(), Aad.size()));
+    Decryptor.Update(Expected.data(), Expected.size(), Output.data());
+    ACCEL_CHECK(Decryptor.Final(static_cast<const void*>(ExpectedTag.data()), ExpectedTag.size()));
+    ACCEL_CHECK_BYTES(Output.data(), Plain.size(), Plain.data());
+}
+
+template<typename __CipherType>
+static void CheckGcmCases() {
+    CheckGcmCase<__CipherType>("00000000000000000000000000000000", "000000000000000000000000",
+                               "00000000000000000000000000000000", "",
+                               "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf");
+    CheckGcmCase<__CipherType>("feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+                               "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                               "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+                               "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+                               "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+                               "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+                               "5bc94fbc3221a5db94fae95ae7121a47");
+}
+
+ACCEL_TEST(GcmSpecification) {
+    CheckGcmCases<CipherTraits::RIJNDAEL_ALG<128, 128>>();
+    CheckGcmCases<CipherTraits::AES_ALG<128>>();
+    if (RuntimeCpuFeatures().AESNI)
+        CheckGcmCases<CipherTraits::AES_AESNI_ALG<128>>();
+}
+
+//
+//  SP 800-38D, 5.2.1.1: a message takes at most 2^36 - 32 bytes of text and 2^61 - 1 bytes of AAD.
+//  Input past the limits is refused before it is read, so null buffers of that length are safe here,
+//  and the message stays usable.
+//
+ACCEL_TEST(GcmLengthLimits) {
+    using Gcm = Modes::GCM<CipherTraits::AES_ALG<128>, Modes::Direction::Encryption>;
+    constexpr uint64_t MaxText = Gcm::MaxTextLengthValue;
+    constexpr uint64_t MaxAad = Gcm::MaxAadLengthValue;
+    uint8_t Key[16] = {};
+    uint8_t IV[12] = {};
+    uint8_t Plain[16] = {};
+    uint8_t Output[16];
+    uint8_t Expected[16];
+    uint8_t Tag[16];
+    uint8_t ExpectedTag[16];
+
+    ACCEL_CHECK(MaxText == 68719476704u && MaxAad == 2305843009213693951u);
+
+    Gcm Reference;
+    if (ACCEL_CHECK(Reference.SetKey(Key, sizeof(Key)) && Reference.SetIV(IV, sizeof(IV))) == false)
+        return;
+    ACCEL_CHECK(Reference.UpdateAAD(Plain, 1));
+    ACCEL_CHECK(Reference.Update(Plain, sizeof(Plain), Expected) == sizeof(Plain));
+    ACCEL_CHECK(Reference.Final(ExpectedTag, sizeof(ExpectedTag)));
+
+    Gcm Limited;
+    if (ACCEL_CHECK(Limited.SetKey(Key, sizeof(Key)) && Limited.SetIV(IV, sizeof(IV))) == false)
+        return;
+    ACCEL_CHECK(Limited.UpdateAAD(Plain, 1));
+    if constexpr (sizeof(size_t) >= sizeof(uint64_t)) {
+        ACCEL_CHECK(Limited.UpdateAAD(nullptr, static_cast<size_t>(MaxAad)) == false);
+        ACCEL_CHECK(Limited.Update(nullptr, static_cast<size_t>(MaxText + 1), nullptr) == 0);
+    }
+    ACCEL_CHECK(Limited.Update(Plain, sizeof(Plain), Output) == sizeof(Plain));
+    if constexpr (sizeof(size_t) >= sizeof(uint64_t)) {
+        ACCEL_CHECK(Limited.Update(nullptr, static_cast<size_t>(MaxText - sizeof(Plain) + 1), nullptr) == 0);
+    }
+    ACCEL_CHECK(Limited.Final(Tag, sizeof(Tag)));
+
+    ACCEL_CHECK_BYTES(Output, sizeof(Output), Expected);
+    ACCEL_CHECK_BYTES(Tag, sizeof(Tag), ExpectedTag);
+}
+
+//
+//  IEEE 1619-2007, appendix B, vectors 2 and 3. Vector 1 uses two equal key halves, which XTS::SetKey rejects.
+//
+template<typename __CipherType>
+static void CheckXtsCases() {
+    struct {
+        const char* KeyHex;
+        uint64_t Sector;
+        const char* PlainHex;
+        const char* CipherHex;
+    } Cases[] = {
+        { "1111111111111111111111111111111122222222222222222222222222222222", 0x3333333333,
+          "4444444444444444444444444444444444444444444444444444444444444444",
+          "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0" },
+        { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f022222222222222222222222222222222", 0x3333333333,
+          "4444444444444444444444444444444444444444444444444444444444444444",
+          "af85336b597afc1a900b2eb21ec949d292df4c047e0b21532186a5971a227a89" },
+    };
+
+    for (const auto& Case : Cases) {
+        auto Key = FromHex(Case.KeyHex);
+        auto Plain = FromHex(Case.PlainHex);
+        auto Expected = FromHex(Case.CipherHex);
+        std::vector<uint8_t> Output(Plain.size());
+
+        Modes::XTS<__CipherType, Modes::Direction::Encryption> Encryptor;
+        if (ACCEL_CHECK(Encryptor.SetKey(Key.data(), Key.size())) == false)
+            continue;
+        ACCEL_CHECK(Encryptor.ProcessSector(Case.Sector, Plain.data(), Plain.size(), Output.data()));
+        ACCEL_CHECK_BYTES(Output.data(), Output.size(), Expected.data());
+
+        Modes::XTS<__CipherType, Modes::Direction::Decryption> Decryptor;
+        if (ACCEL_CHECK(Decryptor.SetKey(Key.data(), Key.size())) == false)
+            continue;
+        ACCEL_CHECK(Decryptor.ProcessSector(Case.Sector, Expected.data(), Expected.size(), Output.data()));
+        ACCEL_CHECK_BYTES(Output.data(), Output.size(), Plain.data());
+    }
+}
+
+ACCEL_TEST(XtsIeee1619) {
+    CheckXtsCases<CipherTraits::RIJNDAEL_ALG<128, 128>>();
+    if (RuntimeCpuFeatures().AESNI)
+        CheckXtsCases<CipherTraits::AES_AESNI_ALG<128>>();
+}
+
+int main(int argc, char* argv[]) {
+    return accel::Test::RunAll(argc, argv);
+}
+
@@ -0,0 +1,161 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+
+//
+//  A minimal test runner for the test executables. No dependencies beyond the standard library.
+//
+//      ACCEL_TEST(Name) { ... }                    defines and registers a test
+//      ACCEL_CHECK(Expression)                     records a failure and goes on
+//      ACCEL_CHECK_BYTES(pbActual, cb, pbExpected) compares bytes and prints both in hex on failure
+//
+//  The executables run every test, or only those whose name contains argv[1], and return non-zero on any failure.
+//
+namespace accel::Test {
+
+    struct TestCase {
+        const char* Name;
+        void (*Routine)();
+    };
+
+    inline std::vector<TestCase>& Registry() {
+        static std::vector<TestCase> Tests;
+        return Tests;
+    }
+
+    struct Registrar {
+        Registrar(const char* Name, void (*Routine)()) {
+            Registry().push_back(TestCase{ Name, Routine });
+        }
+    };
+
+    inline size_t g_Failures = 0;
+    inline const char* g_CurrentTest = "";
+
+    inline std::string ToHex(const void* pbData, size_t cbData) {
+        static const char Digits[] = "0123456789abcdef";
+        auto pbBytes = reinterpret_cast<const uint8_t*>(pbData);
+        std::string Hex;
+
+        for (size_t i = 0; i < cbData; ++i) {
+            Hex += Digits[pbBytes[i] >> 4];
+            Hex += Digits[pbBytes[i] & 0x0f];
+        }
+
+        return Hex;
+    }
+
+    //
+    //  Whitespace is skipped, so vectors can be written as they are printed in the standards.
+    //
+    inline std::vector<uint8_t> FromHex(const char* Hex) {
+        std::vector<uint8_t> Bytes;
+        int High = -1;
+
+        for (; *Hex; ++Hex) {
+            int Nibble;
+
+            if (*Hex >= '0' && *Hex <= '9') {
+                Nibble = *Hex - '0';
+            } else if (*Hex >= 'a' && *Hex <= 'f') {
+                Nibble = *Hex - 'a' + 10;
+            } else if (*Hex >= 'A' && *Hex <= 'F') {
+                Nibble = *Hex - 'A' + 10;
+            } else {
+                continue;
+            }
+
+            if (High < 0) {
+                High = Nibble;
+            } else {
+                Bytes.push_back(static_cast<uint8_t>(High << 4 | Nibble));
+                High = -1;
+            }
+        }
+
+        return Bytes;
+    }
+
+    inline std::vector<uint8_t> FromString(const char* Text) {
+        return std::vector<uint8_t>(Text, Text + strlen(Text));
+    }
+
+    inline void ReportFailure(const char* File, int Line, const char* Expression) {
+        ++g_Failures;
+        fprintf(stderr, "%s:%d: [%s] check failed: %s\n", File, Line, g_CurrentTest, Expression);
+    }
+
+    inline bool CheckBytes(const char* File, int Line, const char* Expression,
+                           const void* pbActual, size_t cbData, const void* pbExpected) {
+        if (memcmp(pbActual, pbExpected, cbData) == 0)
+            return true;
+
+        ReportFailure(File, Line, Expression);
+        fprintf(stderr, "    actual:   %s\n    expected: %s\n", ToHex(pbActual, cbData).c_str(), ToHex(pbExpected, cbData).c_str());
+        return false;
+    }
+
+    //
+    //  Deterministic pseudo-random bytes, so a failure can be reproduced.
+    //
+    class RandomBytes {
+    private:
+        std::mt19937_64 _Engine;
+    public:
+        explicit RandomBytes(uint64_t Seed) : _Engine(Seed) {}
+
+        void Fill(void* pbData, size_t cbData) {
+            auto pbBytes = reinterpret_cast<uint8_t*>(pbData);
+            for (size_t i = 0; i < cbData; ++i)
+                pbBytes[i] = static_cast<uint8_t>(_Engine());
+        }
+
+        std::vector<uint8_t> Bytes(size_t cbData) {
+            std::vector<uint8_t> Result(cbData);
+            Fill(Result.data(), cbData);
+            return Result;
+        }
+
+        size_t Below(size_t Bound) {
+            return Bound ? static_cast<size_t>(_Engine() % Bound) : 0;
+        }
+    };
+
+    inline int RunAll(int argc, char* argv[]) {
+        const char* Filter = argc > 1 ? argv[1] : nullptr;
+        size_t Ran = 0;
+
+        for (const auto& Test : Registry()) {
+            if (Filter && strstr(Test.Name, Filter) == nullptr)
+                continue;
+
+            size_t FailuresBefore = g_Failures;
+            g_CurrentTest = Test.Name;
+            Test.Routine();
+            ++Ran;
+
+            printf("%-48s %s\n", Test.Name, g_Failures == FailuresBefore ? "ok" : "FAILED");
+        }
+
+        printf("%zu test(s), %zu failed check(s)\n", Ran, g_Failures);
+        return g_Failures == 0 && Ran != 0 ? 0 : 1;
+    }
+
+}
+
+#define ACCEL_TEST(__Name)                                                                      \
+    static void __Name();                                                                       \
+    static const accel::Test::Registrar __Name##_Registrar(#__Name, __Name);                    \
+    static void __Name()
+
+#define ACCEL_CHECK(__Expression)                                                               \
+    ((__Expression) ? true : (accel::Test::ReportFailure(__FILE__, __LINE__, #__Expression), false))
+
+#define ACCEL_CHECK_BYTES(__pbActual, __cbData, __pbExpected)                                   \
+    accel::Test::CheckBytes(__FILE__, __LINE__, #__pbActual " == " #__pbExpected, (__pbActual), (__cbData), (__pbExpected))
+
@@ -0,0 +1,146 @@
+#pragma once
+#include "Config.hpp"
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace accel {
+
+    //
+    //  A fixed set of worker threads for fork-join jobs.
+    //  `Run(TaskCount, Task)` calls `Task(i)` for every i in [0, TaskCount) and returns when all of them are done.
+    //  Task indexes are handed out one at a time, so uneven tasks balance themselves.
+    //  The calling thread works on the job too, so a pool of N threads starts N - 1 workers.
+    //
+    //  One job runs at a time: Run is not reentrant and must not be called concurrently on the same pool.
+    //
+    class ThreadPool {
+    private:
+        using _TaskRoutine = void(*)(void* Context, size_t TaskIndex);
+
+        std::vector<std::thread> _Workers;
+        std::mutex _Lock;
+        std::condition_variable _JobPosted;
+        std::condition_variable _JobDone;
+
+        _TaskRoutine _Routine;
+        void* _Context;
+        size_t _TaskCount;
+        std::atomic<size_t> _NextTask;
+        size_t _BusyWorkers;            // workers still inside the current job
+        size_t _Generation;             // bumped once per posted job
+        bool _Stopping;
+
+        void _Work() ACCEL_NOEXCEPT {
+            size_t i;
+            while ((i = _NextTask.fetch_add(1, std::memory_order_relaxed)) < _TaskCount)
+                _Routine(_Context, i);
+        }
+
+        void _WorkerMain() ACCEL_NOEXCEPT {
+            size_t SeenGeneration = 0;
+
+            std::unique_lock<std::mutex> Guard(_Lock);
+            for (;;) {
+                _JobPosted.wait(Guard, [this, SeenGeneration]() { return _Stopping || _Generation != SeenGeneration; });
+                if (_Stopping)
+                    return;
+
+                SeenGeneration = _Generation;
+
+                Guard.unlock();
+                _Work();
+                Guard.lock();
+
+                if (--_BusyWorkers == 0)
+                    _JobDone.notify_one();
+            }
+        }
+
+        void _Shutdown() ACCEL_NOEXCEPT {
+            {
+                std::lock_guard<std::mutex> Guard(_Lock);
+                _Stopping = true;
+            }
+
+            _JobPosted.notify_all();
+            for (auto& Worker : _Workers)
+                Worker.join();
+            _Workers.clear();
+        }
+
+    public:
+
+        //
+        //  `ThreadCount` counts the calling thread; 0 means std::thread::hardware_concurrency().
+        //  Throws std::system_error if a worker cannot be started.
+        //
+        explicit ThreadPool(size_t ThreadCount = 0) :
+            _Routine(nullptr),
+            _Context(nullptr),
+            _TaskCount(0),
+            _NextTask(0),
+            _BusyWorkers(0),
+            _Generation(0),
+            _Stopping(false)
+        {
+            if (ThreadCount == 0)
+                ThreadCount = std::thread::hardware_concurrency();
+            if (ThreadCount == 0)
+                ThreadCount = 1;
+
+            _Workers.reserve(ThreadCount - 1);
+            try {
+                for (size_t i = 1; i < ThreadCount; ++i)
+                    _Workers.emplace_back(&ThreadPool::_WorkerMain, this);
+            } catch (...) {
+                _Shutdown();
+                throw;
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t ThreadCount() const ACCEL_NOEXCEPT {
+            return _Workers.size() + 1;
+        }
+
+        template<typename __TaskType>
+        void Run(size_t TaskCount, __TaskType&& Task) ACCEL_NOEXCEPT {
+            if (_Workers.empty() || TaskCount < 2) {
+                for (size_t i = 0; i < TaskCount; ++i)
+                    Task(i);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> Guard(_Lock);
+                _Routine = [](void* Context, size_t TaskIndex) { (*reinterpret_cast<std::remove_reference_t<__TaskType>*>(Context))(TaskIndex); };
+                _Context = const_cast<void*>(reinterpret_cast<const volatile void*>(&Task));
+                _TaskCount = TaskCount;
+                _NextTask.store(0, std::memory_order_relaxed);
+                _BusyWorkers = _Workers.size();
+                ++_Generation;
+            }
+
+            _JobPosted.notify_all();
+            _Work();
+
+            std::unique_lock<std::mutex> Guard(_Lock);
+            _JobDone.wait(Guard, [this]() { return _BusyWorkers == 0; });
+            _Routine = nullptr;
+            _Context = nullptr;
+            _TaskCount = 0;
+        }
+
+        ~ThreadPool() ACCEL_NOEXCEPT {
+            _Shutdown();
+        }
+    };
+
+}
@@ -0,0 +1,592 @@
+//
+//  accel-bench: throughput and setup cost of every cipher and hash, as JSON.
+//
+//      accel-bench [-o FILE] [-f SUBSTRING] [-t SECONDS] [-m MAX_BYTES]
+//
+//  For every block cipher: key setup, and in-place ECB encryption and decryption at 16 B ... 16 MiB
+//  (through the cipher's multi-block kernel where it has one). For RC4: key setup and the stream.
+//  For every hash: a whole message (Reset, Update, DigestTo) at 16 B ... 16 MiB, and the cost of finalization alone.
+//  For the batch hashers: 16 messages of each size at once.
+//
+//  Every point is the best of repeated timed batches, run for at least -t seconds (0.05 by default).
+//  Cycles are TSC cycles on x86, which tick at a fixed rate and not at the core clock; elsewhere they are omitted.
+//  The JSON goes to stdout, or to -o FILE, and a table goes to stderr.
+//
+#include "../CpuFeatures.hpp"
+#include "../Intrinsic.hpp"
+#include "../Modes/common.hpp"
+#include "../CipherTraits/aes.hpp"
+#include "../CipherTraits/aes_aesni.hpp"
+#include "../CipherTraits/aes_vaes.hpp"
+#include "../CipherTraits/aes_bitsliced.hpp"
+#include "../CipherTraits/aria.hpp"
+#include "../CipherTraits/blowfish.hpp"
+#include "../CipherTraits/camellia.hpp"
+#include "../CipherTraits/cast128.hpp"
+#include "../CipherTraits/cast256.hpp"
+#include "../CipherTraits/des.hpp"
+#include "../CipherTraits/gost.hpp"
+#include "../CipherTraits/idea.hpp"
+#include "../CipherTraits/rc2.hpp"
+#include "../CipherTraits/rc4.hpp"
+#include "../CipherTraits/rc5.hpp"
+#include "../CipherTraits/rc6.hpp"
+#include "../CipherTraits/rijndael.hpp"
+#include "../CipherTraits/rijndael256_aesni.hpp"
+#include "../CipherTraits/seed.hpp"
+#include "../CipherTraits/serpent.hpp"
+#include "../CipherTraits/skipjack.hpp"
+#include "../CipherTraits/sm4.hpp"
+#include "../CipherTraits/tea.hpp"
+#include "../CipherTraits/threefish.hpp"
+#include "../CipherTraits/twofish.hpp"
+#include "../CipherTraits/xtea.hpp"
+#include "../CipherTraits/xxtea.hpp"
+#include "../Hash/hasher.hpp"
+#include "../Hash/haval.hpp"
+#include "../Hash/md2.hpp"
+#include "../Hash/md4.hpp"
+#include "../Hash/md5.hpp"
+#include "../Hash/md5_batch.hpp"
+#include "../Hash/ripemd.hpp"
+#include "../Hash/sha1.hpp"
+#include "../Hash/sha1_batch.hpp"
+#include "../Hash/sha224.hpp"
+#include "../Hash/sha256.hpp"
+#include "../Hash/sha256_batch.hpp"
+#include "../Hash/sha384.hpp"
+#include "../Hash/sha512.hpp"
+#include "../Hash/sm3.hpp"
+#include "../Hash/tiger.hpp"
+#include "../Hash/whirlpool.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <x86intrin.h>
+#define ACCEL_BENCH_HAS_TSC 1
+#else
+#define ACCEL_BENCH_HAS_TSC 0
+#endif
+
+namespace {
+
+    using namespace accel;
+
+    using Clock = std::chrono::steady_clock;
+
+    const size_t MessageSizes[] = {
+        16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216
+    };
+
+    constexpr size_t BatchMessages = 16;
+
+    struct Options {
+        const char* OutputPath = nullptr;
+        const char* Filter = nullptr;
+        double MinSeconds = 0.05;
+        size_t MaxBytes = 16777216;
+    };
+
+    struct Sample {
+        double Nanoseconds;         // per operation
+        double Cycles;              // per operation, < 0 if there is no cycle counter
+    };
+
+    struct Result {
+        std::string Kind;
+        std::string Algorithm;
+        std::string Operation;
+        size_t Bytes;               // 0 for per-operation costs
+        Sample PerOperation;
+    };
+
+    Options g_Options;
+    std::vector<Result> g_Results;
+    volatile uint8_t g_Sink;
+
+    inline uint64_t ReadCycleCounter() noexcept {
+#if ACCEL_BENCH_HAS_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    //
+    //  Best time per call of `Operation` over batches of calls, each batch at least 1/20 of the time budget.
+    //
+    template<typename __OperationType>
+    Sample Measure(__OperationType&& Operation) {
+        const double BatchSeconds = g_Options.MinSeconds / 20;
+        size_t Calls = 1;
+
+        Operation();
+        for (;;) {
+            auto Start = Clock::now();
+            for (size_t i = 0; i < Calls; ++i)
+                Operation();
+            double Elapsed = std::chrono::duration<double>(Clock::now() - Start).count();
+            if (Elapsed >= BatchSeconds || Calls >= (size_t(1) << 30))
+                break;
+            Calls = Elapsed <= 0 ? Calls * 16 : static_cast<size_t>(Calls * BatchSeconds / Elapsed * 1.2) + 1;
+        }
+
+        Sample Best = { 1e300, 1e300 };
+        double Total = 0;
+
+        do {
+            auto Start = Clock::now();
+            uint64_t StartCycles = ReadCycleCounter();
+            for (size_t i = 0; i < Calls; ++i)
+                Operation();
+            uint64_t Cycles = ReadCycleCounter() - StartCycles;
+            double Elapsed = std::chrono::duration<double>(Clock::now() - Start).count();
+
+            Total += Elapsed;
+            if (Elapsed * 1e9 / Calls < Best.Nanoseconds) {
+                Best.Nanoseconds = Elapsed * 1e9 / Calls;
+                Best.Cycles = ACCEL_BENCH_HAS_TSC ? static_cast<double>(Cycles) / Calls : -1;
+            }
+        } while (Total < g_Options.MinSeconds);
+
+        return Best;
+    }
+
+    bool Selected(const char* Algorithm) noexcept {
+        return g_Options.Filter == nullptr || strstr(Algorithm, g_Options.Filter) != nullptr;
+    }
+
+    void Record(const char* Kind, const char* Algorithm, const char* Operation, size_t Bytes, const Sample& PerOperation) {
+        g_Results.push_back(Result{ Kind, Algorithm, Operation, Bytes, PerOperation });
+
+        if (Bytes) {
+            fprintf(stderr, "%-8s %-26s %-13s %9zu B  %10.1f MB/s  %8.2f cpb\n",
+                    Kind, Algorithm, Operation, Bytes,
+                    Bytes / PerOperation.Nanoseconds * 1e3,
+                    PerOperation.Cycles < 0 ? 0.0 : PerOperation.Cycles / Bytes);
+        } else {
+            fprintf(stderr, "%-8s %-26s %-13s %11s  %10.1f ns      %8.0f cycles\n",
+                    Kind, Algorithm, Operation, "",
+                    PerOperation.Nanoseconds,
+                    PerOperation.Cycles < 0 ? 0.0 : PerOperation.Cycles);
+        }
+    }
+
+    std::vector<uint8_t> MakeBuffer(size_t Size) {
+        std::vector<uint8_t> Buffer(Size);
+        for (size_t i = 0; i < Size; ++i)
+            Buffer[i] = static_cast<uint8_t>(i * 131 + 7);
+        return Buffer;
+    }
+
+    //
+    //  Ciphers differ in how they are keyed: a fixed key size or a range, and THREEFISH_ALG takes a tweak.
+    //
+    template<typename __CipherType, typename = void>
+    struct KeySizeOf {
+        static constexpr size_t Value = __CipherType::MaxKeySizeValue;
+    };
+
+    template<typename __CipherType>
+    struct KeySizeOf<__CipherType, std::void_t<decltype(__CipherType::KeySizeValue)>> {
+        static constexpr size_t Value = __CipherType::KeySizeValue;
+    };
+
+    //
+    //  Key bytes with odd parity, which DES_ALG and TRIPLE_DES_ALG check for and every other cipher ignores.
+    //
+    std::vector<uint8_t> MakeKey(size_t Size) {
+        std::vector<uint8_t> Key = MakeBuffer(Size);
+        for (auto& Byte : Key)
+            Byte = static_cast<uint8_t>((Byte & 0xfe) | (PopulationCount<uint8_t>(Byte & 0xfe) % 2 == 0));
+        return Key;
+    }
+
+    template<typename __CipherType>
+    bool SetKey(__CipherType& Cipher, const uint8_t* pbKey) noexcept {
+        if constexpr (std::is_invocable_v<decltype(&__CipherType::SetKey), __CipherType&, const void*, size_t>) {
+            return Cipher.SetKey(pbKey, KeySizeOf<__CipherType>::Value);
+        } else {
+            return Cipher.SetKey(pbKey, KeySizeOf<__CipherType>::Value, 0, 0);
+        }
+    }
+
+    bool AlwaysSupported() noexcept {
+        return true;
+    }
+
+    bool HasAESNI() noexcept {
+        return RuntimeCpuFeatures().AESNI;
+    }
+
+    bool HasSSSE3() noexcept {
+        return RuntimeCpuFeatures().SSSE3;
+    }
+
+    bool HasAESNIAndSSSE3() noexcept {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+        return Features.AESNI && Features.SSSE3;
+    }
+
+    bool HasVAES256() noexcept {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+        return Features.AESNI && Features.VAES && Features.AVX2;
+    }
+
+    bool HasVAES512() noexcept {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+        return Features.AESNI && Features.VAES && Features.AVX512F;
+    }
+
+    template<typename __CipherType>
+    void BenchCipher(const char* Algorithm, bool (*Supported)() = AlwaysSupported) {
+        constexpr size_t BlockSize = __CipherType::BlockSizeValue;
+
+        if (Selected(Algorithm) == false || Supported() == false)
+            return;
+
+        auto Key = MakeKey(KeySizeOf<__CipherType>::Value);
+        __CipherType Cipher;
+
+        Record("cipher", Algorithm, "key_setup", 0, Measure([&]() {
+            if (SetKey(Cipher, Key.data()) == false)
+                abort();
+        }));
+
+        for (size_t Size : MessageSizes) {
+            size_t Bytes = Size < BlockSize ? BlockSize : Size / BlockSize * BlockSize;
+
+            if (Size > g_Options.MaxBytes)
+                break;
+
+            auto Buffer = MakeBuffer(Bytes);
+
+            Record("cipher", Algorithm, "encrypt", Bytes, Measure([&]() {
+                Modes::Internal::EncryptBlocks(Cipher, Buffer.data(), Bytes / BlockSize);
+            }));
+            Record("cipher", Algorithm, "decrypt", Bytes, Measure([&]() {
+                Modes::Internal::DecryptBlocks(Cipher, Buffer.data(), Bytes / BlockSize);
+            }));
+            g_Sink = Buffer[0];
+        }
+    }
+
+    void BenchRC4(const char* Algorithm) {
+        if (Selected(Algorithm) == false)
+            return;
+
+        auto Key = MakeBuffer(16);
+        CipherTraits::RC4_ALG Cipher;
+
+        Record("cipher", Algorithm, "key_setup", 0, Measure([&]() {
+            if (Cipher.SetKey(Key.data(), Key.size()) == false)
+                abort();
+        }));
+
+        for (size_t Size : MessageSizes) {
+            if (Size > g_Options.MaxBytes)
+                break;
+
+            auto Buffer = MakeBuffer(Size);
+
+            Record("cipher", Algorithm, "encrypt", Size, Measure([&]() {
+                Cipher.EncryptStream(Buffer.data(), Size);
+            }));
+            g_Sink = Buffer[0];
+        }
+    }
+
+    template<typename __AlgType>
+    void BenchHash(const char* Algorithm) {
+        if (Selected(Algorithm) == false)
+            return;
+
+        Hash::UnkeyedHasher<__AlgType> Hasher;
+        uint8_t Digest[__AlgType::DigestSizeValue];
+
+        for (size_t Size : MessageSizes) {
+            if (Size > g_Options.MaxBytes)
+                break;
+
+            auto Message = MakeBuffer(Size);
+
+            Record("hash", Algorithm, "hash", Size, Measure([&]() {
+                Hasher.Reset();
+                Hasher.Update(Message.data(), Size);
+                Hasher.DigestTo(Digest);
+            }));
+        }
+
+        //
+        //  With a block and a half fed, DigestTo pads and compresses one final block.
+        //
+        auto Message = MakeBuffer(__AlgType::BlockSizeValue + __AlgType::BlockSizeValue / 2);
+        Hasher.Reset();
+        Hasher.Update(Message.data(), Message.size());
+        Record("hash", Algorithm, "finalize", 0, Measure([&]() {
+            Hasher.DigestTo(Digest);
+        }));
+
+        g_Sink = Digest[0];
+    }
+
+    template<typename __BatchType>
+    void BenchHashBatch(const char* Algorithm) {
+        if (Selected(Algorithm) == false)
+            return;
+
+        uint8_t Digests[BatchMessages][__BatchType::DigestSizeValue];
+
+        for (size_t Size : MessageSizes) {
+            if (Size * BatchMessages > g_Options.MaxBytes)
+                break;
+
+            auto Messages = MakeBuffer(Size * BatchMessages);
+            Hash::HashMessage Batch[BatchMessages];
+
+            for (size_t i = 0; i < BatchMessages; ++i)
+                Batch[i] = Hash::HashMessage{ Messages.data() + i * Size, Size, Digests[i] };
+
+            Record("hash", Algorithm, "hash_x16", Size * BatchMessages, Measure([&]() {
+                __BatchType::HashMessages(Batch, BatchMessages);
+            }));
+        }
+
+        g_Sink = Digests[0][0];
+    }
+
+    void RunAll() {
+        using namespace accel::CipherTraits;
+
+        BenchCipher<AES_ALG<128>>("AES_ALG<128>");
+        BenchCipher<AES_ALG<192>>("AES_ALG<192>");
+        BenchCipher<AES_ALG<256>>("AES_ALG<256>");
+        BenchCipher<AES_AESNI_ALG<128>>("AES_AESNI_ALG<128>", HasAESNI);
+        BenchCipher<AES_AESNI_ALG<192>>("AES_AESNI_ALG<192>", HasAESNI);
+        BenchCipher<AES_AESNI_ALG<256>>("AES_AESNI_ALG<256>", HasAESNI);
+        BenchCipher<AES_BITSLICED_ALG<128>>("AES_BITSLICED_ALG<128>", HasSSSE3);
+        BenchCipher<AES_BITSLICED_ALG<256>>("AES_BITSLICED_ALG<256>", HasSSSE3);
+        BenchCipher<AES_VAES_ALG<128, 256>>("AES_VAES_ALG<128, 256>", HasVAES256);
+        BenchCipher<AES_VAES_ALG<128, 512>>("AES_VAES_ALG<128, 512>", HasVAES512);
+        BenchCipher<AES_VAES_ALG<256, 512>>("AES_VAES_ALG<256, 512>", HasVAES512);
+        BenchCipher<RIJNDAEL_ALG<128, 128>>("RIJNDAEL_ALG<128, 128>");
+        BenchCipher<RIJNDAEL_ALG<192, 128>>("RIJNDAEL_ALG<192, 128>");
+        BenchCipher<RIJNDAEL_ALG<256, 128>>("RIJNDAEL_ALG<256, 128>");
+        BenchCipher<RIJNDAEL_ALG<256, 256>>("RIJNDAEL_ALG<256, 256>");
+        BenchCipher<RIJNDAEL256_AESNI_ALG<128>>("RIJNDAEL256_AESNI_ALG<128>", HasAESNIAndSSSE3);
+        BenchCipher<RIJNDAEL256_AESNI_ALG<256>>("RIJNDAEL256_AESNI_ALG<256>", HasAESNIAndSSSE3);
+        BenchCipher<RIJNDAEL_ALG<128, 128, RijndaelPolicy::ByteWise>>("RIJNDAEL_ALG<128, 128, ByteWise>");
+        BenchCipher<RIJNDAEL_ALG<256, 256, RijndaelPolicy::ByteWise>>("RIJNDAEL_ALG<256, 256, ByteWise>");
+        BenchCipher<ARIA_ALG<128>>("ARIA_ALG<128>");
+        BenchCipher<ARIA_ALG<256>>("ARIA_ALG<256>");
+        BenchCipher<BLOWFISH_ALG<>>("BLOWFISH_ALG");
+        BenchCipher<CAMELLIA_ALG<128>>("CAMELLIA_ALG<128>");
+        BenchCipher<CAMELLIA_ALG<256>>("CAMELLIA_ALG<256>");
+        BenchCipher<CAST128_ALG>("CAST128_ALG");
+        BenchCipher<CAST256_ALG<256>>("CAST256_ALG<256>");
+        BenchCipher<DES_ALG>("DES_ALG");
+        BenchCipher<TRIPLE_DES_ALG>("TRIPLE_DES_ALG");
+        BenchCipher<GOST2814789_ALG>("GOST2814789_ALG");
+        BenchCipher<IDEA_ALG>("IDEA_ALG");
+        BenchCipher<RC2_ALG>("RC2_ALG");
+        BenchRC4("RC4_ALG");
+        BenchCipher<RC5_ALG<32, 12, 16>>("RC5_ALG<32, 12, 16>");
+        BenchCipher<RC6_ALG<32, 20, 16>>("RC6_ALG<32, 20, 16>");
+        BenchCipher<SEED_ALG>("SEED_ALG");
+        BenchCipher<SERPENT_ALG<128>>("SERPENT_ALG<128>");
+        BenchCipher<SERPENT_ALG<256>>("SERPENT_ALG<256>");
+        BenchCipher<SKIPJACK_ALG>("SKIPJACK_ALG");
+        BenchCipher<SM4_ALG>("SM4_ALG");
+        BenchCipher<TEA_ALG>("TEA_ALG");
+        BenchCipher<THREEFISH_ALG<256>>("THREEFISH_ALG<256>");
+        BenchCipher<THREEFISH_ALG<512>>("THREEFISH_ALG<512>");
+        BenchCipher<THREEFISH_ALG<1024>>("THREEFISH_ALG<1024>");
+        BenchCipher<TWOFISH_ALG<128>>("TWOFISH_ALG<128>");
+        BenchCipher<TWOFISH_ALG<256>>("TWOFISH_ALG<256>");
+        BenchCipher<TWOFISH_ALG<128, TwofishKeying::Zero>>("TWOFISH_ALG<128, Zero>");
+        BenchCipher<XTEA_ALG>("XTEA_ALG");
+        BenchCipher<XXTEA_ALG<4>>("XXTEA_ALG<4>");
+
+        using namespace accel::Hash;
+
+        BenchHash<MD2_ALG>("MD2_ALG");
+        BenchHash<MD4_ALG>("MD4_ALG");
+        BenchHash<MD5_ALG>("MD5_ALG");
+        BenchHash<SHA1_ALG>("SHA1_ALG");
+        BenchHash<SHA224_ALG>("SHA224_ALG");
+        BenchHash<SHA256_ALG>("SHA256_ALG");
+        BenchHash<SHA384_ALG>("SHA384_ALG");
+        BenchHash<SHA512_ALG>("SHA512_ALG");
+        BenchHash<SM3_ALG>("SM3_ALG");
+        BenchHash<RIPEMD_ALG<128>>("RIPEMD_ALG<128>");
+        BenchHash<RIPEMD_ALG<160>>("RIPEMD_ALG<160>");
+        BenchHash<RIPEMD_ALG<256>>("RIPEMD_ALG<256>");
+        BenchHash<RIPEMD_ALG<320>>("RIPEMD_ALG<320>");
+        BenchHash<TIGER_ALG<1, 192>>("TIGER_ALG<1, 192>");
+        BenchHash<TIGER_ALG<2, 192>>("TIGER_ALG<2, 192>");
+        BenchHash<HAVAL_ALG<256, 3>>("HAVAL_ALG<256, 3>");
+        BenchHash<HAVAL_ALG<256, 5>>("HAVAL_ALG<256, 5>");
+        BenchHash<WHIRLPOOL_ALG>("WHIRLPOOL_ALG");
+        BenchHashBatch<MD5_BATCH>("MD5_BATCH");
+        BenchHashBatch<SHA1_BATCH>("SHA1_BATCH");
+        BenchHashBatch<SHA256_BATCH>("SHA256_BATCH");
+    }
+
+    std::string JsonEscape(const std::string& Text) {
+        std::string Escaped;
+
+        for (char c : Text) {
+            if (c == '"' || c == '\\') {
+                Escaped += '\\';
+                Escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char Code[8];
+                snprintf(Code, sizeof(Code), "\\u%04x", c);
+                Escaped += Code;
+            } else {
+                Escaped += c;
+            }
+        }
+
+        return Escaped;
+    }
+
+    //
+    //  TSC ticks per nanosecond, from a 100 ms sleep.
+    //
+    double MeasureCycleRate() {
+#if ACCEL_BENCH_HAS_TSC
+        auto Start = Clock::now();
+        uint64_t StartCycles = ReadCycleCounter();
+        struct timespec Delay = { 0, 100000000 };
+        nanosleep(&Delay, nullptr);
+        uint64_t Cycles = ReadCycleCounter() - StartCycles;
+        return Cycles / (std::chrono::duration<double>(Clock::now() - Start).count() * 1e9);
+#else
+        return 0;
+#endif
+    }
+
+    void WriteJson(FILE* Stream) {
+        const CpuFeatureSet& Features = RuntimeCpuFeatures();
+        const std::pair<const char*, bool> FeatureList[] = {
+            { "sse2", Features.SSE2 }, { "ssse3", Features.SSSE3 }, { "sse4.1", Features.SSE41 },
+            { "pclmulqdq", Features.PCLMULQDQ }, { "aes", Features.AESNI }, { "avx", Features.AVX },
+            { "avx2", Features.AVX2 }, { "sha", Features.SHA }, { "avx512f", Features.AVX512F },
+            { "avx512bw", Features.AVX512BW }, { "avx512vl", Features.AVX512VL }, { "vaes", Features.VAES },
+            { "vpclmulqdq", Features.VPCLMULQDQ }, { "gfni", Features.GFNI },
+        };
+        char Host[256] = "unknown";
+
+        gethostname(Host, sizeof(Host) - 1);
+
+        fprintf(Stream, "{\n");
+        fprintf(Stream, "  \"schema\": 1,\n");
+        fprintf(Stream, "  \"timestamp\": %lld,\n", static_cast<long long>(time(nullptr)));
+        fprintf(Stream, "  \"host\": {\n");
+        fprintf(Stream, "    \"name\": \"%s\",\n", JsonEscape(Host).c_str());
+#if defined(__VERSION__)
+        fprintf(Stream, "    \"compiler\": \"%s\",\n", JsonEscape(__VERSION__).c_str());
+#endif
+        fprintf(Stream, "    \"cycle_counter\": \"%s\",\n", ACCEL_BENCH_HAS_TSC ? "tsc" : "none");
+        fprintf(Stream, "    \"cycles_per_ns\": %.4f,\n", MeasureCycleRate());
+        fprintf(Stream, "    \"cpu_features\": [");
+        bool First = true;
+        for (const auto& Feature : FeatureList) {
+            if (Feature.second) {
+                fprintf(Stream, "%s\"%s\"", First ? "" : ", ", Feature.first);
+                First = false;
+            }
+        }
+        fprintf(Stream, "]\n");
+        fprintf(Stream, "  },\n");
+        fprintf(Stream, "  \"min_seconds\": %g,\n", g_Options.MinSeconds);
+        fprintf(Stream, "  \"results\": [\n");
+
+        for (size_t i = 0; i < g_Results.size(); ++i) {
+            const Result& Item = g_Results[i];
+
+            fprintf(Stream, "    {\"kind\": \"%s\", \"algorithm\": \"%s\", \"operation\": \"%s\", \"bytes\": %zu, \"ns_per_op\": %.3f",
+                    Item.Kind.c_str(), JsonEscape(Item.Algorithm).c_str(), Item.Operation.c_str(), Item.Bytes, Item.PerOperation.Nanoseconds);
+            if (Item.PerOperation.Cycles >= 0)
+                fprintf(Stream, ", \"cycles_per_op\": %.1f", Item.PerOperation.Cycles);
+            if (Item.Bytes) {
+                fprintf(Stream, ", \"mb_per_s\": %.2f", Item.Bytes / Item.PerOperation.Nanoseconds * 1e3);
+                if (Item.PerOperation.Cycles >= 0)
+                    fprintf(Stream, ", \"cycles_per_byte\": %.3f", Item.PerOperation.Cycles / Item.Bytes);
+            }
+            fprintf(Stream, "}%s\n", i + 1 < g_Results.size() ? "," : "");
+        }
+
+        fprintf(Stream, "  ]\n");
+        fprintf(Stream, "}\n");
+    }
+
+    void PrintUsage(FILE* Stream) {
+        fprintf(Stream,
+                "Usage: accel-bench [-o FILE] [-f SUBSTRING] [-t SECONDS] [-m MAX_BYTES]\n"
+                "\n"
+                "  -o FILE       write the JSON report to FILE instead of standard output\n"
+                "  -f SUBSTRING  only algorithms whose name contains SUBSTRING, e.g. AES or SHA256\n"
+                "  -t SECONDS    time budget per measurement, 0.05 by default\n"
+                "  -m MAX_BYTES  largest message size, 16777216 by default\n"
+                "  -h            show this help\n");
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    int Option;
+
+    while ((Option = getopt(argc, argv, "o:f:t:m:h")) != -1) {
+        switch (Option) {
+            case 'o':
+                g_Options.OutputPath = optarg;
+                break;
+            case 'f':
+                g_Options.Filter = optarg;
+                break;
+            case 't':
+                g_Options.MinSeconds = atof(optarg);
+                if (g_Options.MinSeconds <= 0) {
+                    fprintf(stderr, "accel-bench: -t needs a positive number of seconds\n");
+                    return 2;
+                }
+                break;
+            case 'm':
+                g_Options.MaxBytes = strtoull(optarg, nullptr, 0);
+                break;
+            case 'h':
+                PrintUsage(stdout);
+                return 0;
+            default:
+                PrintUsage(stderr);
+                return 2;
+        }
+    }
+
+    FILE* Output = stdout;
+    if (g_Options.OutputPath) {
+        Output = fopen(g_Options.OutputPath, "w");
+        if (Output == nullptr) {
+            fprintf(stderr, "accel-bench: %s: %s\n", g_Options.OutputPath, strerror(errno));
+            return 1;
+        }
+    }
+
+    RunAll();
+    WriteJson(Output);
+
+    if (Output != stdout)
+        fclose(Output);
+    return 0;
+}
+
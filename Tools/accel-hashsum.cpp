@@ -0,0 +1,236 @@
+//
+//  accel-hashsum: md5sum/sha256sum-compatible file hashing on Hash/file_hasher.hpp.
+//
+//      accel-hashsum [-a ALGORITHM] [FILE]...      print "<hex digest>  <file>" per file
+//      accel-hashsum [-a ALGORITHM] -c [FILE]...   check the digests listed in the files
+//      accel-hashsum -l                            list the algorithms
+//
+//  With no FILE, or when FILE is -, standard input is read. The default algorithm is sha256.
+//
+#include "../Hash/file_hasher.hpp"
+#include "../Hash/haval.hpp"
+#include "../Hash/md2.hpp"
+#include "../Hash/md4.hpp"
+#include "../Hash/md5.hpp"
+#include "../Hash/ripemd.hpp"
+#include "../Hash/sha1.hpp"
+#include "../Hash/sha224.hpp"
+#include "../Hash/sha256.hpp"
+#include "../Hash/sha384.hpp"
+#include "../Hash/sha512.hpp"
+#include "../Hash/sm3.hpp"
+#include "../Hash/tiger.hpp"
+#include "../Hash/whirlpool.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+    struct HashAlgorithm {
+        const char* Name;
+        size_t DigestSize;
+        bool (*HashDescriptor)(int FileDescriptor, void* pbDigest);
+        bool (*HashPath)(const char* Path, void* pbDigest);
+    };
+
+    template<typename __AlgType>
+    constexpr HashAlgorithm MakeHashAlgorithm(const char* Name) noexcept {
+        using Hasher = accel::Hash::FileHasher<__AlgType>;
+        return HashAlgorithm{ Name, Hasher::DigestSizeValue, &Hasher::HashDescriptor, &Hasher::HashPath };
+    }
+
+    const HashAlgorithm Algorithms[] = {
+        MakeHashAlgorithm<accel::Hash::MD2_ALG>("md2"),
+        MakeHashAlgorithm<accel::Hash::MD4_ALG>("md4"),
+        MakeHashAlgorithm<accel::Hash::MD5_ALG>("md5"),
+        MakeHashAlgorithm<accel::Hash::SHA1_ALG>("sha1"),
+        MakeHashAlgorithm<accel::Hash::SHA224_ALG>("sha224"),
+        MakeHashAlgorithm<accel::Hash::SHA256_ALG>("sha256"),
+        MakeHashAlgorithm<accel::Hash::SHA384_ALG>("sha384"),
+        MakeHashAlgorithm<accel::Hash::SHA512_ALG>("sha512"),
+        MakeHashAlgorithm<accel::Hash::SM3_ALG>("sm3"),
+        MakeHashAlgorithm<accel::Hash::RIPEMD_ALG<128>>("ripemd128"),
+        MakeHashAlgorithm<accel::Hash::RIPEMD_ALG<160>>("ripemd160"),
+        MakeHashAlgorithm<accel::Hash::RIPEMD_ALG<256>>("ripemd256"),
+        MakeHashAlgorithm<accel::Hash::RIPEMD_ALG<320>>("ripemd320"),
+        MakeHashAlgorithm<accel::Hash::TIGER_ALG<1, 192>>("tiger"),
+        MakeHashAlgorithm<accel::Hash::TIGER_ALG<2, 192>>("tiger2"),
+        MakeHashAlgorithm<accel::Hash::HAVAL_ALG<256, 5>>("haval256-5"),
+        MakeHashAlgorithm<accel::Hash::WHIRLPOOL_ALG>("whirlpool"),
+    };
+
+    constexpr size_t MaxDigestSize = 64;
+
+    const HashAlgorithm* FindAlgorithm(const char* Name) noexcept {
+        for (const auto& Algorithm : Algorithms) {
+            if (strcmp(Algorithm.Name, Name) == 0)
+                return &Algorithm;
+        }
+        return nullptr;
+    }
+
+    std::string ToHex(const uint8_t* pbBytes, size_t cbBytes) {
+        static const char Digits[] = "0123456789abcdef";
+        std::string Hex(cbBytes * 2, '0');
+
+        for (size_t i = 0; i < cbBytes; ++i) {
+            Hex[2 * i] = Digits[pbBytes[i] >> 4];
+            Hex[2 * i + 1] = Digits[pbBytes[i] & 0x0f];
+        }
+
+        return Hex;
+    }
+
+    bool HashFile(const HashAlgorithm& Algorithm, const char* Path, uint8_t* pbDigest) noexcept {
+        bool Succeeded = strcmp(Path, "-") == 0 ? Algorithm.HashDescriptor(STDIN_FILENO, pbDigest) :
+                                                  Algorithm.HashPath(Path, pbDigest);
+        if (Succeeded == false)
+            fprintf(stderr, "accel-hashsum: %s: %s\n", Path, strerror(errno));
+        return Succeeded;
+    }
+
+    //
+    //  Returns false if any file could not be read.
+    //
+    bool PrintDigests(const HashAlgorithm& Algorithm, const char* const* Paths, size_t PathCount) {
+        uint8_t Digest[MaxDigestSize];
+        bool Succeeded = true;
+
+        for (size_t i = 0; i < PathCount; ++i) {
+            if (HashFile(Algorithm, Paths[i], Digest)) {
+                printf("%s  %s\n", ToHex(Digest, Algorithm.DigestSize).c_str(), Paths[i]);
+            } else {
+                Succeeded = false;
+            }
+        }
+
+        return Succeeded;
+    }
+
+    //
+    //  Lines are "<hex digest>  <file>" or "<hex digest> *<file>", as md5sum and sha256sum print them.
+    //  Returns false if any listed file is missing, unreadable or does not match, or if no line was well-formed.
+    //
+    bool CheckDigests(const HashAlgorithm& Algorithm, std::istream& List, const char* ListName) {
+        const size_t HexLength = Algorithm.DigestSize * 2;
+        uint8_t Digest[MaxDigestSize];
+        size_t Checked = 0, Mismatched = 0, Unreadable = 0, Malformed = 0;
+        std::string Line;
+
+        while (std::getline(List, Line)) {
+            if (Line.size() < HexLength + 3 || Line[HexLength] != ' ' || (Line[HexLength + 1] != ' ' && Line[HexLength + 1] != '*')) {
+                ++Malformed;
+                continue;
+            }
+
+            std::string Expected = Line.substr(0, HexLength);
+            std::string Path = Line.substr(HexLength + 2);
+
+            for (auto& c : Expected)
+                c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+
+            if (Expected.find_first_not_of("0123456789abcdef") != std::string::npos) {
+                ++Malformed;
+                continue;
+            }
+
+            ++Checked;
+            if (HashFile(Algorithm, Path.c_str(), Digest) == false) {
+                printf("%s: FAILED open or read\n", Path.c_str());
+                ++Unreadable;
+            } else if (ToHex(Digest, Algorithm.DigestSize) != Expected) {
+                printf("%s: FAILED\n", Path.c_str());
+                ++Mismatched;
+            } else {
+                printf("%s: OK\n", Path.c_str());
+            }
+        }
+
+        if (Malformed)
+            fprintf(stderr, "accel-hashsum: WARNING: %zu line(s) of %s are improperly formatted\n", Malformed, ListName);
+        if (Unreadable)
+            fprintf(stderr, "accel-hashsum: WARNING: %zu listed file(s) could not be read\n", Unreadable);
+        if (Mismatched)
+            fprintf(stderr, "accel-hashsum: WARNING: %zu computed checksum(s) did NOT match\n", Mismatched);
+        if (Checked == 0)
+            fprintf(stderr, "accel-hashsum: %s: no properly formatted checksum lines found\n", ListName);
+
+        return Checked != 0 && Mismatched == 0 && Unreadable == 0;
+    }
+
+    void PrintUsage(FILE* Stream) {
+        fprintf(Stream,
+                "Usage: accel-hashsum [-a ALGORITHM] [-c] [FILE]...\n"
+                "       accel-hashsum -l\n"
+                "Print or check digests. With no FILE, or when FILE is -, read standard input.\n"
+                "\n"
+                "  -a ALGORITHM  hash algorithm, sha256 by default (see -l)\n"
+                "  -c            read digests from the FILEs and check them\n"
+                "  -l            list the algorithms\n"
+                "  -h            show this help\n");
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const HashAlgorithm* Algorithm = FindAlgorithm("sha256");
+    bool CheckMode = false;
+    int Option;
+
+    while ((Option = getopt(argc, argv, "a:clh")) != -1) {
+        switch (Option) {
+            case 'a':
+                Algorithm = FindAlgorithm(optarg);
+                if (Algorithm == nullptr) {
+                    fprintf(stderr, "accel-hashsum: unknown algorithm '%s' (see -l)\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'c':
+                CheckMode = true;
+                break;
+            case 'l':
+                for (const auto& Item : Algorithms)
+                    printf("%s\n", Item.Name);
+                return 0;
+            case 'h':
+                PrintUsage(stdout);
+                return 0;
+            default:
+                PrintUsage(stderr);
+                return 2;
+        }
+    }
+
+    static const char* const StandardInput[] = { "-" };
+    const char* const* Paths = optind < argc ? argv + optind : StandardInput;
+    size_t PathCount = optind < argc ? static_cast<size_t>(argc - optind) : 1;
+    bool Succeeded = true;
+
+    if (CheckMode) {
+        for (size_t i = 0; i < PathCount; ++i) {
+            if (strcmp(Paths[i], "-") == 0) {
+                Succeeded &= CheckDigests(*Algorithm, std::cin, "standard input");
+            } else {
+                std::ifstream List(Paths[i]);
+                if (!List) {
+                    fprintf(stderr, "accel-hashsum: %s: %s\n", Paths[i], strerror(errno));
+                    Succeeded = false;
+                    continue;
+                }
+                Succeeded &= CheckDigests(*Algorithm, List, Paths[i]);
+            }
+        }
+    } else {
+        Succeeded = PrintDigests(*Algorithm, Paths, PathCount);
+    }
+
+    return Succeeded ? 0 : 1;
+}
+